@@ -0,0 +1,474 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+
+#include "benchmarkTimer.h"
+#include "benchmarkReport.h"
+#include "benchmarkCounter.h"
+#include "benchmarkCase.h"
+#include "benchmarkScaling.h"
+
+
+/// The maximum number of entries of a comma separated option.
+#define BENCHMARK_LIST_CAPACITY 64
+
+
+/// The new type representing the options of the benchmark.
+typedef struct {
+    /// The cases to run, all of them if caseNumber is 0.
+    const BenchmarkCase *caseList[BENCHMARK_LIST_CAPACITY];
+    /// The number of selected cases.
+    size_t caseNumber;
+    /// The sizes to sweep, the powers of 2 between minimumSize and maximumSize with an awkward size after each one if sizeNumber is 0.
+    size_t sizeList[BENCHMARK_LIST_CAPACITY];
+    /// The number of selected sizes.
+    size_t sizeNumber;
+    /// The smallest power of 2 of the sweep.
+    size_t minimumSize;
+    /// The largest size of the sweep.
+    size_t maximumSize;
+    /// The numbers of threads of the parallel mode, the powers of 2 up to the available threads if threadNumber is 0.
+    int threadList[BENCHMARK_LIST_CAPACITY];
+    /// The number of selected numbers of threads.
+    size_t threadNumber;
+    /// Whether the serial mode is measured.
+    short serial;
+    /// Whether the parallel mode is measured.
+    short parallel;
+    /// The number of warm-up runs of each measure.
+    size_t warmupNumber;
+    /// The number of measured runs of each measure.
+    size_t repetitionNumber;
+    /// The format of the report.
+    BenchmarkFormat format;
+    /// Whether the threads are bound to the processors.
+    short pin;
+    /// Whether the hardware events are counted around each measured run.
+    short counters;
+    /// Whether the scaling driver runs instead of the sweep of the cases.
+    short scalingDriver;
+    /// The kind of scaling of the scaling driver.
+    BenchmarkScaling scaling;
+    /// The size of the scaling driver, the total one for the strong scaling and the one of each thread for the weak scaling, 0 for the default.
+    size_t scalingSize;
+} BenchmarkOptions;
+
+
+/**
+ * Function that displays a help message that describes how to use the benchmark.
+ *
+ * @param progName the program name.
+ */
+void print_help(const char *progName) {
+    printf("Usage: %s [options]\n", progName);
+    printf("Options:\n");
+    printf("  -c, --case LIST         Comma separated cases to run (default all, see --list)\n");
+    printf("      --sizes LIST        Comma separated sizes, in elements\n");
+    printf("      --min-size N        Smallest power of 2 of the size sweep (default 1024)\n");
+    printf("      --max-size N        Largest size of the size sweep (default 65536)\n");
+    printf("  -t, --threads LIST      Comma separated numbers of threads of the parallel mode\n");
+    printf("                          (default the powers of 2 up to the available threads)\n");
+    printf("  -p, --parallel          Measure only the parallel mode\n");
+    printf("  -s, --serial            Measure only the serial mode\n");
+    printf("  -w, --warmup N          Warm-up runs of each measure (default 2)\n");
+    printf("  -r, --repetitions N     Measured runs of each measure (default 11)\n");
+    printf("  -f, --format FORMAT     Report format: table, csv or json (default table)\n");
+    printf("  -o, --output FILE       Write the report to FILE instead of the standard output\n");
+    printf("      --kernel NAME       Instruction set of the kernels: scalar, avx2 or avx512\n");
+    printf("      --network NAME      Merging network: bitonic, odd-even or pairwise\n");
+    printf("      --no-pin            Do not bind the threads to the processors\n");
+    printf("      --counters          Count the hardware events of each measure by perf_event_open (Linux):\n");
+    printf("                          instructions per cycle, LLC misses per element, branch misses per run\n");
+    printf("      --scaling KIND      Run the scaling driver of insertionseries and cww instead of the sweep:\n");
+    printf("                          strong (fixed total size) or weak (fixed size per thread);\n");
+    printf("                          the default threads are all the numbers up to the available threads\n");
+    printf("      --scaling-size N    Total size of the strong scaling (default 1048576)\n");
+    printf("                          or size per thread of the weak scaling (default 65536)\n");
+    printf("  -l, --list              List the cases\n");
+    printf("  -h, --help              Show this help message\n");
+}
+
+/**
+ * Function that parses a comma separated list of positive numbers.
+ *
+ * @param text the list.
+ * @param number the buffer of BENCHMARK_LIST_CAPACITY numbers.
+ * @return the count of numbers, 0 if the list is not valid.
+ */
+size_t parse_size_list(const char *text, size_t *number) {
+    /// The count of numbers.
+    size_t count = 0;
+
+    while (*text && count < BENCHMARK_LIST_CAPACITY) {
+        /// The end of the current number.
+        char *end;
+        /// The current number.
+        unsigned long long value = strtoull(text, &end, 10);
+
+        if (end == text || (*end && *end != ',')) {
+            return 0;
+        }
+
+        number[count++] = (size_t) value;
+        text = *end ? end + 1 : end;
+    }
+
+    return count;
+}
+
+/**
+ * Function that selects the cases of a comma separated list of names.
+ *
+ * @param text the list.
+ * @param options the options of the benchmark.
+ * @return 1 if all the names are cases, 0 otherwise.
+ */
+short parse_case_list(const char *text, BenchmarkOptions *options) {
+    while (*text && options->caseNumber < BENCHMARK_LIST_CAPACITY) {
+        /// The length of the current name.
+        size_t length = strcspn(text, ",");
+        /// The current name.
+        char name[128] = {0};
+
+        if (!length || length >= sizeof name) {
+            return 0;
+        }
+
+        memcpy(name, text, length);
+
+        /// The case with the current name.
+        const BenchmarkCase *benchmarkCase = benchmarkCaseFind(name);
+
+        if (!benchmarkCase) {
+            fprintf(stderr, "Unknown case %s\n", name);
+            return 0;
+        }
+
+        options->caseList[options->caseNumber++] = benchmarkCase;
+        text += length + (text[length] == ',');
+    }
+
+    return 1;
+}
+
+/**
+ * Function that selects the instruction set of all the kernels.
+ *
+ * @param name the name of the instruction set.
+ * @return 1 if the name is valid, 0 otherwise.
+ */
+short select_kernel(const char *name) {
+    for (int kernel = BITONIC_KERNEL_SCALAR; kernel <= BITONIC_KERNEL_AVX512; ++kernel) {
+        if (!strcmp(bitonicKernelName((BitonicKernel) kernel), name)) {
+            bitonicKernelSelect((BitonicKernel) kernel);
+            scanKernelSelect((BitonicKernel) kernel);
+            positionNetworkSelect((BitonicKernel) kernel);
+            sampleKernelSelect((BitonicKernel) kernel);
+
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Function that selects the merging network.
+ *
+ * @param name the name of the network.
+ * @return 1 if the name is valid, 0 otherwise.
+ */
+short select_network(const char *name) {
+    for (int network = MERGE_NETWORK_BITONIC; network <= MERGE_NETWORK_PAIRWISE; ++network) {
+        if (!strcmp(mergeNetworkName((MergeNetwork) network), name)) {
+            mergeNetworkSelect((MergeNetwork) network);
+
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    /// The options of the benchmark.
+    BenchmarkOptions options = {
+        .minimumSize = 1024,
+        .maximumSize = 65536,
+        .serial = 1,
+        .parallel = 1,
+        .warmupNumber = 2,
+        .repetitionNumber = 11,
+        .format = BENCHMARK_FORMAT_TABLE,
+        .pin = 1
+    };
+    /// The stream of the report.
+    FILE *output = stdout;
+
+    /// Defines the possible long options.
+    static struct option longOptions[] = {
+        {"case", required_argument, 0, 'c'},
+        {"sizes", required_argument, 0, 0},
+        {"min-size", required_argument, 0, 0},
+        {"max-size", required_argument, 0, 0},
+        {"threads", required_argument, 0, 't'},
+        {"parallel", no_argument, 0, 'p'},
+        {"serial", no_argument, 0, 's'},
+        {"warmup", required_argument, 0, 'w'},
+        {"repetitions", required_argument, 0, 'r'},
+        {"format", required_argument, 0, 'f'},
+        {"output", required_argument, 0, 'o'},
+        {"kernel", required_argument, 0, 0},
+        {"network", required_argument, 0, 0},
+        {"no-pin", no_argument, 0, 0},
+        {"counters", no_argument, 0, 0},
+        {"scaling", required_argument, 0, 0},
+        {"scaling-size", required_argument, 0, 0},
+        {"list", no_argument, 0, 'l'},
+        {"help", no_argument, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+    /// Gets the return value of the getopt function, i.e. the chosen option.
+    int opt;
+    /// Index in the longOptions array indicating which long option has been selected.
+    int option_index = 0;
+    /// The numbers of a comma separated option.
+    size_t number[BENCHMARK_LIST_CAPACITY];
+
+    while ((opt = getopt_long(argc, argv, "c:t:psw:r:f:o:lh", longOptions, &option_index)) != -1) {
+        switch (opt) {
+            case 'c':
+                if (!parse_case_list(optarg, &options)) {
+                    return 1;
+                }
+                break;
+            case 't':
+                options.threadNumber = parse_size_list(optarg, number);
+                for (size_t i = 0; i < options.threadNumber; ++i) {
+                    options.threadList[i] = number[i] ? (int) number[i] : 1;
+                }
+                break;
+            case 'p':
+                options.serial = 0;
+                options.parallel = 1;
+                break;
+            case 's':
+                options.serial = 1;
+                options.parallel = 0;
+                break;
+            case 'w':
+                options.warmupNumber = strtoull(optarg, NULL, 10);
+                break;
+            case 'r':
+                options.repetitionNumber = strtoull(optarg, NULL, 10);
+                break;
+            case 'f':
+                if (!strcmp(optarg, "csv")) {
+                    options.format = BENCHMARK_FORMAT_CSV;
+                }
+                else if (!strcmp(optarg, "json")) {
+                    options.format = BENCHMARK_FORMAT_JSON;
+                }
+                else if (!strcmp(optarg, "table")) {
+                    options.format = BENCHMARK_FORMAT_TABLE;
+                }
+                else {
+                    fprintf(stderr, "Unknown format %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'o':
+                output = fopen(optarg, "w");
+                if (!output) {
+                    perror(optarg);
+                    return 1;
+                }
+                break;
+            case 'l':
+                for (size_t i = 0; i < benchmarkCaseNumber; ++i) {
+                    puts(benchmarkCaseList[i].name);
+                }
+                return 0;
+            case 'h':
+                print_help(argv[0]);
+                return 0;
+            case 0: // only long options
+                if (!strcmp(longOptions[option_index].name, "sizes")) {
+                    options.sizeNumber = parse_size_list(optarg, options.sizeList);
+                }
+                else if (!strcmp(longOptions[option_index].name, "min-size")) {
+                    options.minimumSize = strtoull(optarg, NULL, 10);
+                }
+                else if (!strcmp(longOptions[option_index].name, "max-size")) {
+                    options.maximumSize = strtoull(optarg, NULL, 10);
+                }
+                else if (!strcmp(longOptions[option_index].name, "kernel") && !select_kernel(optarg)) {
+                    fprintf(stderr, "Unknown or unsupported kernel %s\n", optarg);
+                    return 1;
+                }
+                else if (!strcmp(longOptions[option_index].name, "network") && !select_network(optarg)) {
+                    fprintf(stderr, "Unknown network %s\n", optarg);
+                    return 1;
+                }
+                else if (!strcmp(longOptions[option_index].name, "no-pin")) {
+                    options.pin = 0;
+                }
+                else if (!strcmp(longOptions[option_index].name, "counters")) {
+                    options.counters = 1;
+                }
+                else if (!strcmp(longOptions[option_index].name, "scaling")) {
+                    options.scalingDriver = 1;
+
+                    if (!strcmp(optarg, "strong")) {
+                        options.scaling = BENCHMARK_SCALING_STRONG;
+                    }
+                    else if (!strcmp(optarg, "weak")) {
+                        options.scaling = BENCHMARK_SCALING_WEAK;
+                    }
+                    else {
+                        fprintf(stderr, "Unknown scaling %s\n", optarg);
+                        return 1;
+                    }
+                }
+                else if (!strcmp(longOptions[option_index].name, "scaling-size")) {
+                    options.scalingSize = strtoull(optarg, NULL, 10);
+                }
+                break;
+            default:
+                print_help(argv[0]);
+                return 1;
+        }
+    }
+
+    /// Whether the cases are selected by the --case option.
+    short caseSelected = options.caseNumber > 0;
+
+    if (!options.caseNumber) {
+        for (size_t i = 0; i < benchmarkCaseNumber && i < BENCHMARK_LIST_CAPACITY; ++i) {
+            options.caseList[options.caseNumber++] = &benchmarkCaseList[i];
+        }
+    }
+
+    if (!options.sizeNumber) {
+        // each power of 2 is followed by an odd size halfway to the next one, the worst case of the padded networks
+        for (size_t size = options.minimumSize ? options.minimumSize : 1; size <= options.maximumSize && options.sizeNumber + 1 < BENCHMARK_LIST_CAPACITY; size *= 2) {
+            options.sizeList[options.sizeNumber++] = size;
+
+            if (size + size / 2 + 1 <= options.maximumSize) {
+                options.sizeList[options.sizeNumber++] = size + size / 2 + 1;
+            }
+        }
+    }
+
+    if (!options.threadNumber) {
+        /// The number of available threads.
+        int maximumThreadNumber = omp_get_max_threads();
+
+        // the scaling driver measures every number of threads, the sweep only the powers of 2
+        for (int threadNumber = 1; threadNumber < maximumThreadNumber && options.threadNumber + 1 < BENCHMARK_LIST_CAPACITY; threadNumber = options.scalingDriver ? threadNumber + 1 : 2 * threadNumber) {
+            options.threadList[options.threadNumber++] = threadNumber;
+        }
+
+        options.threadList[options.threadNumber++] = maximumThreadNumber;
+    }
+
+    /// How the hardware events are counted, NULL if they are not requested.
+    const char *hardwareCounters = NULL;
+
+    if (options.counters) {
+        /// The largest team of the measures.
+        int maximumThreadNumber = 1;
+
+        for (size_t t = 0; t < options.threadNumber; ++t) {
+            maximumThreadNumber = options.threadList[t] > maximumThreadNumber ? options.threadList[t] : maximumThreadNumber;
+        }
+
+        // the groups of the larger teams of the weak scaling are opened by each measure
+        if (benchmarkCounterOpen(maximumThreadNumber)) {
+            hardwareCounters = "perf_event_open";
+        }
+        else {
+            fprintf(stderr, "The hardware counters are not available: %s\n", benchmarkCounterError());
+            hardwareCounters = "unavailable";
+        }
+    }
+
+    /// The configuration of the build.
+    BenchmarkConfiguration configuration = {
+        bitonicKernelName(bitonicKernelActive()),
+        mergeNetworkName(mergeNetwork->network),
+        options.warmupNumber,
+        options.repetitionNumber,
+        benchmarkThreadBinding(options.pin),
+        hardwareCounters
+    };
+    /// The number of results written.
+    size_t resultIndex = 0;
+
+    if (options.scalingDriver) {
+        if (!options.scalingSize) {
+            options.scalingSize = options.scaling == BENCHMARK_SCALING_WEAK ? 65536 : 1048576;
+        }
+
+        benchmarkReportScalingBegin(output, options.format, &configuration, options.scaling);
+
+        for (size_t e = 0; e < benchmarkScalingEntryNumber; ++e) {
+            /// Whether the entry point is selected.
+            short selected = !caseSelected;
+
+            for (size_t c = 0; c < options.caseNumber && !selected; ++c) {
+                selected = !strcmp(options.caseList[c]->name, benchmarkScalingEntryList[e].caseName);
+            }
+
+            if (selected) {
+                resultIndex = benchmarkScalingRun(output, options.format, &benchmarkScalingEntryList[e], options.scaling, options.scalingSize,
+                                                  options.threadList, options.threadNumber, options.warmupNumber, options.repetitionNumber, options.pin, resultIndex);
+            }
+        }
+
+        benchmarkReportEnd(output, options.format);
+        benchmarkCounterClose();
+
+        if (output != stdout) {
+            fclose(output);
+        }
+
+        return 0;
+    }
+
+    benchmarkReportBegin(output, options.format, &configuration);
+
+    for (size_t c = 0; c < options.caseNumber; ++c) {
+        for (size_t s = 0; s < options.sizeNumber; ++s) {
+            if (options.serial) {
+                if (options.pin) {
+                    benchmarkPinThreads(1);
+                }
+
+                /// The measures of the serial mode.
+                BenchmarkResult result = benchmarkCaseMeasure(options.caseList[c], options.sizeList[s], SERIAL, 1, options.warmupNumber, options.repetitionNumber);
+                benchmarkReportResult(output, options.format, &result, resultIndex++);
+            }
+
+            for (size_t t = 0; options.parallel && t < options.threadNumber; ++t) {
+                if (options.pin) {
+                    benchmarkPinThreads(options.threadList[t]);
+                }
+
+                /// The measures of the parallel mode.
+                BenchmarkResult result = benchmarkCaseMeasure(options.caseList[c], options.sizeList[s], PARALLEL, options.threadList[t], options.warmupNumber, options.repetitionNumber);
+                benchmarkReportResult(output, options.format, &result, resultIndex++);
+            }
+        }
+    }
+
+    benchmarkReportEnd(output, options.format);
+    benchmarkCounterClose();
+
+    if (output != stdout) {
+        fclose(output);
+    }
+
+    return 0;
+}
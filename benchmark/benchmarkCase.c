@@ -0,0 +1,582 @@
+#include "benchmarkCase.h"
+
+
+/**
+ * Function that initializes the state of a benchmark case.
+ *
+ * @param state the state to initialize.
+ * @param size the number of elements produced by the measured function.
+ */
+void benchmarkStateInit(BenchmarkState *state, size_t size) {
+    memset(state, 0, sizeof *state);
+    state->size = size;
+
+    quadruplearray_init(&state->input);
+    quadruplearray_init(&state->work);
+    quadruplearray_init(&state->firstList);
+    quadruplearray_init(&state->secondList);
+    quadruplearray_init(&state->mergedList);
+    intlist_init(&state->list);
+    intlist_init(&state->position);
+    intlist_init(&state->result);
+    pairlist_init(&state->pairList);
+    pairlist_init(&state->firstPairList);
+    pairlist_init(&state->secondPairList);
+    pairlist_init(&state->pairResult);
+}
+
+/**
+ * Function that frees the memory of the state of a benchmark case.
+ *
+ * @param state the state to free.
+ */
+void benchmarkStateFree(BenchmarkState *state) {
+    quadruplearray_free(&state->input);
+    quadruplearray_free(&state->work);
+    quadruplearray_free(&state->firstList);
+    quadruplearray_free(&state->secondList);
+    quadruplearray_free(&state->mergedList);
+    intlist_free(&state->list);
+    intlist_free(&state->position);
+    intlist_free(&state->result);
+    pairlist_free(&state->pairList);
+    pairlist_free(&state->firstPairList);
+    pairlist_free(&state->secondPairList);
+    pairlist_free(&state->pairResult);
+    free(state->array);
+    free(state->pairArray);
+    free(state->keyedArray);
+    free(state->workspace);
+    state->array = NULL;
+    state->pairArray = NULL;
+    state->keyedArray = NULL;
+    state->workspace = NULL;
+}
+
+/**
+ * Function that allocates the scratch memory of a case that takes an arena.
+ *
+ * @param state the state of the case.
+ * @param workspaceSize the size of the scratch memory.
+ */
+static void benchmarkWorkspaceAlloc(BenchmarkState *state, size_t workspaceSize) {
+    state->workspace = aligned_alloc(ARENA_ALIGNMENT, workspaceSize ? workspaceSize : ARENA_ALIGNMENT);
+    assert(state->workspace && "Malloc error!!!");
+    arena_init(&state->arena, state->workspace, workspaceSize);
+}
+
+/**
+ * Function that fills a quadrupleArray with random quadruples.
+ *
+ * @param array the quadrupleArray, already allocated.
+ */
+static void benchmarkRandomQuadruples(QuadrupleArray *array) {
+    for (size_t i = 0; i < array->arraySize; ++i) {
+        array->key[i] = packSortKey(rand() % (int) (2 * array->arraySize + 1), rand() % 2, (int) i);
+
+        if (array->value) {
+            array->value[i] = rand();
+        }
+    }
+}
+
+/**
+ * Function that fills the insertion positions of a list of numberOfZero elements.
+ *
+ * @details The position j is uniform in [0, numberOfZero + j], as the positions of the insertion series.
+ *
+ * @param position the intList of the positions.
+ * @param numberOfZero the size of the list.
+ * @param positionSize the number of positions.
+ */
+static void benchmarkRandomPositions(IntList *position, int numberOfZero, size_t positionSize) {
+    intlist_reserve(position, positionSize);
+
+    for (size_t j = 0; j < positionSize; ++j) {
+        intlist_append(position, rand() % (numberOfZero + (int) j + 1));
+    }
+}
+
+/**
+ * Function that builds the inputs of the bitonicSort case.
+ *
+ * @param state the state of the case.
+ */
+static void benchmarkBitonicSortSetup(BenchmarkState *state) {
+    quadruplearray_alloc(&state->input, state->size, 1);
+    quadruplearray_alloc(&state->work, state->size, 1);
+    benchmarkRandomQuadruples(&state->input);
+}
+
+/**
+ * Function that restores the unsorted quadruples of the bitonicSort case.
+ *
+ * @param state the state of the case.
+ */
+static void benchmarkBitonicSortPrepare(BenchmarkState *state) {
+    memcpy(state->work.key, state->input.key, state->size * sizeof *state->work.key);
+    memcpy(state->work.value, state->input.value, state->size * sizeof *state->work.value);
+}
+
+/**
+ * Function that executes the bitonicSort case.
+ *
+ * @param state the state of the case.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+static void benchmarkBitonicSortRun(BenchmarkState *state, short parallel) {
+    bitonicSort(&state->work, 0, state->size, ASCENDING, parallel);
+}
+
+/**
+ * Function that builds the inputs of the merge case, two sorted halves.
+ *
+ * @param state the state of the case.
+ */
+static void benchmarkMergeSetup(BenchmarkState *state) {
+    quadruplearray_alloc(&state->firstList, state->size / 2, 1);
+    quadruplearray_alloc(&state->secondList, state->size - state->size / 2, 1);
+    benchmarkRandomQuadruples(&state->firstList);
+    benchmarkRandomQuadruples(&state->secondList);
+    bitonicSort(&state->firstList, 0, state->firstList.arraySize, ASCENDING, SERIAL);
+    bitonicSort(&state->secondList, 0, state->secondList.arraySize, ASCENDING, SERIAL);
+}
+
+/**
+ * Function that executes the merge case.
+ *
+ * @param state the state of the case.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+static void benchmarkMergeRun(BenchmarkState *state, short parallel) {
+    state->mergedList = merge(&state->firstList, &state->secondList, parallel);
+}
+
+/**
+ * Function that frees the output of the merge case.
+ *
+ * @param state the state of the case.
+ */
+static void benchmarkMergeFinish(BenchmarkState *state) {
+    quadruplearray_free(&state->mergedList);
+}
+
+/**
+ * Function that builds the input of the prefixSum case.
+ *
+ * @param state the state of the case.
+ */
+static void benchmarkPrefixSumSetup(BenchmarkState *state) {
+    intlist_reserve(&state->list, state->size);
+
+    for (size_t i = 0; i < state->size; ++i) {
+        intlist_append(&state->list, rand() % 2);
+    }
+}
+
+/**
+ * Function that executes the prefixSum case.
+ *
+ * @param state the state of the case.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+static void benchmarkPrefixSumRun(BenchmarkState *state, short parallel) {
+    state->result = prefixSum(&state->list, parallel);
+}
+
+/**
+ * Function that frees the intList returned by the measured function.
+ *
+ * @param state the state of the case.
+ */
+static void benchmarkResultFinish(BenchmarkState *state) {
+    intlist_free(&state->result);
+}
+
+/**
+ * Function that builds the inputs of the insertionseries_sort_merge case, two pairLists sorted by position.
+ *
+ * @param state the state of the case.
+ */
+static void benchmarkSortMergeSetup(BenchmarkState *state) {
+    /// The size of the first pairList.
+    size_t firstListSize = state->size / 2;
+    /// The size of the second pairList.
+    size_t secondListSize = state->size - firstListSize;
+
+    for (size_t i = 0; i < firstListSize; ++i) {
+        pairlist_append(&state->firstPairList, (int) i, rand());
+    }
+
+    // the positions of the second pairList are spread evenly over the first one
+    for (size_t j = 0; j < secondListSize; ++j) {
+        pairlist_append(&state->secondPairList, (int) (j * (firstListSize + 1) / secondListSize), rand());
+    }
+}
+
+/**
+ * Function that executes the insertionseries_sort_merge case.
+ *
+ * @param state the state of the case.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+static void benchmarkSortMergeRun(BenchmarkState *state, short parallel) {
+    state->pairResult = insertionseries_sort_merge(&state->firstPairList, &state->secondPairList, parallel);
+}
+
+/**
+ * Function that frees the output of the insertionseries_sort_merge case.
+ *
+ * @param state the state of the case.
+ */
+static void benchmarkSortMergeFinish(BenchmarkState *state) {
+    pairlist_free(&state->pairResult);
+}
+
+/**
+ * Function that builds the input of the insertionseries_sort_recursive case, the insertions of a list of the same size.
+ *
+ * @param state the state of the case.
+ */
+static void benchmarkSortRecursivePairSetup(BenchmarkState *state) {
+    benchmarkRandomPositions(&state->position, (int) state->size, state->size);
+
+    for (size_t j = 0; j < state->size; ++j) {
+        pairlist_append(&state->pairList, state->position.list[j], rand());
+    }
+
+    state->pairArray = malloc((state->size ? state->size : 1) * sizeof *state->pairArray);
+    assert(state->pairArray && "Malloc error!!!");
+    benchmarkWorkspaceAlloc(state, insertionseries_sort_merge_workspace_size(state->size));
+}
+
+/**
+ * Function that restores the unsorted insertions of the insertionseries_sort_recursive case.
+ *
+ * @param state the state of the case.
+ */
+static void benchmarkSortRecursivePairPrepare(BenchmarkState *state) {
+    memcpy(state->pairArray, state->pairList.list, state->size * sizeof *state->pairArray);
+}
+
+/**
+ * Function that executes the insertionseries_sort_recursive case.
+ *
+ * @param state the state of the case.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+static void benchmarkSortRecursivePairRun(BenchmarkState *state, short parallel) {
+    insertionseries_sort_recursive_into(state->pairArray, state->size, &state->arena, parallel);
+}
+
+/**
+ * Function that builds the input of the cww_sort_recursive case.
+ *
+ * @param state the state of the case.
+ */
+static void benchmarkSortRecursiveSetup(BenchmarkState *state) {
+    benchmarkRandomPositions(&state->position, 0, state->size);
+}
+
+/**
+ * Function that executes the cww_sort_recursive case.
+ *
+ * @param state the state of the case.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+static void benchmarkSortRecursiveRun(BenchmarkState *state, short parallel) {
+    state->result = cww_sort_recursive(&state->position, parallel);
+}
+
+/**
+ * Function that builds the inputs of the cww_sort_mergebits case, the sorted positions of a word with a quarter of 1s.
+ *
+ * @param state the state of the case.
+ */
+static void benchmarkSortMergeBitsSetup(BenchmarkState *state) {
+    state->numberOfZero = (int) (state->size - state->size / 4);
+    intlist_reserve(&state->list, (size_t) state->numberOfZero);
+
+    for (int i = 0; i < state->numberOfZero; ++i) {
+        intlist_append(&state->list, i);
+    }
+
+    // the positions of the 1s are spread evenly over the 0s
+    for (size_t j = 0; j < state->size / 4; ++j) {
+        intlist_append(&state->position, (int) (j * (size_t) (state->numberOfZero + 1) / (state->size / 4)));
+    }
+
+    state->array = malloc((state->size ? state->size : 1) * sizeof *state->array);
+    assert(state->array && "Malloc error!!!");
+    benchmarkWorkspaceAlloc(state, cww_sort_mergebits_workspace_size(state->size));
+}
+
+/**
+ * Function that executes the cww_sort_mergebits case.
+ *
+ * @param state the state of the case.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+static void benchmarkSortMergeBitsRun(BenchmarkState *state, short parallel) {
+    cww_sort_mergebits_into(state->array, state->list.list, state->list.listSize, state->position.list, state->position.listSize, &state->arena, parallel);
+}
+
+/**
+ * Function that builds the inputs of the insertionseries case, half list and half insertions.
+ *
+ * @param state the state of the case.
+ */
+static void benchmarkInsertionSeriesSetup(BenchmarkState *state) {
+    /// The size of the list.
+    size_t listSize = state->size / 2;
+    /// The number of insertions.
+    size_t pairListSize = state->size - listSize;
+
+    intlist_reserve(&state->list, listSize);
+
+    for (size_t i = 0; i < listSize; ++i) {
+        intlist_append(&state->list, rand());
+    }
+
+    benchmarkRandomPositions(&state->position, (int) listSize, pairListSize);
+
+    for (size_t j = 0; j < pairListSize; ++j) {
+        pairlist_append(&state->pairList, state->position.list[j], rand());
+    }
+}
+
+/**
+ * Function that executes the insertionseries case.
+ *
+ * @param state the state of the case.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+static void benchmarkInsertionSeriesRun(BenchmarkState *state, short parallel) {
+    state->result = insertionseries(&state->list, &state->pairList, parallel);
+}
+
+/**
+ * Function that builds the inputs of the cww case, a word with a quarter of 1s.
+ *
+ * @param state the state of the case.
+ */
+static void benchmarkCwwSetup(BenchmarkState *state) {
+    state->numberOfZero = (int) (state->size - state->size / 4);
+    benchmarkRandomPositions(&state->position, state->numberOfZero, state->size / 4);
+}
+
+/**
+ * Function that executes the cww case.
+ *
+ * @param state the state of the case.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+static void benchmarkCwwRun(BenchmarkState *state, short parallel) {
+    state->result = cww(state->numberOfZero, &state->position, parallel);
+}
+
+/**
+ * Function that builds the inputs of the ct_shuffle case.
+ *
+ * @param state the state of the case.
+ */
+static void benchmarkShuffleSetup(BenchmarkState *state) {
+    state->array = malloc((state->size ? state->size : 1) * sizeof *state->array);
+    assert(state->array && "Malloc error!!!");
+
+    for (size_t i = 0; i < state->size; ++i) {
+        state->array[i] = (int) i;
+    }
+
+    for (size_t i = 0; i < CHACHA20_KEY_SIZE; ++i) {
+        state->seed[i] = (unsigned char) rand();
+    }
+}
+
+/**
+ * Function that executes the ct_shuffle case.
+ *
+ * @param state the state of the case.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+static void benchmarkShuffleRun(BenchmarkState *state, short parallel) {
+    ct_shuffle(state->array, state->size, sizeof *state->array, state->seed, NULL, parallel);
+}
+
+/**
+ * Function that builds the inputs of the sort_shuffle case.
+ *
+ * @param state the state of the case.
+ */
+static void benchmarkSortShuffleSetup(BenchmarkState *state) {
+    benchmarkShuffleSetup(state);
+
+    state->keyedArray = malloc((state->size ? state->size : 1) * sizeof *state->keyedArray);
+    assert(state->keyedArray && "Malloc error!!!");
+}
+
+/**
+ * Function that compares two keyed elements for qsort.
+ *
+ * @param first the first keyed element.
+ * @param second the second keyed element.
+ * @return a negative number, zero or a positive number if the key of the first element is less than, equal to or greater than the key of the second one.
+ */
+static int benchmarkCompareKeyedElement(const void *first, const void *second) {
+    /// The key of the first element.
+    uint64_t firstKey = ((const BenchmarkKeyedElement *) first)->key;
+    /// The key of the second element.
+    uint64_t secondKey = ((const BenchmarkKeyedElement *) second)->key;
+
+    return (firstKey > secondKey) - (firstKey < secondKey);
+}
+
+/**
+ * Function that executes the sort_shuffle case, the baseline of ct_shuffle.
+ *
+ * @details Each element is tagged with a random 64-bit key of the ChaCha20 keystream of the seed, then the elements are sorted by key with qsort.
+ * @details The keys come from the same generator as the positions of ct_shuffle, so the two cases differ only by how the permutation is applied.
+ * @warning The baseline is not constant-time: the comparisons and the memory accesses of qsort depend on the keys, and it always runs serially.
+ *
+ * @param state the state of the case.
+ * @param parallel ignored, the baseline is serial.
+ */
+static void benchmarkSortShuffleRun(BenchmarkState *state, short parallel) {
+    (void) parallel;
+
+    /// The keystream of the seed.
+    ChaCha20 chacha;
+    /// The nonce of the keystream.
+    const unsigned char nonce[CHACHA20_NONCE_SIZE] = {0};
+    chacha20_init(&chacha, state->seed, nonce, 0);
+
+    for (size_t i = 0; i < state->size; ++i) {
+        chacha20_generate(&chacha, (unsigned char *) &state->keyedArray[i].key, sizeof state->keyedArray[i].key);
+        state->keyedArray[i].element = state->array[i];
+    }
+
+    qsort(state->keyedArray, state->size, sizeof *state->keyedArray, benchmarkCompareKeyedElement);
+
+    for (size_t i = 0; i < state->size; ++i) {
+        state->array[i] = state->keyedArray[i].element;
+    }
+}
+
+
+const BenchmarkCase benchmarkCaseList[] = {
+    {"bitonicSort", benchmarkBitonicSortSetup, benchmarkBitonicSortPrepare, benchmarkBitonicSortRun, NULL},
+    {"merge", benchmarkMergeSetup, NULL, benchmarkMergeRun, benchmarkMergeFinish},
+    {"prefixSum", benchmarkPrefixSumSetup, NULL, benchmarkPrefixSumRun, benchmarkResultFinish},
+    {"insertionseries_sort_merge", benchmarkSortMergeSetup, NULL, benchmarkSortMergeRun, benchmarkSortMergeFinish},
+    {"insertionseries_sort_recursive", benchmarkSortRecursivePairSetup, benchmarkSortRecursivePairPrepare, benchmarkSortRecursivePairRun, NULL},
+    {"cww_sort_recursive", benchmarkSortRecursiveSetup, NULL, benchmarkSortRecursiveRun, benchmarkResultFinish},
+    {"cww_sort_mergebits", benchmarkSortMergeBitsSetup, NULL, benchmarkSortMergeBitsRun, NULL},
+    {"insertionseries", benchmarkInsertionSeriesSetup, NULL, benchmarkInsertionSeriesRun, benchmarkResultFinish},
+    {"cww", benchmarkCwwSetup, NULL, benchmarkCwwRun, benchmarkResultFinish},
+    {"ct_shuffle", benchmarkShuffleSetup, NULL, benchmarkShuffleRun, NULL},
+    {"sort_shuffle", benchmarkSortShuffleSetup, NULL, benchmarkSortShuffleRun, NULL}
+};
+
+const size_t benchmarkCaseNumber = sizeof benchmarkCaseList / sizeof *benchmarkCaseList;
+
+
+/**
+ * Function that looks for a benchmark case by name.
+ *
+ * @param name the name of the case.
+ * @return the case, NULL if there is no case with that name.
+ */
+const BenchmarkCase *benchmarkCaseFind(const char *name) {
+    for (size_t i = 0; i < benchmarkCaseNumber; ++i) {
+        if (!strcmp(benchmarkCaseList[i].name, name)) {
+            return &benchmarkCaseList[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Function that measures a benchmark case.
+ *
+ * @details The inputs are built once, then each run restores them, executes the measured function and frees its outputs: only the execution is timed.
+ * @details The first warmupNumber runs are not measured, they fill the caches and let the allocator and the thread pool reach their steady state.
+ * @details If the hardware events are requested, see benchmarkCounterOpen, they are counted around each measured run, on all the threads of the team.
+ *
+ * @param benchmarkCase the case.
+ * @param size the number of elements produced by the measured function.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ * @param threadNumber the number of threads of the parallel regions.
+ * @param warmupNumber the number of runs that are not measured.
+ * @param repetitionNumber the number of measured runs.
+ * @return the measures.
+ */
+BenchmarkResult benchmarkCaseMeasure(const BenchmarkCase *benchmarkCase, size_t size, short parallel, int threadNumber, size_t warmupNumber, size_t repetitionNumber) {
+    /// The measures.
+    BenchmarkResult result = {benchmarkCase->name, size, parallel, threadNumber, repetitionNumber, {0, 0}, {0, 0}, benchmarkCounterEnabled(), {NAN, NAN, NAN}};
+    /// The number of elements of the per element measures.
+    double elementNumber = size ? (double) size : 1;
+    /// The wall time of each run, in nanoseconds per element.
+    double *nsSample = malloc((repetitionNumber ? repetitionNumber : 1) * sizeof *nsSample);
+    assert(nsSample && "Malloc error!!!");
+    /// The cycles of each run, per element.
+    double *cyclesSample = malloc((repetitionNumber ? repetitionNumber : 1) * sizeof *cyclesSample);
+    assert(cyclesSample && "Malloc error!!!");
+    /// The sum of the hardware events of the measured runs.
+    BenchmarkCounters counters = {{0}};
+    /// Whether the hardware events are counted.
+    short counting = benchmarkCounterEnabled() && benchmarkCounterOpen(threadNumber);
+    /// The inputs and outputs of the case.
+    BenchmarkState state;
+
+    omp_set_num_threads(threadNumber);
+    srand(1);
+    benchmarkStateInit(&state, size);
+    benchmarkCase->setup(&state);
+
+    for (size_t run = 0; run < warmupNumber + repetitionNumber; ++run) {
+        if (benchmarkCase->prepare) {
+            benchmarkCase->prepare(&state);
+        }
+
+        // the groups are enabled outside of the timed region, so the timings do not include the system calls
+        if (counting && run >= warmupNumber) {
+            benchmarkCounterStart();
+        }
+
+        /// The wall time at the start of the run.
+        double startTime = benchmarkWallTime();
+        /// The cycles at the start of the run.
+        uint64_t startCycles = benchmarkCycles();
+
+        benchmarkCase->run(&state, parallel);
+
+        /// The cycles at the end of the run.
+        uint64_t endCycles = benchmarkCycles();
+        /// The wall time at the end of the run.
+        double endTime = benchmarkWallTime();
+
+        if (counting && run >= warmupNumber) {
+            benchmarkCounterStop(&counters);
+        }
+
+        if (benchmarkCase->finish) {
+            benchmarkCase->finish(&state);
+        }
+
+        if (run >= warmupNumber) {
+            nsSample[run - warmupNumber] = (endTime - startTime) * 1e9 / elementNumber;
+            cyclesSample[run - warmupNumber] = (double) (endCycles - startCycles) / elementNumber;
+        }
+    }
+
+    result.nsPerElement = benchmarkStatistic(nsSample, repetitionNumber);
+    result.cyclesPerElement = benchmarkStatistic(cyclesSample, repetitionNumber);
+    result.counters = benchmarkCounterMetrics(&counters, repetitionNumber, size);
+
+    benchmarkStateFree(&state);
+    free(nsSample);
+    free(cyclesSample);
+
+    return result;
+}
@@ -0,0 +1,98 @@
+#ifndef DJB_BENCHMARKCASE_H
+#define DJB_BENCHMARKCASE_H
+
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../utility/bitonicSort.h"
+#include "../insertion_series/insertionSeries.h"
+#include "../constant-weight_words/constantWeightWord.h"
+#include "../shuffle/shuffle.h"
+#include "benchmarkTimer.h"
+#include "benchmarkReport.h"
+
+
+/// The new type representing an element of the shuffle baseline, tagged with its random key.
+typedef struct {
+    /// The random key the elements are sorted by.
+    uint64_t key;
+    /// The element.
+    int element;
+} BenchmarkKeyedElement;
+
+/// The new type representing the inputs and the outputs of a benchmark case.
+/// @details Each case uses only some of the fields, the others stay empty.
+typedef struct {
+    /// The number of elements produced by the measured function.
+    size_t size;
+    /// The unsorted quadruples.
+    QuadrupleArray input;
+    /// The quadruples sorted in place by the measured function.
+    QuadrupleArray work;
+    /// The first sorted list of quadruples.
+    QuadrupleArray firstList;
+    /// The second sorted list of quadruples.
+    QuadrupleArray secondList;
+    /// The quadruples returned by the measured function.
+    QuadrupleArray mergedList;
+    /// The input list of integers.
+    IntList list;
+    /// The insertion positions.
+    IntList position;
+    /// The list of integers returned by the measured function.
+    IntList result;
+    /// The pairs inserted in the input list.
+    PairList pairList;
+    /// The first sorted pairList.
+    PairList firstPairList;
+    /// The second sorted pairList.
+    PairList secondPairList;
+    /// The pairList returned by the measured function.
+    PairList pairResult;
+    /// The pairs sorted in place by the measured function.
+    Pair *pairArray;
+    /// The number of 0s of the constant-weight word.
+    int numberOfZero;
+    /// The array shuffled in place by the measured function.
+    int *array;
+    /// The elements tagged with their random keys, used by the shuffle baseline.
+    BenchmarkKeyedElement *keyedArray;
+    /// The seed of the shuffle.
+    unsigned char seed[CHACHA20_KEY_SIZE];
+    /// The scratch memory of the cases that take an arena.
+    void *workspace;
+    /// The arena over the scratch memory.
+    Arena arena;
+} BenchmarkState;
+
+/// The new type representing a benchmark case, i.e. a function measured over inputs of a given size.
+typedef struct {
+    /// The name of the case.
+    const char *name;
+    /// Function that builds the inputs of state->size elements, not measured.
+    void (*setup)(BenchmarkState *state);
+    /// Function that restores the inputs before each run, not measured, or NULL.
+    void (*prepare)(BenchmarkState *state);
+    /// Function that executes the measured function.
+    void (*run)(BenchmarkState *state, short parallel);
+    /// Function that frees the outputs after each run, not measured, or NULL.
+    void (*finish)(BenchmarkState *state);
+} BenchmarkCase;
+
+
+/// The benchmark cases, kernels first and end-to-end entry points after.
+extern const BenchmarkCase benchmarkCaseList[];
+/// The number of benchmark cases.
+extern const size_t benchmarkCaseNumber;
+
+
+void benchmarkStateInit(BenchmarkState *state, size_t size);
+void benchmarkStateFree(BenchmarkState *state);
+const BenchmarkCase *benchmarkCaseFind(const char *name);
+BenchmarkResult benchmarkCaseMeasure(const BenchmarkCase *benchmarkCase, size_t size, short parallel, int threadNumber, size_t warmupNumber, size_t repetitionNumber);
+
+
+#endif //DJB_BENCHMARKCASE_H
@@ -0,0 +1,255 @@
+// syscall is a GNU extension
+#define _GNU_SOURCE
+
+#include "benchmarkCounter.h"
+
+
+/// The file descriptors of the events of each thread, the leader of the group first.
+static int benchmarkCounterGroup[BENCHMARK_COUNTER_THREADS][BENCHMARK_COUNTER_NUMBER];
+/// The enabled and running times of the group of each thread at the last stop, in nanoseconds.
+static uint64_t benchmarkCounterTime[BENCHMARK_COUNTER_THREADS][2];
+/// The number of threads whose groups are open.
+static int benchmarkCounterThreadNumber = 0;
+/// Whether the events are requested.
+static short benchmarkCounterRequested = 0;
+/// The error of the group that could not be opened, 0 if all of them are open.
+static int benchmarkCounterErrno = 0;
+
+
+#ifdef __linux__
+/**
+ * Function that opens the group of the events of the calling thread.
+ *
+ * @details The group starts disabled and counts the user space of the calling thread only, so a paranoid level up to 2 allows it without privileges.
+ * @details The misses of the last level cache are the generic cache misses of the kernel, which are the last level ones on the common processors.
+ *
+ * @param group the buffer of the BENCHMARK_COUNTER_NUMBER file descriptors, -1 for the events that are not open.
+ * @return 0 if the whole group is open, the error of perf_event_open otherwise.
+ */
+static int benchmarkCounterOpenGroup(int *group) {
+    /// The generic hardware event of each counter.
+    static const uint64_t eventConfig[BENCHMARK_COUNTER_NUMBER] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+    for (int event = 0; event < BENCHMARK_COUNTER_NUMBER; ++event) {
+        group[event] = -1;
+    }
+
+    for (int event = 0; event < BENCHMARK_COUNTER_NUMBER; ++event) {
+        /// The attributes of the event.
+        struct perf_event_attr attribute;
+        memset(&attribute, 0, sizeof attribute);
+        attribute.size = sizeof attribute;
+        attribute.type = PERF_TYPE_HARDWARE;
+        attribute.config = eventConfig[event];
+        // the leader enables and disables the whole group
+        attribute.disabled = event == 0;
+        attribute.exclude_kernel = 1;
+        attribute.exclude_hv = 1;
+        attribute.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        group[event] = (int) syscall(SYS_perf_event_open, &attribute, 0, -1, event ? group[0] : -1, PERF_FLAG_FD_CLOEXEC);
+
+        if (group[event] < 0) {
+            return errno ? errno : EINVAL;
+        }
+    }
+
+    return 0;
+}
+#endif
+
+/**
+ * Function that opens the groups of the hardware events of the threads of the teams of threadNumber threads.
+ *
+ * @details Each thread of the pool of the OpenMP runtime opens its own group, which counts only that thread: the runtime keeps the threads alive between the parallel regions, so the teams of the measured functions reuse them.
+ * @details The groups already open are kept, so the function can be called before each measure with its number of threads.
+ * @details If a group cannot be opened, because the kernel or the virtual machine does not expose the events, all of them are closed and the counts are not available, see benchmarkCounterError.
+ * @warning The threads of nested parallel regions and of the teams larger than threadNumber are not counted, nor are the threads beyond BENCHMARK_COUNTER_THREADS.
+ *
+ * @param threadNumber the number of threads of the team.
+ * @return 1 if the events of the threads are counted, 0 otherwise.
+ */
+short benchmarkCounterOpen(int threadNumber) {
+    benchmarkCounterRequested = 1;
+
+#ifdef __linux__
+    if (threadNumber > BENCHMARK_COUNTER_THREADS) {
+        threadNumber = BENCHMARK_COUNTER_THREADS;
+    }
+
+    if (benchmarkCounterErrno || threadNumber <= benchmarkCounterThreadNumber) {
+        return benchmarkCounterAvailable();
+    }
+
+    /// The number of threads of the team that opened the groups.
+    int openedNumber = benchmarkCounterThreadNumber;
+
+#pragma omp parallel num_threads(threadNumber)
+    {
+        /// Thread ID.
+        int threadID = omp_get_thread_num();
+
+        if (threadID >= benchmarkCounterThreadNumber) {
+            /// The error of the group of the thread.
+            int error = benchmarkCounterOpenGroup(benchmarkCounterGroup[threadID]);
+
+            benchmarkCounterTime[threadID][0] = 0;
+            benchmarkCounterTime[threadID][1] = 0;
+
+            if (error) {
+#pragma omp critical(benchmarkCounter)
+                benchmarkCounterErrno = error;
+            }
+        }
+
+        if (threadID == 0) {
+            openedNumber = omp_get_num_threads();
+        }
+    }
+
+    benchmarkCounterThreadNumber = openedNumber > benchmarkCounterThreadNumber ? openedNumber : benchmarkCounterThreadNumber;
+
+    if (benchmarkCounterErrno) {
+        benchmarkCounterClose();
+    }
+#else
+    (void) threadNumber;
+
+    benchmarkCounterErrno = ENOSYS;
+#endif
+
+    return benchmarkCounterAvailable();
+}
+
+/**
+ * Function that tells whether the hardware events are requested, i.e. whether benchmarkCounterOpen was called.
+ *
+ * @return 1 if the events are requested, 0 otherwise.
+ */
+short benchmarkCounterEnabled(void) {
+    return benchmarkCounterRequested;
+}
+
+/**
+ * Function that tells whether the hardware events are counted.
+ *
+ * @return 1 if the groups are open, 0 otherwise.
+ */
+short benchmarkCounterAvailable(void) {
+    return benchmarkCounterRequested && !benchmarkCounterErrno && benchmarkCounterThreadNumber > 0;
+}
+
+/**
+ * Function that describes why the hardware events are not counted.
+ *
+ * @return the description of the error of perf_event_open, NULL if the events are counted or not requested.
+ */
+const char *benchmarkCounterError(void) {
+    return benchmarkCounterErrno ? strerror(benchmarkCounterErrno) : NULL;
+}
+
+/**
+ * Function that resets and enables the groups of all the threads.
+ *
+ * @details Nothing is done if the events are not counted.
+ */
+void benchmarkCounterStart(void) {
+#ifdef __linux__
+    for (int thread = 0; thread < benchmarkCounterThreadNumber; ++thread) {
+        ioctl(benchmarkCounterGroup[thread][0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(benchmarkCounterGroup[thread][0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+}
+
+/**
+ * Function that disables the groups of all the threads and adds their counts to a sum.
+ *
+ * @details All the groups are disabled before the first one is read, so the reads are not counted.
+ * @details When the kernel multiplexes the group with other events, the counts are scaled by the time the group was enabled over the time it was counting, since the last stop.
+ *
+ * @param counters the sum of the counts.
+ */
+void benchmarkCounterStop(BenchmarkCounters *counters) {
+#ifdef __linux__
+    for (int thread = 0; thread < benchmarkCounterThreadNumber; ++thread) {
+        ioctl(benchmarkCounterGroup[thread][0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    for (int thread = 0; thread < benchmarkCounterThreadNumber; ++thread) {
+        /// The number of events, the enabled and running times, then the count of each event.
+        uint64_t value[3 + BENCHMARK_COUNTER_NUMBER];
+
+        if (read(benchmarkCounterGroup[thread][0], value, sizeof value) != (ssize_t) sizeof value) {
+            continue;
+        }
+
+        /// The time the group was enabled since the last stop.
+        uint64_t enabledTime = value[1] - benchmarkCounterTime[thread][0];
+        /// The time the group was counting since the last stop.
+        uint64_t runningTime = value[2] - benchmarkCounterTime[thread][1];
+        /// The scale of the counts of a multiplexed group.
+        double scale = runningTime && runningTime < enabledTime ? (double) enabledTime / (double) runningTime : 1;
+
+        benchmarkCounterTime[thread][0] = value[1];
+        benchmarkCounterTime[thread][1] = value[2];
+
+        for (int event = 0; event < BENCHMARK_COUNTER_NUMBER; ++event) {
+            counters->count[event] += (uint64_t) ((double) value[3 + event] * scale);
+        }
+    }
+#else
+    (void) counters;
+#endif
+}
+
+/**
+ * Function that closes the groups of all the threads.
+ *
+ * @details The events stay requested, so the reports keep the columns of the counts, which are then not available.
+ */
+void benchmarkCounterClose(void) {
+#ifdef __linux__
+    for (int thread = 0; thread < benchmarkCounterThreadNumber; ++thread) {
+        for (int event = 0; event < BENCHMARK_COUNTER_NUMBER; ++event) {
+            if (benchmarkCounterGroup[thread][event] >= 0) {
+                close(benchmarkCounterGroup[thread][event]);
+                benchmarkCounterGroup[thread][event] = -1;
+            }
+        }
+    }
+#endif
+
+    benchmarkCounterThreadNumber = 0;
+}
+
+/**
+ * Function that derives the metrics of the counts of the measured runs.
+ *
+ * @param counters the sum of the counts of the runs.
+ * @param runNumber the number of runs.
+ * @param elementNumber the number of elements produced by each run.
+ * @return the metrics, NAN if the events are not counted.
+ */
+BenchmarkCounterMetrics benchmarkCounterMetrics(const BenchmarkCounters *counters, size_t runNumber, size_t elementNumber) {
+    /// The metrics.
+    BenchmarkCounterMetrics metrics = {NAN, NAN, NAN};
+
+    if (!benchmarkCounterAvailable() || !runNumber) {
+        return metrics;
+    }
+
+    if (counters->count[BENCHMARK_COUNTER_CYCLES]) {
+        metrics.ipc = (double) counters->count[BENCHMARK_COUNTER_INSTRUCTIONS] / (double) counters->count[BENCHMARK_COUNTER_CYCLES];
+    }
+
+    metrics.llcMissesPerElement = (double) counters->count[BENCHMARK_COUNTER_LLC_MISSES] / ((double) runNumber * (double) (elementNumber ? elementNumber : 1));
+    metrics.branchMissesPerRun = (double) counters->count[BENCHMARK_COUNTER_BRANCH_MISSES] / (double) runNumber;
+
+    return metrics;
+}
@@ -0,0 +1,65 @@
+#ifndef DJB_BENCHMARKCOUNTER_H
+#define DJB_BENCHMARKCOUNTER_H
+
+
+#include <omp.h>
+#include <math.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+
+/// The maximum number of threads whose events are counted.
+#define BENCHMARK_COUNTER_THREADS 256
+
+
+/// The hardware events counted by a group, the first one is the leader.
+typedef enum {
+    /// The cycles of the core, at its current frequency.
+    BENCHMARK_COUNTER_CYCLES,
+    /// The retired instructions.
+    BENCHMARK_COUNTER_INSTRUCTIONS,
+    /// The misses of the last level cache.
+    BENCHMARK_COUNTER_LLC_MISSES,
+    /// The mispredicted branches.
+    BENCHMARK_COUNTER_BRANCH_MISSES,
+    /// The number of events.
+    BENCHMARK_COUNTER_NUMBER
+} BenchmarkCounterEvent;
+
+/// The new type representing the counts of the events, summed over the threads.
+typedef struct {
+    /// The count of each event.
+    uint64_t count[BENCHMARK_COUNTER_NUMBER];
+} BenchmarkCounters;
+
+/// The new type representing the metrics derived from the counts of the measured runs.
+typedef struct {
+    /// The instructions per cycle, NAN if the events are not counted.
+    double ipc;
+    /// The misses of the last level cache per element, NAN if the events are not counted.
+    double llcMissesPerElement;
+    /// The mispredicted branches per run, NAN if the events are not counted.
+    double branchMissesPerRun;
+} BenchmarkCounterMetrics;
+
+
+short benchmarkCounterOpen(int threadNumber);
+short benchmarkCounterEnabled(void);
+short benchmarkCounterAvailable(void);
+const char *benchmarkCounterError(void);
+void benchmarkCounterStart(void);
+void benchmarkCounterStop(BenchmarkCounters *counters);
+void benchmarkCounterClose(void);
+BenchmarkCounterMetrics benchmarkCounterMetrics(const BenchmarkCounters *counters, size_t runNumber, size_t elementNumber);
+
+
+#endif //DJB_BENCHMARKCOUNTER_H
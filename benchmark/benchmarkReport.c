@@ -0,0 +1,276 @@
+#include "benchmarkReport.h"
+
+
+/**
+ * Function that writes a number that may not be defined.
+ *
+ * @param text the buffer of the text.
+ * @param textSize the size of the buffer.
+ * @param number the number, NAN if it is not defined.
+ * @param precision the digits after the decimal point.
+ * @param undefinedText the text of an undefined number.
+ */
+static void benchmarkFormatNumber(char *text, size_t textSize, double number, int precision, const char *undefinedText) {
+    if (isnan(number)) {
+        snprintf(text, textSize, "%s", undefinedText);
+    }
+    else {
+        snprintf(text, textSize, "%.*f", precision, number);
+    }
+}
+
+/**
+ * Function that writes the names of the metrics of the hardware events, after the ones of the timings.
+ *
+ * @param output the stream of the report.
+ * @param format the format of the report, the JSON one has no header.
+ */
+static void benchmarkReportCounterHeader(FILE *output, BenchmarkFormat format) {
+    switch (format) {
+        case BENCHMARK_FORMAT_CSV:
+            fprintf(output, ",ipc,llc_misses_per_element,branch_misses_per_run");
+            break;
+        case BENCHMARK_FORMAT_JSON:
+            break;
+        default:
+            fprintf(output, " %8s %12s %14s", "ipc", "llc miss/el", "br miss/run");
+    }
+}
+
+/**
+ * Function that writes the metrics of the hardware events, after the timings.
+ *
+ * @details The metrics that are not available are left empty in CSV, null in JSON and a dash in the table.
+ *
+ * @param output the stream of the report.
+ * @param format the format of the report.
+ * @param counters the metrics.
+ */
+static void benchmarkReportCounters(FILE *output, BenchmarkFormat format, const BenchmarkCounterMetrics *counters) {
+    /// The instructions per cycle, as text.
+    char ipc[32];
+    /// The misses of the last level cache per element, as text.
+    char llcMisses[32];
+    /// The mispredicted branches per run, as text.
+    char branchMisses[32];
+    /// The text of the metrics that are not available.
+    const char *undefinedText = format == BENCHMARK_FORMAT_CSV ? "" : format == BENCHMARK_FORMAT_JSON ? "null" : "-";
+
+    benchmarkFormatNumber(ipc, sizeof ipc, counters->ipc, 3, undefinedText);
+    benchmarkFormatNumber(llcMisses, sizeof llcMisses, counters->llcMissesPerElement, 4, undefinedText);
+    benchmarkFormatNumber(branchMisses, sizeof branchMisses, counters->branchMissesPerRun, 1, undefinedText);
+
+    switch (format) {
+        case BENCHMARK_FORMAT_CSV:
+            fprintf(output, ",%s,%s,%s", ipc, llcMisses, branchMisses);
+            break;
+        case BENCHMARK_FORMAT_JSON:
+            fprintf(output, ", \"ipc\": %s, \"llc_misses_per_element\": %s, \"branch_misses_per_run\": %s", ipc, llcMisses, branchMisses);
+            break;
+        default:
+            fprintf(output, " %8s %12s %14s", ipc, llcMisses, branchMisses);
+    }
+}
+
+/**
+ * Function that writes the configuration of the build, after the kind of scaling if any.
+ *
+ * @param output the stream of the report.
+ * @param format the format of the report, the CSV one has no configuration.
+ * @param configuration the configuration of the build.
+ */
+static void benchmarkReportConfiguration(FILE *output, BenchmarkFormat format, const BenchmarkConfiguration *configuration) {
+    switch (format) {
+        case BENCHMARK_FORMAT_CSV:
+            break;
+        case BENCHMARK_FORMAT_JSON:
+            fprintf(output, "  \"bitonic_kernel\": \"%s\",\n  \"merge_network\": \"%s\",\n  \"warmup\": %zu,\n  \"repetitions\": %zu,\n  \"thread_binding\": \"%s\",\n",
+                    configuration->bitonicKernel, configuration->mergeNetwork, configuration->warmupNumber, configuration->repetitionNumber, configuration->threadBinding);
+
+            if (configuration->hardwareCounters) {
+                fprintf(output, "  \"hardware_counters\": \"%s\",\n", configuration->hardwareCounters);
+            }
+
+            fprintf(output, "  \"results\": [");
+            break;
+        default:
+            fprintf(output, "kernel %s, network %s, %zu warm-up and %zu measured runs, threads bound by %s",
+                    configuration->bitonicKernel, configuration->mergeNetwork, configuration->warmupNumber, configuration->repetitionNumber, configuration->threadBinding);
+
+            if (configuration->hardwareCounters) {
+                fprintf(output, ", hardware counters %s", configuration->hardwareCounters);
+            }
+
+            fprintf(output, "\n");
+    }
+}
+
+
+/**
+ * Function that writes the start of the benchmark report.
+ *
+ * @param output the stream of the report.
+ * @param format the format of the report.
+ * @param configuration the configuration of the build.
+ */
+void benchmarkReportBegin(FILE *output, BenchmarkFormat format, const BenchmarkConfiguration *configuration) {
+    switch (format) {
+        case BENCHMARK_FORMAT_CSV:
+            fprintf(output, "case,size,mode,threads,repetitions,ns_per_element_median,ns_per_element_p99,cycles_per_element_median,cycles_per_element_p99");
+            break;
+        case BENCHMARK_FORMAT_JSON:
+            fprintf(output, "{\n");
+            benchmarkReportConfiguration(output, format, configuration);
+            break;
+        default:
+            fprintf(output, "# ");
+            benchmarkReportConfiguration(output, format, configuration);
+            fprintf(output, "%-32s %10s %-8s %7s %12s %12s %12s %12s", "case", "size", "mode", "threads", "ns/el med", "ns/el p99", "cyc/el med", "cyc/el p99");
+    }
+
+    if (configuration->hardwareCounters) {
+        benchmarkReportCounterHeader(output, format);
+    }
+
+    if (format != BENCHMARK_FORMAT_JSON) {
+        fprintf(output, "\n");
+    }
+
+    fflush(output);
+}
+
+/**
+ * Function that writes the measures of a benchmark case.
+ *
+ * @param output the stream of the report.
+ * @param format the format of the report.
+ * @param result the measures.
+ * @param resultIndex the number of results written before this one.
+ */
+void benchmarkReportResult(FILE *output, BenchmarkFormat format, const BenchmarkResult *result, size_t resultIndex) {
+    /// The name of the mode.
+    const char *mode = result->parallel ? "parallel" : "serial";
+
+    switch (format) {
+        case BENCHMARK_FORMAT_CSV:
+            fprintf(output, "%s,%zu,%s,%d,%zu,%.4f,%.4f,%.4f,%.4f",
+                    result->caseName, result->size, mode, result->threadNumber, result->repetitionNumber,
+                    result->nsPerElement.median, result->nsPerElement.p99, result->cyclesPerElement.median, result->cyclesPerElement.p99);
+            break;
+        case BENCHMARK_FORMAT_JSON:
+            fprintf(output, "%s\n    {\"case\": \"%s\", \"size\": %zu, \"mode\": \"%s\", \"threads\": %d, \"repetitions\": %zu, "
+                            "\"ns_per_element\": {\"median\": %.4f, \"p99\": %.4f}, \"cycles_per_element\": {\"median\": %.4f, \"p99\": %.4f}",
+                    resultIndex ? "," : "", result->caseName, result->size, mode, result->threadNumber, result->repetitionNumber,
+                    result->nsPerElement.median, result->nsPerElement.p99, result->cyclesPerElement.median, result->cyclesPerElement.p99);
+            break;
+        default:
+            fprintf(output, "%-32s %10zu %-8s %7d %12.3f %12.3f %12.3f %12.3f",
+                    result->caseName, result->size, mode, result->threadNumber,
+                    result->nsPerElement.median, result->nsPerElement.p99, result->cyclesPerElement.median, result->cyclesPerElement.p99);
+    }
+
+    if (result->counted) {
+        benchmarkReportCounters(output, format, &result->counters);
+    }
+
+    fprintf(output, format == BENCHMARK_FORMAT_JSON ? "}" : "\n");
+
+    fflush(output);
+}
+
+/**
+ * Function that writes the end of the benchmark report.
+ *
+ * @param output the stream of the report.
+ * @param format the format of the report.
+ */
+void benchmarkReportEnd(FILE *output, BenchmarkFormat format) {
+    if (format == BENCHMARK_FORMAT_JSON) {
+        fprintf(output, "\n  ]\n}\n");
+    }
+
+    fflush(output);
+}
+
+/**
+ * Function that writes the start of the scaling report.
+ *
+ * @param output the stream of the report.
+ * @param format the format of the report.
+ * @param configuration the configuration of the build.
+ * @param scaling the kind of scaling.
+ */
+void benchmarkReportScalingBegin(FILE *output, BenchmarkFormat format, const BenchmarkConfiguration *configuration, BenchmarkScaling scaling) {
+    /// The name of the kind of scaling.
+    const char *scalingName = scaling == BENCHMARK_SCALING_WEAK ? "weak" : "strong";
+
+    switch (format) {
+        case BENCHMARK_FORMAT_CSV:
+            fprintf(output, "scaling,entry,phase,size,threads,serial_ms,parallel_ms,speedup,efficiency,serial_fraction");
+            break;
+        case BENCHMARK_FORMAT_JSON:
+            fprintf(output, "{\n  \"scaling\": \"%s\",\n", scalingName);
+            benchmarkReportConfiguration(output, format, configuration);
+            break;
+        default:
+            fprintf(output, "# %s scaling, ", scalingName);
+            benchmarkReportConfiguration(output, format, configuration);
+            fprintf(output, "%-16s %-32s %10s %7s %12s %12s %8s %10s %8s", "entry", "phase", "size", "threads", "serial ms", "parallel ms", "speedup", "efficiency", "serial");
+    }
+
+    if (configuration->hardwareCounters) {
+        benchmarkReportCounterHeader(output, format);
+    }
+
+    if (format != BENCHMARK_FORMAT_JSON) {
+        fprintf(output, "\n");
+    }
+
+    fflush(output);
+}
+
+/**
+ * Function that writes the scaling of a phase.
+ *
+ * @details The serial fraction is not defined with a single thread: it is left empty in CSV, null in JSON and a dash in the table.
+ *
+ * @param output the stream of the report.
+ * @param format the format of the report.
+ * @param result the scaling of the phase.
+ * @param resultIndex the number of results written before this one.
+ */
+void benchmarkReportScalingResult(FILE *output, BenchmarkFormat format, const BenchmarkScalingResult *result, size_t resultIndex) {
+    /// The name of the kind of scaling.
+    const char *scalingName = result->scaling == BENCHMARK_SCALING_WEAK ? "weak" : "strong";
+    /// The serial fraction, as text.
+    char serialFraction[32];
+
+    switch (format) {
+        case BENCHMARK_FORMAT_CSV:
+            benchmarkFormatNumber(serialFraction, sizeof serialFraction, result->serialFraction, 4, "");
+            fprintf(output, "%s,%s,%s,%zu,%d,%.6f,%.6f,%.4f,%.4f,%s",
+                    scalingName, result->entryName, result->phaseName, result->size, result->threadNumber,
+                    result->serialTime * 1e3, result->parallelTime * 1e3, result->speedup, result->efficiency, serialFraction);
+            break;
+        case BENCHMARK_FORMAT_JSON:
+            benchmarkFormatNumber(serialFraction, sizeof serialFraction, result->serialFraction, 4, "null");
+            fprintf(output, "%s\n    {\"entry\": \"%s\", \"phase\": \"%s\", \"size\": %zu, \"threads\": %d, \"serial_ms\": %.6f, \"parallel_ms\": %.6f, "
+                            "\"speedup\": %.4f, \"efficiency\": %.4f, \"serial_fraction\": %s",
+                    resultIndex ? "," : "", result->entryName, result->phaseName, result->size, result->threadNumber,
+                    result->serialTime * 1e3, result->parallelTime * 1e3, result->speedup, result->efficiency, serialFraction);
+            break;
+        default:
+            benchmarkFormatNumber(serialFraction, sizeof serialFraction, result->serialFraction, 4, "-");
+            fprintf(output, "%-16s %-32s %10zu %7d %12.4f %12.4f %8.3f %10.3f %8s",
+                    result->entryName, result->phaseName, result->size, result->threadNumber,
+                    result->serialTime * 1e3, result->parallelTime * 1e3, result->speedup, result->efficiency, serialFraction);
+    }
+
+    if (result->counted) {
+        benchmarkReportCounters(output, format, &result->counters);
+    }
+
+    fprintf(output, format == BENCHMARK_FORMAT_JSON ? "}" : "\n");
+
+    fflush(output);
+}
@@ -0,0 +1,105 @@
+#ifndef DJB_BENCHMARKREPORT_H
+#define DJB_BENCHMARKREPORT_H
+
+
+#include <stdio.h>
+#include <math.h>
+#include <stddef.h>
+
+#include "benchmarkTimer.h"
+#include "benchmarkCounter.h"
+
+
+/// The formats of the benchmark report.
+typedef enum {
+    /// Aligned columns, for the terminal.
+    BENCHMARK_FORMAT_TABLE,
+    /// Comma separated values with a header row.
+    BENCHMARK_FORMAT_CSV,
+    /// A JSON object with the configuration and the array of the results.
+    BENCHMARK_FORMAT_JSON
+} BenchmarkFormat;
+
+/// The new type representing the measures of a benchmark case at a given size, mode and number of threads.
+typedef struct {
+    /// The name of the case.
+    const char *caseName;
+    /// The number of elements produced by the measured function.
+    size_t size;
+    /// The type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+    short parallel;
+    /// The number of threads of the parallel regions.
+    int threadNumber;
+    /// The number of measured repetitions.
+    size_t repetitionNumber;
+    /// The wall time per element, in nanoseconds.
+    BenchmarkStatistic nsPerElement;
+    /// The cycles per element.
+    BenchmarkStatistic cyclesPerElement;
+    /// Whether the hardware events are requested, see benchmarkCounterEnabled.
+    short counted;
+    /// The metrics of the hardware events of the measured runs.
+    BenchmarkCounterMetrics counters;
+} BenchmarkResult;
+
+/// The kinds of scaling measured by the scaling driver.
+typedef enum {
+    /// The total size is fixed, the work per thread shrinks with the threads.
+    BENCHMARK_SCALING_STRONG,
+    /// The size per thread is fixed, the total size grows with the threads.
+    BENCHMARK_SCALING_WEAK
+} BenchmarkScaling;
+
+/// The new type representing the scaling of a phase of an entry point with a given number of threads.
+typedef struct {
+    /// The name of the entry point.
+    const char *entryName;
+    /// The name of the phase, the entry point itself for the whole call.
+    const char *phaseName;
+    /// The kind of scaling.
+    BenchmarkScaling scaling;
+    /// The number of elements processed by the phase.
+    size_t size;
+    /// The number of threads of the parallel regions.
+    int threadNumber;
+    /// The median wall time of the serial mode, in seconds, at size for the strong scaling and at the size of one thread for the weak scaling.
+    double serialTime;
+    /// The median wall time of the parallel mode, in seconds.
+    double parallelTime;
+    /// The speedup over the serial mode, scaled by the threads for the weak scaling.
+    double speedup;
+    /// The parallel efficiency, the speedup divided by the threads.
+    double efficiency;
+    /// The serial fraction, Karp-Flatt for the strong scaling and Gustafson for the weak scaling, NAN with a single thread.
+    double serialFraction;
+    /// Whether the hardware events are requested, see benchmarkCounterEnabled.
+    short counted;
+    /// The metrics of the hardware events of the parallel mode.
+    BenchmarkCounterMetrics counters;
+} BenchmarkScalingResult;
+
+/// The new type representing the configuration of the build, written at the start of the report.
+typedef struct {
+    /// The name of the kernels of the bitonic network.
+    const char *bitonicKernel;
+    /// The name of the merging network.
+    const char *mergeNetwork;
+    /// The number of warm-up runs of each measure.
+    size_t warmupNumber;
+    /// The number of measured runs of each measure.
+    size_t repetitionNumber;
+    /// How the threads are bound to the processors.
+    const char *threadBinding;
+    /// How the hardware events are counted, NULL if they are not requested.
+    const char *hardwareCounters;
+} BenchmarkConfiguration;
+
+
+void benchmarkReportBegin(FILE *output, BenchmarkFormat format, const BenchmarkConfiguration *configuration);
+void benchmarkReportResult(FILE *output, BenchmarkFormat format, const BenchmarkResult *result, size_t resultIndex);
+void benchmarkReportEnd(FILE *output, BenchmarkFormat format);
+void benchmarkReportScalingBegin(FILE *output, BenchmarkFormat format, const BenchmarkConfiguration *configuration, BenchmarkScaling scaling);
+void benchmarkReportScalingResult(FILE *output, BenchmarkFormat format, const BenchmarkScalingResult *result, size_t resultIndex);
+
+
+#endif //DJB_BENCHMARKREPORT_H
@@ -0,0 +1,188 @@
+// sched_setaffinity and the CPU_* macros are GNU extensions
+#define _GNU_SOURCE
+
+#include "benchmarkScaling.h"
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+
+const BenchmarkScalingEntry benchmarkScalingEntryList[] = {
+    // the pairs are sorted, then merged with the list
+    {"insertionseries", {{"insertionseries_sort_recursive", 1, 2}, {"insertionseries_sort_merge", 1, 1}}, 2},
+    // the positions of the 1s are sorted, then merged with the positions of the 0s
+    {"cww", {{"cww_sort_recursive", 1, 4}, {"cww_sort_mergebits", 1, 1}}, 2}
+};
+
+const size_t benchmarkScalingEntryNumber = sizeof benchmarkScalingEntryList / sizeof *benchmarkScalingEntryList;
+
+
+/**
+ * Function that binds each thread of the teams of threadNumber threads to its own processor.
+ *
+ * @details If the OpenMP runtime already binds the threads, because OMP_PROC_BIND is set, the binding of the runtime is kept.
+ * @details Otherwise the thread i is bound to the i-th processor of the affinity of the process, modulo the processors, by sched_setaffinity.
+ * The affinity of the process is read at the first call, before the master thread is bound.
+ * @details The teams of the following parallel regions with threadNumber threads reuse the bound threads of the pool of the runtime.
+ * @warning Only Linux supports the binding without OMP_PROC_BIND.
+ *
+ * @param threadNumber the number of threads of the team.
+ * @return 1 if the threads are bound, 0 otherwise.
+ */
+short benchmarkPinThreads(int threadNumber) {
+    if (omp_get_proc_bind() != omp_proc_bind_false) {
+        return 1;
+    }
+
+#ifdef __linux__
+    /// The processors of the affinity of the process.
+    static int processorList[CPU_SETSIZE];
+    /// The number of processors of the affinity of the process, -1 if the affinity is not read yet.
+    static int processorNumber = -1;
+
+    if (processorNumber < 0) {
+        /// The affinity of the process.
+        cpu_set_t affinity;
+        processorNumber = 0;
+
+        if (!sched_getaffinity(0, sizeof affinity, &affinity)) {
+            for (int processor = 0; processor < CPU_SETSIZE; ++processor) {
+                if (CPU_ISSET(processor, &affinity)) {
+                    processorList[processorNumber++] = processor;
+                }
+            }
+        }
+    }
+
+    if (!processorNumber) {
+        return 0;
+    }
+
+    /// Whether all the threads are bound.
+    short pinned = 1;
+
+    #pragma omp parallel num_threads(threadNumber) reduction(&&:pinned)
+    {
+        /// The processor of the thread.
+        cpu_set_t processor;
+        CPU_ZERO(&processor);
+        CPU_SET(processorList[omp_get_thread_num() % processorNumber], &processor);
+
+        pinned = !sched_setaffinity(0, sizeof processor, &processor);
+    }
+
+    return pinned;
+#else
+    (void) threadNumber;
+
+    return 0;
+#endif
+}
+
+/**
+ * Function that describes how the threads are bound to the processors.
+ *
+ * @param pin whether the benchmark binds the threads, 1, or not, 0.
+ * @return the description of the binding.
+ */
+const char *benchmarkThreadBinding(short pin) {
+    if (omp_get_proc_bind() != omp_proc_bind_false) {
+        return "OMP_PROC_BIND";
+    }
+
+    if (pin && benchmarkPinThreads(1)) {
+        return "sched_setaffinity";
+    }
+
+    return "none";
+}
+
+/**
+ * Function that measures the median wall time of a benchmark case.
+ *
+ * @param benchmarkCase the case.
+ * @param size the number of elements produced by the measured function.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ * @param threadNumber the number of threads of the parallel regions.
+ * @param warmupNumber the number of runs that are not measured.
+ * @param repetitionNumber the number of measured runs.
+ * @param pin whether the threads are bound to the processors, 1, or not, 0.
+ * @param counters the buffer of the metrics of the hardware events, NULL if they are not needed.
+ * @return the median wall time, in seconds.
+ */
+double benchmarkScalingTime(const BenchmarkCase *benchmarkCase, size_t size, short parallel, int threadNumber, size_t warmupNumber, size_t repetitionNumber, short pin, BenchmarkCounterMetrics *counters) {
+    if (pin) {
+        benchmarkPinThreads(threadNumber);
+    }
+
+    /// The measures of the case.
+    BenchmarkResult result = benchmarkCaseMeasure(benchmarkCase, size, parallel, threadNumber, warmupNumber, repetitionNumber);
+
+    if (counters) {
+        *counters = result.counters;
+    }
+
+    return result.nsPerElement.median * (double) (size ? size : 1) * 1e-9;
+}
+
+/**
+ * Function that measures the scaling of an entry point and of its phases.
+ *
+ * @details Each phase is measured on its own, in serial mode and in parallel mode with each number of threads, at the size it has inside the entry point.
+ * @details Strong scaling: the size is fixed, the speedup is the serial time over the parallel time and the serial fraction is the Karp-Flatt metric (1/speedup - 1/p) / (1 - 1/p).
+ * @details Weak scaling: the size grows as size times the threads, the speedup is scaled by the threads, p times the serial time of size over the parallel time, and the serial fraction is the Gustafson one (p - speedup) / (p - 1).
+ * The work of the networks grows as n log^2 n, so the weak efficiency also accounts the growth of the work per element.
+ * @details If the hardware events are requested, the metrics of the parallel mode are reported next to its time.
+ *
+ * @param output the stream of the report.
+ * @param format the format of the report.
+ * @param entry the entry point.
+ * @param scaling the kind of scaling.
+ * @param size the size of the entry point, the total one for the strong scaling and the one of each thread for the weak scaling.
+ * @param threadList the numbers of threads.
+ * @param threadNumber the count of numbers of threads.
+ * @param warmupNumber the number of runs that are not measured.
+ * @param repetitionNumber the number of measured runs.
+ * @param pin whether the threads are bound to the processors, 1, or not, 0.
+ * @param resultIndex the number of results written before the ones of the entry point.
+ * @return the number of results written, including the ones of the entry point.
+ */
+size_t benchmarkScalingRun(FILE *output, BenchmarkFormat format, const BenchmarkScalingEntry *entry, BenchmarkScaling scaling, size_t size, const int *threadList, size_t threadNumber, size_t warmupNumber, size_t repetitionNumber, short pin, size_t resultIndex) {
+    // the phase 0 is the whole call
+    for (size_t phase = 0; phase <= entry->phaseNumber; ++phase) {
+        /// The name of the case of the phase.
+        const char *phaseName = phase ? entry->phaseList[phase - 1].caseName : entry->caseName;
+        /// The numerator of the size of the phase.
+        size_t sizeNumerator = phase ? entry->phaseList[phase - 1].sizeNumerator : 1;
+        /// The denominator of the size of the phase.
+        size_t sizeDenominator = phase ? entry->phaseList[phase - 1].sizeDenominator : 1;
+        /// The case of the phase.
+        const BenchmarkCase *benchmarkCase = benchmarkCaseFind(phaseName);
+        assert(benchmarkCase && "Unknown phase!!!");
+
+        /// The median wall time of the serial mode.
+        double serialTime = benchmarkScalingTime(benchmarkCase, size * sizeNumerator / sizeDenominator, SERIAL, 1, warmupNumber, repetitionNumber, pin, NULL);
+
+        for (size_t t = 0; t < threadNumber; ++t) {
+            /// The number of threads.
+            double p = (double) threadList[t];
+            /// The size of the phase.
+            size_t phaseSize = (scaling == BENCHMARK_SCALING_WEAK ? size * (size_t) threadList[t] : size) * sizeNumerator / sizeDenominator;
+            /// The scaling of the phase.
+            BenchmarkScalingResult result = {entry->caseName, phaseName, scaling, phaseSize, threadList[t], serialTime, 0, 0, 0, NAN, benchmarkCounterEnabled(), {NAN, NAN, NAN}};
+
+            result.parallelTime = benchmarkScalingTime(benchmarkCase, phaseSize, PARALLEL, threadList[t], warmupNumber, repetitionNumber, pin, &result.counters);
+            result.speedup = (scaling == BENCHMARK_SCALING_WEAK ? p : 1) * serialTime / result.parallelTime;
+            result.efficiency = result.speedup / p;
+
+            if (threadList[t] > 1) {
+                result.serialFraction = scaling == BENCHMARK_SCALING_WEAK ? (p - result.speedup) / (p - 1) : (1 / result.speedup - 1 / p) / (1 - 1 / p);
+            }
+
+            benchmarkReportScalingResult(output, format, &result, resultIndex++);
+        }
+    }
+
+    return resultIndex;
+}
@@ -0,0 +1,51 @@
+#ifndef DJB_BENCHMARKSCALING_H
+#define DJB_BENCHMARKSCALING_H
+
+
+#include <omp.h>
+#include <math.h>
+#include <stdio.h>
+#include <stddef.h>
+
+#include "benchmarkCase.h"
+#include "benchmarkReport.h"
+
+
+/// The maximum number of phases of an entry point.
+#define BENCHMARK_SCALING_PHASES 4
+
+
+/// The new type representing a phase of an entry point, measured by a benchmark case.
+typedef struct {
+    /// The name of the benchmark case of the phase.
+    const char *caseName;
+    /// The numerator of the size of the phase, as a fraction of the size of the entry point.
+    size_t sizeNumerator;
+    /// The denominator of the size of the phase, as a fraction of the size of the entry point.
+    size_t sizeDenominator;
+} BenchmarkScalingPhase;
+
+/// The new type representing an entry point measured by the scaling driver, with its phases.
+typedef struct {
+    /// The name of the benchmark case of the whole call.
+    const char *caseName;
+    /// The phases of the call, in execution order.
+    BenchmarkScalingPhase phaseList[BENCHMARK_SCALING_PHASES];
+    /// The number of phases.
+    size_t phaseNumber;
+} BenchmarkScalingEntry;
+
+
+/// The entry points measured by the scaling driver.
+extern const BenchmarkScalingEntry benchmarkScalingEntryList[];
+/// The number of entry points measured by the scaling driver.
+extern const size_t benchmarkScalingEntryNumber;
+
+
+short benchmarkPinThreads(int threadNumber);
+const char *benchmarkThreadBinding(short pin);
+double benchmarkScalingTime(const BenchmarkCase *benchmarkCase, size_t size, short parallel, int threadNumber, size_t warmupNumber, size_t repetitionNumber, short pin, BenchmarkCounterMetrics *counters);
+size_t benchmarkScalingRun(FILE *output, BenchmarkFormat format, const BenchmarkScalingEntry *entry, BenchmarkScaling scaling, size_t size, const int *threadList, size_t threadNumber, size_t warmupNumber, size_t repetitionNumber, short pin, size_t resultIndex);
+
+
+#endif //DJB_BENCHMARKSCALING_H
@@ -0,0 +1,114 @@
+#include "benchmarkTimer.h"
+
+
+/**
+ * Function that reads the wall clock.
+ *
+ * @return the elapsed time in seconds from an arbitrary point in the past.
+ */
+double benchmarkWallTime(void) {
+    return omp_get_wtime();
+}
+
+/**
+ * Function that reads the cycle counter.
+ *
+ * @details On x86 it is the time stamp counter, which ticks at the nominal frequency of the processor whatever the current frequency is.
+ * @warning On the other architectures there is no cycle counter and the function returns 0, see benchmarkCyclesAvailable.
+ *
+ * @return the cycles elapsed from an arbitrary point in the past.
+ */
+uint64_t benchmarkCycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Function that tells whether benchmarkCycles reads a cycle counter.
+ *
+ * @return 1 if the cycles are measured, 0 otherwise.
+ */
+short benchmarkCyclesAvailable(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Function that compares two samples for qsort.
+ *
+ * @param first the first sample.
+ * @param second the second sample.
+ * @return a negative number, zero or a positive number if the first sample is less than, equal to or greater than the second one.
+ */
+static int benchmarkCompareSample(const void *first, const void *second) {
+    /// The first sample.
+    double firstSample = *(const double *) first;
+    /// The second sample.
+    double secondSample = *(const double *) second;
+
+    return (firstSample > secondSample) - (firstSample < secondSample);
+}
+
+/**
+ * Function that computes a percentile of sorted samples.
+ *
+ * @details The percentile is the nearest rank one, so it is always one of the samples.
+ *
+ * @param sortedSample the samples, in ascending order.
+ * @param sampleNumber the number of samples.
+ * @param percentile the percentile, between 0 and 100.
+ * @return the percentile of the samples, 0 if there are no samples.
+ */
+double benchmarkPercentile(const double *sortedSample, size_t sampleNumber, double percentile) {
+    if (!sampleNumber) {
+        return 0;
+    }
+
+    /// The rank of the percentile, starting from 1.
+    size_t rank = (size_t) (percentile / 100 * (double) sampleNumber);
+
+    if ((double) rank < percentile / 100 * (double) sampleNumber) {
+        ++rank;
+    }
+
+    if (rank < 1) {
+        rank = 1;
+    }
+
+    if (rank > sampleNumber) {
+        rank = sampleNumber;
+    }
+
+    return sortedSample[rank - 1];
+}
+
+/**
+ * Function that summarizes the samples of a measure.
+ *
+ * @details The median of an even number of samples is the mean of the two central ones.
+ *
+ * @param sample the samples, sorted in place.
+ * @param sampleNumber the number of samples.
+ * @return the median and the 99th percentile of the samples.
+ */
+BenchmarkStatistic benchmarkStatistic(double *sample, size_t sampleNumber) {
+    /// The summary of the samples.
+    BenchmarkStatistic statistic = {0, 0};
+
+    if (!sampleNumber) {
+        return statistic;
+    }
+
+    qsort(sample, sampleNumber, sizeof *sample, benchmarkCompareSample);
+
+    statistic.median = sampleNumber % 2 ? sample[sampleNumber / 2] : (sample[sampleNumber / 2 - 1] + sample[sampleNumber / 2]) / 2;
+    statistic.p99 = benchmarkPercentile(sample, sampleNumber, 99);
+
+    return statistic;
+}
@@ -0,0 +1,31 @@
+#ifndef DJB_BENCHMARKTIMER_H
+#define DJB_BENCHMARKTIMER_H
+
+
+#include <omp.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+
+/// The new type representing the summary of the samples of a measure.
+typedef struct {
+    /// The median of the samples.
+    double median;
+    /// The 99th percentile of the samples.
+    double p99;
+} BenchmarkStatistic;
+
+
+double benchmarkWallTime(void);
+uint64_t benchmarkCycles(void);
+short benchmarkCyclesAvailable(void);
+double benchmarkPercentile(const double *sortedSample, size_t sampleNumber, double percentile);
+BenchmarkStatistic benchmarkStatistic(double *sample, size_t sampleNumber);
+
+
+#endif //DJB_BENCHMARKTIMER_H
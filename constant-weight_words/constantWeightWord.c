@@ -40,241 +40,565 @@ IntList cww_via_insertionseries(int numberOfZero, IntList *positionOfOne, short
 
 
 /**
- * Function that inserts 1s in the correct position to create a constant-weight word.
+ * Function that computes the scratch bytes needed by cww_sort_mergebits_into.
+ *
+ * @param resultSize the size of the constant-weight word.
+ * @return the bytes to reserve in the arena.
+ */
+size_t cww_sort_mergebits_workspace_size(size_t resultSize) {
+    return arena_size(resultSize * sizeof(PositionKey));
+}
+
+/**
+ * Function that merges the positions of the 0s and of the 1s of a constant-weight word into a buffer of position keys.
+ *
+ * @warning The word must have less than 2^30 bits.
+ *
+ * @details The position keys are written directly in the buffer, the first list in the order expected by the active merging network followed by the second one normalized, and merged there by the network.
+ * @details On return the key i does not come from the list of zeros if and only if the bit i of the word is 1.
  *
+ * @param key the buffer of positionOfZeroSize + positionOfOneSize position keys.
  * @param positionOfZero the positions of the 0s within the word.
- * @param positionOfOne the positions in which to insert 1s.
+ * @param positionOfZeroSize the number of 0s.
+ * @param positionOfOne the sorted positions in which to insert 1s.
+ * @param positionOfOneSize the number of 1s.
  * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
- * @return the constant-weight word with the 1s in correct position.
  */
-IntList cww_sort_mergebits(const IntList *positionOfZero, const IntList *positionOfOne, short parallel) {
-    /// List size of positionOfZero.
-    size_t positionOfZeroSize = positionOfZero->listSize;
-    /// List size of positionOfOne.
-    size_t positionofOneSize = positionOfOne->listSize;
-
-    /// Array of quadruple, each quadruple value corresponds to the firstList values.
-    Quadruple *firstListQuadrupleArray = malloc(positionOfZeroSize * sizeof(Quadruple));
-    assert(firstListQuadrupleArray && "Malloc error!!!");
+void cww_sort_mergebits_keys(PositionKey *key, const int *positionOfZero, size_t positionOfZeroSize, const int *positionOfOne, size_t positionOfOneSize, short parallel) {
+    /// 1 if the merging network expects the first list in descending order.
+    short reversedFirstRun = mergeNetwork->reversedFirstRun;
 
-    /// Array of quadruple, each quadruple value corresponds to the firstList values.
-    Quadruple *secondListQuadrupleArray = malloc(positionofOneSize * sizeof(Quadruple));
-    assert(secondListQuadrupleArray && "Malloc error!!!");
+    STATS_PHASE_BEGIN(STATS_PHASE_KEYS);
 
     // we are only interested in fromLeft, which tells us whether it comes from the list of zeros (1) or the list of ones (0)
-    if (parallel) {
+    if (parallel && positionOfZeroSize + positionOfOneSize >= PREFIX_SUM_PARALLEL_CUTOFF) {
 #pragma omp parallel
         {
 #pragma omp for schedule(static) nowait
             for (size_t i = 0; i < positionOfZeroSize; ++i) {
-                firstListQuadrupleArray[i].index0 = positionOfZero->list[i];
-                firstListQuadrupleArray[i].index1 = 0;
-                firstListQuadrupleArray[i].fromLeft = 1;
-                firstListQuadrupleArray[i].indexInItsList = i;
+                key[reversedFirstRun ? positionOfZeroSize - 1 - i : i] = packPositionKey(positionOfZero[i], 1);
             }
 
 #pragma omp for schedule(static) nowait
             // to the second list we want to give it more importance (they are the tuples not yet entered)
-            for (size_t j = 0; j < positionofOneSize; ++j) {
-                secondListQuadrupleArray[j].index0 = positionOfOne->list[j] - (int)j;
-                secondListQuadrupleArray[j].index1 = 1;
-                secondListQuadrupleArray[j].fromLeft = 0;
-                secondListQuadrupleArray[j].indexInItsList = j;
+            for (size_t j = 0; j < positionOfOneSize; ++j) {
+                key[positionOfZeroSize + j] = packPositionKey(positionOfOne[j] - (int)j, 0);
             }
         }
     }
     else {
         for (size_t i = 0; i < positionOfZeroSize; ++i) {
-            firstListQuadrupleArray[i].index0 = positionOfZero->list[i];
-            firstListQuadrupleArray[i].index1 = 0;
-            firstListQuadrupleArray[i].fromLeft = 1;
-            firstListQuadrupleArray[i].indexInItsList = i;
+            key[reversedFirstRun ? positionOfZeroSize - 1 - i : i] = packPositionKey(positionOfZero[i], 1);
         }
 
         // to the second list we want to give it more importance (they are the tuples not yet entered)
-        for (size_t j = 0; j < positionofOneSize; ++j) {
-            secondListQuadrupleArray[j].index0 = positionOfOne->list[j] - (int)j;
-            secondListQuadrupleArray[j].index1 = 1;
-            secondListQuadrupleArray[j].fromLeft = 0;
-            secondListQuadrupleArray[j].indexInItsList = j;
+        for (size_t j = 0; j < positionOfOneSize; ++j) {
+            key[positionOfZeroSize + j] = packPositionKey(positionOfOne[j] - (int)j, 0);
         }
     }
 
-    /// The size of the new list of quadruple.
-    size_t newQuadrupleArraySize = positionOfZeroSize + positionofOneSize;
-    /// The new array of quadruple that contains the quadruple of the first and the second input list.
-    Quadruple *newQuadrupleArray = merge(firstListQuadrupleArray, positionOfZeroSize, secondListQuadrupleArray, positionofOneSize, parallel);
+    STATS_PHASE_END(STATS_PHASE_KEYS);
+
+    STATS_PHASE_BEGIN(STATS_PHASE_NETWORK);
+    mergeNetwork->mergePositionRuns(key, positionOfZeroSize, positionOfOneSize, parallel);
+    STATS_PHASE_END(STATS_PHASE_NETWORK);
+}
+
+/**
+ * Function that inserts 1s in the correct position to create a constant-weight word, into a buffer.
+ *
+ * @warning The arena must have room for cww_sort_mergebits_workspace_size(positionOfZeroSize + positionOfOneSize) bytes.
+ *
+ * @details The positions are merged by cww_sort_mergebits_keys in the arena.
+ *
+ * @param result the buffer that will contain the positionOfZeroSize + positionOfOneSize bits of the word.
+ * @param positionOfZero the positions of the 0s within the word.
+ * @param positionOfZeroSize the number of 0s.
+ * @param positionOfOne the sorted positions in which to insert 1s.
+ * @param positionOfOneSize the number of 1s.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_sort_mergebits_into(int *result, const int *positionOfZero, size_t positionOfZeroSize, const int *positionOfOne, size_t positionOfOneSize, Arena *arena, short parallel) {
+    /// The size of the word.
+    size_t resultSize = positionOfZeroSize + positionOfOneSize;
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+
+    /// The position keys.
+    PositionKey *key = arena_alloc(arena, resultSize * sizeof(PositionKey));
+
+    cww_sort_mergebits_keys(key, positionOfZero, positionOfZeroSize, positionOfOne, positionOfOneSize, parallel);
+
+    STATS_PHASE_BEGIN(STATS_PHASE_COPY_OUT);
+
+    // the 1s are the positions that do not come from the list of zeros
+    for (size_t i = 0; i < resultSize; ++i) {
+        result[i] = 1 - positionKeyFromLeft(key[i]);
+    }
+
+    STATS_PHASE_END(STATS_PHASE_COPY_OUT);
+
+    arena_release(arena, arenaMark);
+}
+
+/**
+ * Function that inserts 1s in the correct position to create a constant-weight word.
+ *
+ * @param positionOfZero the positions of the 0s within the word.
+ * @param positionOfOne the positions in which to insert 1s.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ * @return the constant-weight word with the 1s in correct position.
+ */
+IntList cww_sort_mergebits(const IntList *positionOfZero, const IntList *positionOfOne, short parallel) {
+    /// The size of the word.
+    size_t resultSize = positionOfZero->listSize + positionOfOne->listSize;
+    /// The size of the scratch memory.
+    size_t workspaceSize = cww_sort_mergebits_workspace_size(resultSize);
+
+    /// The scratch memory of the merge.
+    void *workspace = arena_workspace_alloc(workspaceSize);
+    /// The arena over the scratch memory.
+    Arena arena;
+    arena_init(&arena, workspace, workspaceSize);
 
     /// The output intList
     IntList result;
     intlist_init(&result);
-    intlist_reserve(&result, newQuadrupleArraySize);
+    intlist_reserve(&result, resultSize);
+    result.listSize = resultSize;
 
-    for (size_t i = 0; i < newQuadrupleArraySize; ++i) {
-        intlist_append(&result, newQuadrupleArray[i].index1);
-    }
+    cww_sort_mergebits_into(result.list, positionOfZero->list, positionOfZero->listSize, positionOfOne->list, positionOfOne->listSize, &arena, parallel);
 
-    // clean the allocated list
-    free(firstListQuadrupleArray);
-    free(secondListQuadrupleArray);
-    free(newQuadrupleArray);
+    arena_workspace_free(workspace, workspaceSize);
 
     return result;
 }
 
 /**
- * Function that performs an ordered merging of two intLists.
+ * Function that writes the merged positions.
  *
- * @param firstList the first intList.
- * @param secondList the second intList.
+ * @details The final position is the index0 of the key plus the number of previous keys that do not come from the left list.
+ * @details Each key is read once, in the same sweep that scans the fromLeft and writes the position, by the emitMergedPositionKeys kernel.
+ * @details Parallel version, blocked: the threads count the fromLeft of their chunk, then each one sweeps its chunk from its offset.
+ *
+ * @param result the buffer of size positions.
+ * @param key the merged position keys.
+ * @param size the number of keys.
+ * @param arena the arena that has room for prefixSumWorkspaceSize bytes.
  * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
- * @return the ordered merged intList.
  */
-IntList cww_sort_mergepos(const IntList *firstList, const IntList *secondList, short parallel) {
-    /// List size of firstList.
-    size_t firstListSize = firstList->listSize;
-    /// List size of secondList.
-    size_t secondListSize = secondList->listSize;
+void cww_emit_merged(int *result, const PositionKey *key, size_t size, Arena *arena, short parallel) {
+    STATS_PHASE_BEGIN(STATS_PHASE_COPY_OUT);
+
+    if (parallel && size >= PREFIX_SUM_PARALLEL_CUTOFF) {
+        /// The position of the arena to restore.
+        size_t arenaMark = arena_mark(arena);
+        /// List of partial sum, one for each thread.
+        int *partialSumList = arena_alloc(arena, (size_t) omp_get_max_threads() * sizeof(int));
+
+#pragma omp parallel
+        {
+            /// Start position.
+            size_t start;
+            /// End position.
+            size_t end;
+            prefixSumChunk(size, &start, &end);
+
+            /// The number of keys before the chunk that do not come from the left list.
+            int offset = prefixSumOffsetTeam(countFromLeftInversePositionKeys(key + start, end - start), partialSumList);
+
+            emitMergedPositionKeys(result + start, key + start, end - start, offset);
+        }
+
+        arena_release(arena, arenaMark);
+    }
+    else {
+        emitMergedPositionKeys(result, key, size, 0);
+    }
+
+    STATS_PHASE_END(STATS_PHASE_COPY_OUT);
+}
+
+/**
+ * Function that computes the scratch bytes needed by cww_sort_mergepos_into.
+ *
+ * @note The size depends on the maximum number of OpenMP threads at the time of the call.
+ *
+ * @param resultSize the size of the merged array.
+ * @return the bytes to reserve in the arena.
+ */
+size_t cww_sort_mergepos_workspace_size(size_t resultSize) {
+    return arena_size(resultSize * sizeof(PositionKey))     // position keys
+         + prefixSumWorkspaceSize();
+}
+
+/**
+ * Function that performs an ordered merging of two sorted arrays of positions into a buffer.
+ *
+ * @warning The arena must have room for cww_sort_mergepos_workspace_size(firstListSize + secondListSize) bytes.
+ * @warning The positions must be less than 2^30.
+ *
+ * @details The position keys are written directly in the arena, the first list in the order expected by the active merging network followed by the second one normalized, and merged there by the network.
+ * @details A position key is a single 32-bit integer: the networks exchange them with min and max, twice as many per vector instruction as the 64-bit keys of the quadruples.
+ * @details The inputs are completely read before the result is written, so the result may overlap them: when the two lists are contiguous in the result the merge is in place.
+ * @details All the scratch buffers are released before returning.
+ *
+ * @param result the buffer that will contain the firstListSize + secondListSize merged positions.
+ * @param firstList the first sorted array of positions.
+ * @param firstListSize the size of the first array.
+ * @param secondList the second sorted array of positions.
+ * @param secondListSize the size of the second array.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_sort_mergepos_into(int *result, const int *firstList, size_t firstListSize, const int *secondList, size_t secondListSize, Arena *arena, short parallel) {
+    /// The size of the merged array.
+    size_t resultSize = firstListSize + secondListSize;
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
 
-    /// Array of quadruple, each quadruple value corresponds to the firstList values.
-    Quadruple *firstListQuadrupleArray = malloc(firstListSize * sizeof(Quadruple));
-    assert(firstListQuadrupleArray  && "Malloc error!!!");
+    /// The position keys.
+    PositionKey *key = arena_alloc(arena, resultSize * sizeof(PositionKey));
+    /// 1 if the merging network expects the first list in descending order.
+    short reversedFirstRun = mergeNetwork->reversedFirstRun;
 
-    /// Array of quadruple, each quadruple value corresponds to the secondList values.
-    Quadruple *secondListQuadrupleArray = malloc(secondListSize * sizeof(Quadruple));
-    assert(secondListQuadrupleArray && "Malloc error!!!");
+    STATS_PHASE_BEGIN(STATS_PHASE_KEYS);
 
-    if (parallel) {
+    if (parallel && resultSize >= PREFIX_SUM_PARALLEL_CUTOFF) {
 #pragma omp parallel
         {
 #pragma omp for schedule(static) nowait
             for (size_t i = 0; i < firstListSize; ++i) {
-                firstListQuadrupleArray[i].index0 = firstList->list[i];
-                firstListQuadrupleArray[i].index1 = 1;
-                firstListQuadrupleArray[i].fromLeft = 1;
-                firstListQuadrupleArray[i].indexInItsList = i;
+                key[reversedFirstRun ? firstListSize - 1 - i : i] = packPositionKey(firstList[i], 1);
             }
 
 #pragma omp for schedule(static) nowait
             for (size_t j = 0; j < secondListSize; ++j) {
-                secondListQuadrupleArray[j].index0 = secondList->list[j] - (int)j;
-                secondListQuadrupleArray[j].index1 = 1;
-                secondListQuadrupleArray[j].fromLeft = 0;
-                secondListQuadrupleArray[j].indexInItsList = j;
+                key[firstListSize + j] = packPositionKey(secondList[j] - (int)j, 0);
             }
         }
     }
     else {
         for (size_t i = 0; i < firstListSize; ++i) {
-            firstListQuadrupleArray[i].index0 = firstList->list[i];
-            firstListQuadrupleArray[i].index1 = 1;
-            firstListQuadrupleArray[i].fromLeft = 1;
-            firstListQuadrupleArray[i].indexInItsList = i;
+            key[reversedFirstRun ? firstListSize - 1 - i : i] = packPositionKey(firstList[i], 1);
         }
 
         for (size_t j = 0; j < secondListSize; ++j) {
-            secondListQuadrupleArray[j].index0 = secondList->list[j] - (int)j;
-            secondListQuadrupleArray[j].index1 = 1;
-            secondListQuadrupleArray[j].fromLeft = 0;
-            secondListQuadrupleArray[j].indexInItsList = j;
+            key[firstListSize + j] = packPositionKey(secondList[j] - (int)j, 0);
         }
     }
 
-    /// The size of the new list of quadruple.
-    size_t newQuadrupleArraySize = firstListSize + secondListSize;
-    /// The new array of quadruple that contains the quadruple of the first and the second input list.
-    Quadruple *newQuadrupleArray = merge(firstListQuadrupleArray, firstListSize, secondListQuadrupleArray, secondListSize, parallel);
+    STATS_PHASE_END(STATS_PHASE_KEYS);
 
-    /// IntList that contains the inverse of newQuadrupleArray.fromLeft.
-    IntList fromLeftInverse;
-    intlist_init(&fromLeftInverse);
-    intlist_reserve(&fromLeftInverse, newQuadrupleArraySize);
+    STATS_PHASE_BEGIN(STATS_PHASE_NETWORK);
+    mergeNetwork->mergePositionRuns(key, firstListSize, secondListSize, parallel);
+    STATS_PHASE_END(STATS_PHASE_NETWORK);
 
-    for (size_t i = 0; i < newQuadrupleArraySize; ++i) {
-        intlist_append(&fromLeftInverse, 1 - newQuadrupleArray[i].fromLeft);
-    }
+    cww_emit_merged(result, key, resultSize, arena, parallel);
+
+    arena_release(arena, arenaMark);
+}
+
+/**
+ * Function that performs an ordered merging of two intLists.
+ *
+ * @param firstList the first intList.
+ * @param secondList the second intList.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ * @return the ordered merged intList.
+ */
+IntList cww_sort_mergepos(const IntList *firstList, const IntList *secondList, short parallel) {
+    /// The size of the merged intList.
+    size_t resultSize = firstList->listSize + secondList->listSize;
+    /// The size of the scratch memory.
+    size_t workspaceSize = cww_sort_mergepos_workspace_size(resultSize);
 
-    /// The list of true offset to add at each element of newQuadrupleArray.index0.
-    IntList offsetList = prefixSum(&fromLeftInverse, parallel);
+    /// The scratch memory of the merge.
+    void *workspace = arena_workspace_alloc(workspaceSize);
+    /// The arena over the scratch memory.
+    Arena arena;
+    arena_init(&arena, workspace, workspaceSize);
 
     /// The output intList.
     IntList result;
     intlist_init(&result);
-    intlist_reserve(&result, newQuadrupleArraySize);
+    intlist_reserve(&result, resultSize);
+    result.listSize = resultSize;
 
-    for (size_t i = 0; i < newQuadrupleArraySize; ++i) {
-        intlist_append(&result, newQuadrupleArray[i].index0 + offsetList.list[i]);
-    }
+    cww_sort_mergepos_into(result.list, firstList->list, firstList->listSize, secondList->list, secondList->listSize, &arena, parallel);
 
-    // clean the allocated list
-    free(firstListQuadrupleArray);
-    free(secondListQuadrupleArray);
-    free(newQuadrupleArray);
-    intlist_free(&fromLeftInverse);
-    intlist_free(&offsetList);
+    arena_workspace_free(workspace, workspaceSize);
 
     return result;
 }
 
 /**
- * Function that sorts an intList.
+ * Function that sorts the blocks of SORT_TASK_CUTOFF positions at the same time.
+ *
+ * @details Each block is a subtree of the recursion: it is sorted by a single thread, serially, inside its own part of the arena.
+ *
+ * @param intList the array of positions to sort.
+ * @param intListSize the array size.
+ * @param arena the arena of the scratch buffers.
+ * @return the width of the runs already sorted, 1 if the blocks have not been sorted.
+ */
+size_t cww_sort_blocks(int *intList, size_t intListSize, Arena *arena) {
+    /// The number of blocks.
+    size_t blockNumber = (intListSize + SORT_TASK_CUTOFF - 1) / SORT_TASK_CUTOFF;
+    /// The bytes of the arena used by each thread.
+    size_t threadWorkspaceSize = cww_sort_mergepos_workspace_size(intListSize < SORT_TASK_CUTOFF ? intListSize : SORT_TASK_CUTOFF);
+    /// The number of threads.
+    int threadNumber = sortThreadNumber(blockNumber, threadWorkspaceSize, arena);
+
+    if (threadNumber < 2) {
+        return 1;
+    }
+
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+    /// The memory shared by the threads.
+    unsigned char *threadWorkspace = arena_alloc(arena, (size_t) threadNumber * threadWorkspaceSize);
+
+#pragma omp parallel num_threads(threadNumber)
+    {
+        /// The part of the arena of this thread.
+        Arena threadArena;
+        arena_init(&threadArena, threadWorkspace + (size_t) omp_get_thread_num() * threadWorkspaceSize, threadWorkspaceSize);
+
+#pragma omp for schedule(dynamic, 1)
+        for (size_t block = 0; block < blockNumber; ++block) {
+            /// The first position of the block.
+            size_t start = block * SORT_TASK_CUTOFF;
+            /// The block size, the last one can be shorter.
+            size_t blockSize = intListSize - start < SORT_TASK_CUTOFF ? intListSize - start : SORT_TASK_CUTOFF;
+
+            cww_sort_recursive_into(&intList[start], blockSize, &threadArena, SERIAL);
+        }
+    }
+
+    arena_release(arena, arenaMark);
+
+    return SORT_TASK_CUTOFF;
+}
+
+/**
+ * Function that merges two by two the sorted runs of a given width.
+ *
+ * @details In parallel mode, when there are enough runs to occupy all the threads, the merges are independent subtrees of the recursion: each thread merges its runs serially, inside its own part of the arena.
+ * @details Otherwise the merges are executed one after another, each one parallelized inside.
+ *
+ * @param intList the array of positions.
+ * @param intListSize the array size.
+ * @param width the width of the sorted runs.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_sort_level(int *intList, size_t intListSize, size_t width, Arena *arena, short parallel) {
+    /// The number of merges of the level.
+    size_t mergeNumber = (intListSize - width + 2 * width - 1) / (2 * width);
+    /// The bytes of the arena used by each thread.
+    size_t threadWorkspaceSize = cww_sort_mergepos_workspace_size(intListSize < 2 * width ? intListSize : 2 * width);
+    /// The number of threads that merge at the same time.
+    int threadNumber = parallel && mergeNumber >= (size_t) omp_get_max_threads() ? sortThreadNumber(mergeNumber, threadWorkspaceSize, arena) : 1;
+
+    if (threadNumber > 1) {
+        /// The position of the arena to restore.
+        size_t arenaMark = arena_mark(arena);
+        /// The memory shared by the threads.
+        unsigned char *threadWorkspace = arena_alloc(arena, (size_t) threadNumber * threadWorkspaceSize);
+
+#pragma omp parallel num_threads(threadNumber)
+        {
+            /// The part of the arena of this thread.
+            Arena threadArena;
+            arena_init(&threadArena, threadWorkspace + (size_t) omp_get_thread_num() * threadWorkspaceSize, threadWorkspaceSize);
+
+#pragma omp for schedule(static)
+            for (size_t merge = 0; merge < mergeNumber; ++merge) {
+                /// The first position of the left run.
+                size_t start = merge * 2 * width;
+                /// The size of the right run, the last one can be shorter.
+                size_t rightSize = intListSize - start - width < width ? intListSize - start - width : width;
+
+                cww_sort_mergepos_into(&intList[start], &intList[start], width, &intList[start + width], rightSize, &threadArena, SERIAL);
+            }
+        }
+
+        arena_release(arena, arenaMark);
+    }
+    else {
+        for (size_t start = 0; start + width < intListSize; start += 2 * width) {
+            /// The size of the right run, the last one can be shorter.
+            size_t rightSize = intListSize - start - width < width ? intListSize - start - width : width;
+
+            cww_sort_mergepos_into(&intList[start], &intList[start], width, &intList[start + width], rightSize, arena, parallel);
+        }
+    }
+}
+
+/**
+ * Function that sorts an array of positions in place.
+ *
+ * @warning The arena must have room for cww_sort_mergepos_workspace_size(intListSize) bytes.
  *
- * @note The function works recursively.
+ * @details The recursion of the reference algorithm is executed bottom-up: the runs of width 1, 2, 4, ... are merged two by two, inside the array.
+ * @details The result does not depend on where the array is split, so it is the same of the top-down recursion.
+ * @details Each merge takes its scratch buffers from the arena and releases them, so the arena is reused by all the merges.
+ * @details In parallel mode the subtrees of SORT_TASK_CUTOFF positions are sorted at the same time, one per thread, and so are the merges of a level with at least one run per thread.
+ * @details An array of at most SORT_TASK_CUTOFF positions is sorted serially even in parallel mode.
+ *
+ * @param intList the array of positions to sort.
+ * @param intListSize the array size.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algortihm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_sort_recursive_into(int *intList, size_t intListSize, Arena *arena, short parallel) {
+    // an array of at most SORT_TASK_CUTOFF positions is a single subtree, sorted by a single thread
+    if (intListSize <= SORT_TASK_CUTOFF) {
+        parallel = SERIAL;
+    }
+
+    /// The width of the runs already sorted.
+    size_t width = parallel ? cww_sort_blocks(intList, intListSize, arena) : 1;
+
+    for (; width < intListSize; width *= 2) {
+        cww_sort_level(intList, intListSize, width, arena, parallel);
+    }
+}
+
+/**
+ * Function that sorts an intList.
  *
  * @param intList the intList to sort.
  * @param parallel the type of algortihm execution, either parallel mode, 1, or serial mode, 0.
  * @return the intList sorted.
  */
 IntList cww_sort_recursive(const IntList *intList, short parallel) {
-    // base case
-    if (intList->listSize <= 1) {
-        /// The sorted intList.
-        IntList result;
+    /// The intList size.
+    size_t intListSize = intList->listSize;
+    /// The size of the scratch memory.
+    size_t workspaceSize = cww_sort_mergepos_workspace_size(intListSize);
 
-        intlist_copy(&result, intList);
+    /// The sorted intList.
+    IntList result;
+    intlist_init(&result);
+    intlist_reserve(&result, intListSize);
+    result.listSize = intListSize;
 
-        return result;
+    if (intListSize) {
+        memcpy(result.list, intList->list, intListSize * sizeof *result.list);
     }
 
-    /// The intList size.
-    size_t intListSize = intList->listSize;
-    /// THe half of intListSize.
-    size_t halfIntListSize = intListSize / 2;
+    /// The scratch memory of the merges.
+    void *workspace = arena_workspace_alloc(workspaceSize);
+    /// The arena over the scratch memory.
+    Arena arena;
+    arena_init(&arena, workspace, workspaceSize);
 
-    /// The left part of the input intList.
-    IntList left;
-    intlist_init(&left);
-    intlist_reserve(&left, halfIntListSize);
+    cww_sort_recursive_into(result.list, intListSize, &arena, parallel);
 
-    /// The right part of the input intList.
-    IntList right;
-    intlist_init(&right);
-    intlist_reserve(&right, intListSize - halfIntListSize);
+    arena_workspace_free(workspace, workspaceSize);
 
-    for (size_t i = 0; i < halfIntListSize; ++i) {
-        intlist_append(&left, intList->list[i]);
-    }
+    return result;
+}
+
+/**
+ * Function that computes the scratch bytes needed by cww_in_place_with_workspace.
+ *
+ * @note The size depends on the maximum number of OpenMP threads at the time of the call.
+ *
+ * @param numberOfZero the number of 0s in the constant-weight word.
+ * @param numberOfOne the number of 1s in the constant-weight word.
+ * @return the bytes to reserve in the arena.
+ */
+size_t cww_in_place_workspace_size(size_t numberOfZero, size_t numberOfOne) {
+    /// The bytes needed while the positions of the 1s are sorted.
+    size_t sortSize = cww_sort_mergepos_workspace_size(numberOfOne);
+    /// The bytes needed while the bits are merged.
+    size_t mergeSize = arena_size(numberOfZero * sizeof(int)) + cww_sort_mergebits_workspace_size(numberOfZero + numberOfOne);
+
+    return sortSize > mergeSize ? sortSize : mergeSize;
+}
+
+/**
+ * Function that computes the scratch bytes needed by cww_with_workspace.
+ *
+ * @note The size depends on the maximum number of OpenMP threads at the time of the call.
+ *
+ * @param numberOfZero the number of 0s in the constant-weight word.
+ * @param numberOfOne the number of 1s in the constant-weight word.
+ * @return the bytes to reserve in the arena.
+ */
+size_t cww_workspace_size(size_t numberOfZero, size_t numberOfOne) {
+    return arena_size(numberOfOne * sizeof(int)) + cww_in_place_workspace_size(numberOfZero, numberOfOne);
+}
+
+/**
+ * Function that creates a constant-weight word from positions that can be overwritten, without allocating memory.
+ *
+ * @warning The arena must have room for cww_in_place_workspace_size(numberOfZero, positionOfOneSize) bytes.
+ *
+ * @details The positions are sorted in place, so the word is built without copying them.
+ *
+ * @param result the buffer that will contain the numberOfZero + positionOfOneSize bits of the word.
+ * @param numberOfZero the number of 0s in the constant-weight word.
+ * @param positionOfOne the positions where the 1s will go, sorted on return.
+ * @param positionOfOneSize the number of 1s.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_in_place_with_workspace(int *result, int numberOfZero, int *positionOfOne, size_t positionOfOneSize, Arena *arena, short parallel) {
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+
+    cww_sort_recursive_into(positionOfOne, positionOfOneSize, arena, parallel);
+
+    /// The indexes of 0s.
+    /// @note The word currently only has 0s.
+    int *positionOfZero = arena_alloc(arena, (size_t) numberOfZero * sizeof(int));
+
+    STATS_PHASE_BEGIN(STATS_PHASE_KEYS);
 
-    for (size_t i = halfIntListSize; i < intListSize; ++i) {
-        intlist_append(&right, intList->list[i]);
+    for (int i = 0; i < numberOfZero; ++i) {
+        positionOfZero[i] = i;
     }
 
+    STATS_PHASE_END(STATS_PHASE_KEYS);
 
-    /// The sorted left part of the input intList.
-    IntList sortedLeft = cww_sort_recursive(&left, parallel);
-    /// The sorted right part of the input intList.
-    IntList sortedRight = cww_sort_recursive(&right, parallel);
+    cww_sort_mergebits_into(result, positionOfZero, (size_t) numberOfZero, positionOfOne, positionOfOneSize, arena, parallel);
 
-    /// The sorted intList.
-    IntList result = cww_sort_mergepos(&sortedLeft, &sortedRight, parallel);
+    arena_release(arena, arenaMark);
+}
+
+/**
+ * Function that creates a constant-weight word, without allocating memory.
+ *
+ * @warning The arena must have room for cww_workspace_size(numberOfZero, positionOfOneSize) bytes.
+ *
+ * @details The arena is left as it was found, so the same memory can be reused by every call with the same sizes.
+ *
+ * @param result the buffer that will contain the numberOfZero + positionOfOneSize bits of the word.
+ * @param numberOfZero the number of 0s in the constant-weight word.
+ * @param positionOfOne the positions where the 1s will go.
+ * @param positionOfOneSize the number of 1s.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_with_workspace(int *result, int numberOfZero, const int *positionOfOne, size_t positionOfOneSize, Arena *arena, short parallel) {
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
 
-    // Cleanup
-    intlist_free(&left);
-    intlist_free(&right);
-    intlist_free(&sortedLeft);
-    intlist_free(&sortedRight);
+    /// The ordered positions in which to insert the 1s.
+    int *sortedPositionOfOne = arena_alloc(arena, positionOfOneSize * sizeof(int));
 
-    return result;
+    if (positionOfOneSize) {
+        memcpy(sortedPositionOfOne, positionOfOne, positionOfOneSize * sizeof *sortedPositionOfOne);
+    }
+
+    cww_in_place_with_workspace(result, numberOfZero, sortedPositionOfOne, positionOfOneSize, arena, parallel);
+
+    arena_release(arena, arenaMark);
 }
 
 /**
@@ -288,24 +612,1584 @@ IntList cww_sort_recursive(const IntList *intList, short parallel) {
  * @return the constant-weight word composed of the number of 0s and the position of 1s required.
  */
 IntList cww_merge_after_sort_recursive(int numberOfZero, IntList *positionOfOne, short parallel) {
-    /// List containing the indexes of 0s.
-    /// @note The word currently only has 0s.
-    IntList positionOfZero;
-    intlist_init(&positionOfZero);
-    intlist_reserve(&positionOfZero, numberOfZero);
+    /// The size of the scratch memory.
+    size_t workspaceSize = cww_workspace_size((size_t) numberOfZero, positionOfOne->listSize);
 
-    for (int i = 0; i < numberOfZero; ++i) {
-        intlist_append(&positionOfZero, i);
-    }
+    /// The scratch memory of the constant-weight word.
+    void *workspace = arena_workspace_alloc(workspaceSize);
+    /// The arena over the scratch memory.
+    Arena arena;
+    arena_init(&arena, workspace, workspaceSize);
 
-    /// The ordered list of positions in which to insert the 1s.
-    IntList sortedPositionOfOne = cww_sort_recursive(positionOfOne, parallel);
+    /// The cww created.
+    IntList result;
+    intlist_init(&result);
+    intlist_reserve(&result, (size_t) numberOfZero + positionOfOne->listSize);
+    result.listSize = (size_t) numberOfZero + positionOfOne->listSize;
 
-    /// The cww created:
-    IntList result = cww_sort_mergebits(&positionOfZero, &sortedPositionOfOne, parallel);
+    cww_with_workspace(result.list, numberOfZero, positionOfOne->list, positionOfOne->listSize, &arena, parallel);
 
-    intlist_free(&positionOfZero);
-    intlist_free(&sortedPositionOfOne);
+    arena_workspace_free(workspace, workspaceSize);
 
     return result;
-}
\ No newline at end of file
+}
+
+
+/**
+ * Function that computes the number of 64-bit limbs of a packed constant-weight word.
+ *
+ * @param wordSize the number of bits of the word.
+ * @return the number of limbs.
+ */
+size_t cww_limb_count(size_t wordSize) {
+    return (wordSize + 63) / 64;
+}
+
+/**
+ * Function that computes the number of bytes of a packed constant-weight word.
+ *
+ * @param wordSize the number of bits of the word.
+ * @return the number of bytes.
+ */
+size_t cww_byte_count(size_t wordSize) {
+    return (wordSize + 7) / 8;
+}
+
+/**
+ * Function that stores a limb of a packed word as little-endian bytes.
+ *
+ * @param result the buffer of byteCount bytes.
+ * @param limb the limb.
+ * @param byteCount the number of bytes to store, at most 8: the ones past the end of the word are not stored.
+ */
+static void cww_store_limb_bytes(unsigned char *result, uint64_t limb, size_t byteCount) {
+    for (size_t k = 0; k < byteCount; ++k) {
+        result[k] = (unsigned char) (limb >> (8 * k));
+    }
+}
+
+/**
+ * Function that builds a limb of a packed word from the positions of its 1s.
+ *
+ * @details Every position is compared with the limb, so the memory accesses and the operations do not depend on the positions.
+ *
+ * @param limbIndex the index of the limb.
+ * @param position the positions of the 1s.
+ * @param positionSize the number of 1s.
+ * @return the limb, whose bit b is 1 if limbIndex * 64 + b is one of the positions.
+ */
+static uint64_t cww_limb_of_positions(size_t limbIndex, const int *position, size_t positionSize) {
+    /// The packed bits.
+    uint64_t limb = 0;
+
+    for (size_t i = 0; i < positionSize; ++i) {
+        /// The bits that differ between the limb of the position and the current one, 0 if they are the same.
+        uint32_t difference = ((uint32_t) position[i] >> 6) ^ (uint32_t) limbIndex;
+        /// The mux selector, all bits set if the position is inside the current limb, 0 otherwise.
+        uint64_t muxSelector = 0 - (uint64_t) ((difference - 1) >> 31);
+
+        limb |= muxSelector & ((uint64_t) 1 << (position[i] & 63));
+    }
+
+    return limb;
+}
+
+/**
+ * Function that packs the bits of a constant-weight word from the positions of its 1s.
+ *
+ * @warning The positions must be distinct, non-negative and less than wordSize, wordSize less than 2^31.
+ *
+ * @details The word is built in constant time, see cww_limb_of_positions: O(positionSize * wordSize / 64) operations, fewer than a merge of the whole word when the 1s are few.
+ * @details The bit i of the word is the bit i % 64 of the limb i / 64 and, in byte mode, the bit i % 8 of the byte i / 8.
+ *
+ * @param limbResult the buffer of cww_limb_count(wordSize) limbs, NULL in byte mode.
+ * @param byteResult the buffer of cww_byte_count(wordSize) bytes, NULL in limb mode.
+ * @param wordSize the number of bits of the word.
+ * @param position the positions of the 1s, in any order.
+ * @param positionSize the number of 1s.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+static void cww_pack_positions(uint64_t *limbResult, unsigned char *byteResult, size_t wordSize, const int *position, size_t positionSize, short parallel) {
+    /// The number of limbs of the word.
+    size_t limbCount = cww_limb_count(wordSize);
+    /// The number of bytes of the word.
+    size_t byteCount = cww_byte_count(wordSize);
+
+#pragma omp parallel for schedule(static) if(parallel && limbCount * positionSize >= PREFIX_SUM_PARALLEL_CUTOFF)
+    for (size_t j = 0; j < limbCount; ++j) {
+        /// The limb j of the word.
+        uint64_t limb = cww_limb_of_positions(j, position, positionSize);
+
+        if (limbResult) {
+            limbResult[j] = limb;
+        }
+        else {
+            cww_store_limb_bytes(&byteResult[8 * j], limb, byteCount - 8 * j < 8 ? byteCount - 8 * j : 8);
+        }
+    }
+}
+
+/**
+ * Function that packs the bits of a constant-weight word from the output of the merging network.
+ *
+ * @details Each limb is packed by the packMergedBits kernel from 64 consecutive keys.
+ *
+ * @param limbResult the buffer of cww_limb_count(size) limbs, NULL in byte mode.
+ * @param byteResult the buffer of cww_byte_count(size) bytes, NULL in limb mode.
+ * @param key the merged position keys, see cww_sort_mergebits_keys.
+ * @param size the number of bits of the word.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+static void cww_pack_merged(uint64_t *limbResult, unsigned char *byteResult, const PositionKey *key, size_t size, short parallel) {
+    /// The number of limbs of the word.
+    size_t limbCount = cww_limb_count(size);
+    /// The number of bytes of the word.
+    size_t byteCount = cww_byte_count(size);
+
+    STATS_PHASE_BEGIN(STATS_PHASE_COPY_OUT);
+
+#pragma omp parallel for schedule(static) if(parallel && size >= PREFIX_SUM_PARALLEL_CUTOFF)
+    for (size_t j = 0; j < limbCount; ++j) {
+        /// The limb j of the word.
+        uint64_t limb = packMergedBits(&key[64 * j], size - 64 * j < 64 ? size - 64 * j : 64);
+
+        if (limbResult) {
+            limbResult[j] = limb;
+        }
+        else {
+            cww_store_limb_bytes(&byteResult[8 * j], limb, byteCount - 8 * j < 8 ? byteCount - 8 * j : 8);
+        }
+    }
+
+    STATS_PHASE_END(STATS_PHASE_COPY_OUT);
+}
+
+/**
+ * Function that creates a packed constant-weight word from positions that can be overwritten, without allocating memory.
+ *
+ * @warning The arena must have room for cww_in_place_workspace_size(numberOfZero, positionOfOneSize) bytes.
+ *
+ * @details The positions of the 1s are sorted in place, then the word is packed directly, without the array of one integer per bit:
+ * up to CWW_PACK_POSITIONS_CUTOFF 1s from the sorted positions, which are the final positions of the 1s, above it from the keys merged by the network.
+ * @details The choice only depends on the sizes, so the whole construction is constant-time.
+ *
+ * @param limbResult the buffer of cww_limb_count(numberOfZero + positionOfOneSize) limbs, NULL in byte mode.
+ * @param byteResult the buffer of cww_byte_count(numberOfZero + positionOfOneSize) bytes, NULL in limb mode.
+ * @param numberOfZero the number of 0s in the constant-weight word.
+ * @param positionOfOne the positions where the 1s will go, sorted on return.
+ * @param positionOfOneSize the number of 1s.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+static void cww_pack_in_place(uint64_t *limbResult, unsigned char *byteResult, int numberOfZero, int *positionOfOne, size_t positionOfOneSize, Arena *arena, short parallel) {
+    /// The size of the word.
+    size_t resultSize = (size_t) numberOfZero + positionOfOneSize;
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+
+    cww_sort_recursive_into(positionOfOne, positionOfOneSize, arena, parallel);
+
+    if (positionOfOneSize <= CWW_PACK_POSITIONS_CUTOFF) {
+        cww_pack_positions(limbResult, byteResult, resultSize, positionOfOne, positionOfOneSize, parallel);
+    }
+    else {
+        /// The indexes of 0s.
+        /// @note The word currently only has 0s.
+        int *positionOfZero = arena_alloc(arena, (size_t) numberOfZero * sizeof(int));
+
+        for (int i = 0; i < numberOfZero; ++i) {
+            positionOfZero[i] = i;
+        }
+
+        /// The position keys merged by the network.
+        PositionKey *key = arena_alloc(arena, resultSize * sizeof(PositionKey));
+
+        cww_sort_mergebits_keys(key, positionOfZero, (size_t) numberOfZero, positionOfOne, positionOfOneSize, parallel);
+        cww_pack_merged(limbResult, byteResult, key, resultSize, parallel);
+    }
+
+    arena_release(arena, arenaMark);
+}
+
+/**
+ * Function that creates a packed constant-weight word, without allocating memory.
+ *
+ * @warning The arena must have room for cww_workspace_size(numberOfZero, positionOfOneSize) bytes.
+ *
+ * @details The positions are copied in the arena and packed by cww_pack_in_place.
+ *
+ * @param limbResult the buffer of cww_limb_count(numberOfZero + positionOfOneSize) limbs, NULL in byte mode.
+ * @param byteResult the buffer of cww_byte_count(numberOfZero + positionOfOneSize) bytes, NULL in limb mode.
+ * @param numberOfZero the number of 0s in the constant-weight word.
+ * @param positionOfOne the positions where the 1s will go.
+ * @param positionOfOneSize the number of 1s.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+static void cww_pack_with_workspace(uint64_t *limbResult, unsigned char *byteResult, int numberOfZero, const int *positionOfOne, size_t positionOfOneSize, Arena *arena, short parallel) {
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+
+    /// The ordered positions in which to insert the 1s.
+    int *sortedPositionOfOne = arena_alloc(arena, positionOfOneSize * sizeof(int));
+
+    if (positionOfOneSize) {
+        memcpy(sortedPositionOfOne, positionOfOne, positionOfOneSize * sizeof *sortedPositionOfOne);
+    }
+
+    cww_pack_in_place(limbResult, byteResult, numberOfZero, sortedPositionOfOne, positionOfOneSize, arena, parallel);
+
+    arena_release(arena, arenaMark);
+}
+
+/**
+ * Function that creates a constant-weight word packed in 64-bit limbs, without allocating memory.
+ *
+ * @warning The arena must have room for cww_workspace_size(numberOfZero, positionOfOneSize) bytes.
+ *
+ * @details The bit i of the word is the bit i % 64 of the limb i / 64, the bits of the last limb past the end of the word are 0.
+ *
+ * @param result the buffer of cww_limb_count(numberOfZero + positionOfOneSize) limbs.
+ * @param numberOfZero the number of 0s in the constant-weight word.
+ * @param positionOfOne the positions where the 1s will go.
+ * @param positionOfOneSize the number of 1s.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_packed_with_workspace(uint64_t *result, int numberOfZero, const int *positionOfOne, size_t positionOfOneSize, Arena *arena, short parallel) {
+    cww_pack_with_workspace(result, NULL, numberOfZero, positionOfOne, positionOfOneSize, arena, parallel);
+}
+
+/**
+ * Function that creates a constant-weight word packed in little-endian bytes, without allocating memory.
+ *
+ * @warning The arena must have room for cww_workspace_size(numberOfZero, positionOfOneSize) bytes.
+ *
+ * @details The bit i of the word is the bit i % 8 of the byte i / 8, the bits of the last byte past the end of the word are 0.
+ *
+ * @param result the buffer of cww_byte_count(numberOfZero + positionOfOneSize) bytes.
+ * @param numberOfZero the number of 0s in the constant-weight word.
+ * @param positionOfOne the positions where the 1s will go.
+ * @param positionOfOneSize the number of 1s.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_bytes_with_workspace(unsigned char *result, int numberOfZero, const int *positionOfOne, size_t positionOfOneSize, Arena *arena, short parallel) {
+    cww_pack_with_workspace(NULL, result, numberOfZero, positionOfOne, positionOfOneSize, arena, parallel);
+}
+
+/**
+ * Function that creates a constant-weight word packed in 64-bit limbs.
+ *
+ * @param result the buffer of cww_limb_count(numberOfZero + positionOfOne->listSize) limbs.
+ * @param numberOfZero the number of 0s in the constant-weight word.
+ * @param positionOfOne the list of positions where the 1s will go.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_packed(uint64_t *result, int numberOfZero, const IntList *positionOfOne, short parallel) {
+    /// The size of the scratch memory.
+    size_t workspaceSize = cww_workspace_size((size_t) numberOfZero, positionOfOne->listSize);
+
+    /// The scratch memory of the constant-weight word.
+    void *workspace = arena_workspace_alloc(workspaceSize);
+    /// The arena over the scratch memory.
+    Arena arena;
+    arena_init(&arena, workspace, workspaceSize);
+
+    cww_packed_with_workspace(result, numberOfZero, positionOfOne->list, positionOfOne->listSize, &arena, parallel);
+
+    arena_workspace_free(workspace, workspaceSize);
+}
+
+/**
+ * Function that creates a constant-weight word packed in little-endian bytes.
+ *
+ * @param result the buffer of cww_byte_count(numberOfZero + positionOfOne->listSize) bytes.
+ * @param numberOfZero the number of 0s in the constant-weight word.
+ * @param positionOfOne the list of positions where the 1s will go.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_bytes(unsigned char *result, int numberOfZero, const IntList *positionOfOne, short parallel) {
+    /// The size of the scratch memory.
+    size_t workspaceSize = cww_workspace_size((size_t) numberOfZero, positionOfOne->listSize);
+
+    /// The scratch memory of the constant-weight word.
+    void *workspace = arena_workspace_alloc(workspaceSize);
+    /// The arena over the scratch memory.
+    Arena arena;
+    arena_init(&arena, workspace, workspaceSize);
+
+    cww_bytes_with_workspace(result, numberOfZero, positionOfOne->list, positionOfOne->listSize, &arena, parallel);
+
+    arena_workspace_free(workspace, workspaceSize);
+}
+
+
+/**
+ * Function that computes the scratch bytes needed by the dense constant-weight words.
+ *
+ * @note The size depends on the maximum number of OpenMP threads at the time of the call.
+ *
+ * @param numberOfZero the number of 0s in the constant-weight word.
+ * @param numberOfOne the number of 1s in the constant-weight word.
+ * @return the bytes to reserve in the arena.
+ */
+size_t cww_dense_workspace_size(size_t numberOfZero, size_t numberOfOne) {
+    return numberOfOne > numberOfZero ? cww_workspace_size(numberOfOne, numberOfZero) : cww_workspace_size(numberOfZero, numberOfOne);
+}
+
+/**
+ * Function that creates a constant-weight word from the positions of its minority bit, without allocating memory.
+ *
+ * @warning The arena must have room for cww_dense_workspace_size(numberOfZero, numberOfOne) bytes.
+ *
+ * @details The input is always the insertion series of the bit that appears fewer times, so the positions are sorted on the smaller side:
+ * - if numberOfOne <= numberOfZero, position holds numberOfOne entries, position[i] in [0, numberOfZero + i], and the 1s are inserted in a word of numberOfZero 0s, as in cww_with_workspace;
+ * - otherwise position holds numberOfZero entries, position[i] in [0, numberOfOne + i], and the 0s are inserted in a word of numberOfOne 1s: the word of the exchanged problem is built, then its bits are inverted.
+ * @details Uniform positions give a uniform word in both cases. The side only depends on the sizes, so the construction is constant-time.
+ *
+ * @param result the buffer that will contain the numberOfZero + numberOfOne bits of the word.
+ * @param numberOfZero the number of 0s in the constant-weight word.
+ * @param numberOfOne the number of 1s in the constant-weight word.
+ * @param position the positions where the minority bits will go.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_dense_with_workspace(int *result, int numberOfZero, int numberOfOne, const int *position, Arena *arena, short parallel) {
+    /// The size of the word.
+    size_t resultSize = (size_t) numberOfZero + (size_t) numberOfOne;
+
+    if (numberOfOne <= numberOfZero) {
+        cww_with_workspace(result, numberOfZero, position, (size_t) numberOfOne, arena, parallel);
+        return;
+    }
+
+    cww_with_workspace(result, numberOfOne, position, (size_t) numberOfZero, arena, parallel);
+
+#pragma omp parallel for schedule(static) if(parallel && resultSize >= PREFIX_SUM_PARALLEL_CUTOFF)
+    for (size_t i = 0; i < resultSize; ++i) {
+        result[i] ^= 1;
+    }
+}
+
+/**
+ * Function that creates a packed constant-weight word from the positions of its minority bit, without allocating memory.
+ *
+ * @warning The arena must have room for cww_dense_workspace_size(numberOfZero, numberOfOne) bytes.
+ *
+ * @details The input is the same of cww_dense_with_workspace, the word is packed as in cww_packed_with_workspace or cww_bytes_with_workspace.
+ * @details When the bits are inverted, the padding bits of the last limb or byte are kept at 0.
+ *
+ * @param limbResult the buffer of cww_limb_count(numberOfZero + numberOfOne) limbs, NULL in byte mode.
+ * @param byteResult the buffer of cww_byte_count(numberOfZero + numberOfOne) bytes, NULL in limb mode.
+ * @param numberOfZero the number of 0s in the constant-weight word.
+ * @param numberOfOne the number of 1s in the constant-weight word.
+ * @param position the positions where the minority bits will go.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+static void cww_dense_pack_with_workspace(uint64_t *limbResult, unsigned char *byteResult, int numberOfZero, int numberOfOne, const int *position, Arena *arena, short parallel) {
+    /// The size of the word.
+    size_t resultSize = (size_t) numberOfZero + (size_t) numberOfOne;
+
+    if (numberOfOne <= numberOfZero) {
+        cww_pack_with_workspace(limbResult, byteResult, numberOfZero, position, (size_t) numberOfOne, arena, parallel);
+        return;
+    }
+
+    cww_pack_with_workspace(limbResult, byteResult, numberOfOne, position, (size_t) numberOfZero, arena, parallel);
+
+    if (limbResult) {
+        for (size_t j = 0; j < cww_limb_count(resultSize); ++j) {
+            /// The bits of the limb inside the word.
+            uint64_t wordBits = resultSize - 64 * j >= 64 ? ~(uint64_t) 0 : ((uint64_t) 1 << (resultSize - 64 * j)) - 1;
+
+            limbResult[j] ^= wordBits;
+        }
+    }
+    else {
+        for (size_t k = 0; k < cww_byte_count(resultSize); ++k) {
+            /// The bits of the byte inside the word.
+            unsigned char wordBits = resultSize - 8 * k >= 8 ? 0xFF : (unsigned char) ((1u << (resultSize - 8 * k)) - 1);
+
+            byteResult[k] ^= wordBits;
+        }
+    }
+}
+
+/**
+ * Function that creates a constant-weight word packed in 64-bit limbs from the positions of its minority bit, without allocating memory.
+ *
+ * @warning The arena must have room for cww_dense_workspace_size(numberOfZero, numberOfOne) bytes.
+ *
+ * @param result the buffer of cww_limb_count(numberOfZero + numberOfOne) limbs.
+ * @param numberOfZero the number of 0s in the constant-weight word.
+ * @param numberOfOne the number of 1s in the constant-weight word.
+ * @param position the positions where the minority bits will go, see cww_dense_with_workspace.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_dense_packed_with_workspace(uint64_t *result, int numberOfZero, int numberOfOne, const int *position, Arena *arena, short parallel) {
+    cww_dense_pack_with_workspace(result, NULL, numberOfZero, numberOfOne, position, arena, parallel);
+}
+
+/**
+ * Function that creates a constant-weight word packed in little-endian bytes from the positions of its minority bit, without allocating memory.
+ *
+ * @warning The arena must have room for cww_dense_workspace_size(numberOfZero, numberOfOne) bytes.
+ *
+ * @param result the buffer of cww_byte_count(numberOfZero + numberOfOne) bytes.
+ * @param numberOfZero the number of 0s in the constant-weight word.
+ * @param numberOfOne the number of 1s in the constant-weight word.
+ * @param position the positions where the minority bits will go, see cww_dense_with_workspace.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_dense_bytes_with_workspace(unsigned char *result, int numberOfZero, int numberOfOne, const int *position, Arena *arena, short parallel) {
+    cww_dense_pack_with_workspace(NULL, result, numberOfZero, numberOfOne, position, arena, parallel);
+}
+
+/**
+ * Function that creates a constant-weight word from the positions of its minority bit.
+ *
+ * @param numberOfZero the number of 0s in the constant-weight word.
+ * @param numberOfOne the number of 1s in the constant-weight word.
+ * @param position the list of min(numberOfZero, numberOfOne) positions where the minority bits will go, see cww_dense_with_workspace.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ * @return the constant-weight word.
+ */
+IntList cww_dense(int numberOfZero, int numberOfOne, const IntList *position, short parallel) {
+    /// The size of the scratch memory.
+    size_t workspaceSize = cww_dense_workspace_size((size_t) numberOfZero, (size_t) numberOfOne);
+
+    /// The scratch memory of the constant-weight word.
+    void *workspace = arena_workspace_alloc(workspaceSize);
+    /// The arena over the scratch memory.
+    Arena arena;
+    arena_init(&arena, workspace, workspaceSize);
+
+    /// The cww created.
+    IntList result;
+    intlist_init(&result);
+    intlist_reserve(&result, (size_t) numberOfZero + (size_t) numberOfOne);
+    result.listSize = (size_t) numberOfZero + (size_t) numberOfOne;
+
+    cww_dense_with_workspace(result.list, numberOfZero, numberOfOne, position->list, &arena, parallel);
+
+    arena_workspace_free(workspace, workspaceSize);
+
+    return result;
+}
+
+
+/**
+ * Function that computes the scratch bytes needed by the ternary constant-weight words.
+ *
+ * @note The size depends on the maximum number of OpenMP threads at the time of the call.
+ *
+ * @param numberOfZero the number of 0s in the ternary word.
+ * @param numberOfNonZero the number of 1s and -1s in the ternary word.
+ * @return the bytes to reserve in the arena.
+ */
+size_t cww_ternary_workspace_size(size_t numberOfZero, size_t numberOfNonZero) {
+    /// The bytes needed while the positions are sorted.
+    size_t sortSize = cww_sort_mergepos_workspace_size(numberOfNonZero);
+    /// The bytes needed while the word is merged.
+    size_t mergeSize = arena_size((numberOfZero + numberOfNonZero) * sizeof(SortKey));
+
+    return 2 * arena_size(numberOfNonZero * sizeof(int))      // positions and signs of the non-zeros
+         + (sortSize > mergeSize ? sortSize : mergeSize);
+}
+
+/**
+ * Function that sorts the positions of the 1s and of the -1s of a ternary word, keeping their signs.
+ *
+ * @warning The arena must have room for cww_sort_mergepos_workspace_size(numberOfPlusOne + numberOfMinusOne) bytes.
+ *
+ * @details The last step of the recursion splits the positions at numberOfPlusOne: the 1s and the -1s are sorted separately, then merged as in cww_sort_mergepos_into.
+ * @details In the last merge the fromLeft of each key tells whether the position is a 1, so the signs come out of the same network that sorts the positions.
+ *
+ * @param position the numberOfPlusOne positions of the 1s followed by the numberOfMinusOne positions of the -1s, sorted in place.
+ * @param negative the buffer that will contain, for each sorted position, 1 if it is a -1, 0 if it is a 1.
+ * @param numberOfPlusOne the number of 1s.
+ * @param numberOfMinusOne the number of -1s.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_ternary_sort_into(int *position, int *negative, size_t numberOfPlusOne, size_t numberOfMinusOne, Arena *arena, short parallel) {
+    /// The number of non-zeros.
+    size_t positionSize = numberOfPlusOne + numberOfMinusOne;
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+
+    cww_sort_recursive_into(position, numberOfPlusOne, arena, parallel);
+    cww_sort_recursive_into(position + numberOfPlusOne, numberOfMinusOne, arena, parallel);
+
+    /// The position keys.
+    PositionKey *key = arena_alloc(arena, positionSize * sizeof(PositionKey));
+    /// 1 if the merging network expects the first list in descending order.
+    short reversedFirstRun = mergeNetwork->reversedFirstRun;
+
+    for (size_t i = 0; i < numberOfPlusOne; ++i) {
+        key[reversedFirstRun ? numberOfPlusOne - 1 - i : i] = packPositionKey(position[i], 1);
+    }
+
+    for (size_t j = 0; j < numberOfMinusOne; ++j) {
+        key[numberOfPlusOne + j] = packPositionKey(position[numberOfPlusOne + j] - (int)j, 0);
+    }
+
+    STATS_PHASE_BEGIN(STATS_PHASE_NETWORK);
+    mergeNetwork->mergePositionRuns(key, numberOfPlusOne, numberOfMinusOne, parallel);
+    STATS_PHASE_END(STATS_PHASE_NETWORK);
+
+    cww_emit_merged(position, key, positionSize, arena, parallel);
+
+    // the -1s are the positions that do not come from the list of 1s
+    for (size_t i = 0; i < positionSize; ++i) {
+        negative[i] = 1 - positionKeyFromLeft(key[i]);
+    }
+
+    arena_release(arena, arenaMark);
+}
+
+/**
+ * Function that inserts the signed non-zeros in a word of 0s and writes the ternary word.
+ *
+ * @warning The arena must have room for arena_size((numberOfZero + positionSize) * sizeof(SortKey)) bytes.
+ *
+ * @details The merge is the one of cww_sort_mergebits_keys, on 64-bit keys: the indexInItsList of a non-zero is (j << 1) | negative[j],
+ * so the non-zeros that tie on their normalized position stay in the order of j, and each one carries its sign through the network.
+ * @details The word is written in the same sweep that reads the merged keys: (1 - fromLeft) * (1 - 2 * negative), or in packed mode the 2-bit code (1 - fromLeft) | negative << 1.
+ *
+ * @param result the buffer of numberOfZero + positionSize trits, NULL in packed mode.
+ * @param packedResult the buffer of (numberOfZero + positionSize + 3) / 4 bytes, NULL in int8 mode.
+ * @param numberOfZero the number of 0s.
+ * @param position the sorted final positions of the non-zeros.
+ * @param negative for each position, 1 if it is a -1, 0 if it is a 1.
+ * @param positionSize the number of non-zeros.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+static void cww_ternary_merge(int8_t *result, unsigned char *packedResult, int numberOfZero, const int *position, const int *negative, size_t positionSize, Arena *arena, short parallel) {
+    /// The size of the word.
+    size_t resultSize = (size_t) numberOfZero + positionSize;
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+
+    /// The packed keys.
+    SortKey *key = arena_alloc(arena, resultSize * sizeof(SortKey));
+    /// The network only moves the keys.
+    QuadrupleArray keyWorkspace = {key, NULL, resultSize};
+    /// 1 if the merging network expects the first list in descending order.
+    short reversedFirstRun = mergeNetwork->reversedFirstRun;
+
+#pragma omp parallel if(parallel && resultSize >= PREFIX_SUM_PARALLEL_CUTOFF)
+    {
+#pragma omp for schedule(static) nowait
+        for (int i = 0; i < numberOfZero; ++i) {
+            key[reversedFirstRun ? numberOfZero - 1 - i : i] = packSortKey(i, 1, 0);
+        }
+
+#pragma omp for schedule(static) nowait
+        for (size_t j = 0; j < positionSize; ++j) {
+            key[(size_t) numberOfZero + j] = packSortKey(position[j] - (int)j, 0, (int) (j << 1) | negative[j]);
+        }
+    }
+
+    STATS_PHASE_BEGIN(STATS_PHASE_NETWORK);
+    mergeNetwork->mergeRuns(&keyWorkspace, (size_t) numberOfZero, positionSize, parallel);
+    STATS_PHASE_END(STATS_PHASE_NETWORK);
+
+    if (result) {
+#pragma omp parallel for schedule(static) if(parallel && resultSize >= PREFIX_SUM_PARALLEL_CUTOFF)
+        for (size_t i = 0; i < resultSize; ++i) {
+            /// 1 if the trit is not 0.
+            int nonZero = 1 - sortKeyFromLeft(key[i]);
+
+            result[i] = (int8_t) (nonZero - 2 * (int) (key[i] & 1));
+        }
+    }
+    else {
+        /// The number of bytes of the packed word.
+        size_t byteCount = (resultSize + 3) / 4;
+
+#pragma omp parallel for schedule(static) if(parallel && resultSize >= PREFIX_SUM_PARALLEL_CUTOFF)
+        for (size_t k = 0; k < byteCount; ++k) {
+            /// The four trits of the byte.
+            unsigned int packedTrits = 0;
+
+            for (size_t r = 0; r < 4 && 4 * k + r < resultSize; ++r) {
+                /// The merged key of the trit.
+                SortKey trit = key[4 * k + r];
+
+                packedTrits |= ((unsigned int) (1 - sortKeyFromLeft(trit)) | (unsigned int) (trit & 1) << 1) << (2 * r);
+            }
+
+            packedResult[k] = (unsigned char) packedTrits;
+        }
+    }
+
+    arena_release(arena, arenaMark);
+}
+
+/**
+ * Function that creates a ternary word with fixed numbers of 1s and -1s.
+ *
+ * @details See cww_ternary_with_workspace and cww_ternary_packed_with_workspace.
+ *
+ * @param result the buffer of trits, NULL in packed mode.
+ * @param packedResult the buffer of packed trits, NULL in int8 mode.
+ * @param numberOfZero the number of 0s.
+ * @param position the positions where the non-zeros will go.
+ * @param numberOfPlusOne the number of 1s.
+ * @param numberOfMinusOne the number of -1s.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+static void cww_ternary_fixed(int8_t *result, unsigned char *packedResult, int numberOfZero, const int *position, size_t numberOfPlusOne, size_t numberOfMinusOne, Arena *arena, short parallel) {
+    /// The number of non-zeros.
+    size_t positionSize = numberOfPlusOne + numberOfMinusOne;
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+
+    /// The sorted positions of the non-zeros.
+    int *sortedPosition = arena_alloc(arena, positionSize * sizeof(int));
+    /// The signs of the sorted positions.
+    int *negative = arena_alloc(arena, positionSize * sizeof(int));
+
+    if (positionSize) {
+        memcpy(sortedPosition, position, positionSize * sizeof *sortedPosition);
+    }
+
+    cww_ternary_sort_into(sortedPosition, negative, numberOfPlusOne, numberOfMinusOne, arena, parallel);
+    cww_ternary_merge(result, packedResult, numberOfZero, sortedPosition, negative, positionSize, arena, parallel);
+
+    arena_release(arena, arenaMark);
+}
+
+/**
+ * Function that creates a ternary word with random signs.
+ *
+ * @details See cww_ternary_random_sign_with_workspace and cww_ternary_random_sign_packed_with_workspace.
+ *
+ * @param result the buffer of trits, NULL in packed mode.
+ * @param packedResult the buffer of packed trits, NULL in int8 mode.
+ * @param numberOfZero the number of 0s.
+ * @param position the positions where the non-zeros will go.
+ * @param positionSize the number of non-zeros.
+ * @param signBits the signs of the non-zeros.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+static void cww_ternary_random(int8_t *result, unsigned char *packedResult, int numberOfZero, const int *position, size_t positionSize, const unsigned char *signBits, Arena *arena, short parallel) {
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+
+    /// The sorted positions of the non-zeros.
+    int *sortedPosition = arena_alloc(arena, positionSize * sizeof(int));
+    /// The signs of the sorted positions.
+    int *negative = arena_alloc(arena, positionSize * sizeof(int));
+
+    if (positionSize) {
+        memcpy(sortedPosition, position, positionSize * sizeof *sortedPosition);
+    }
+
+    cww_sort_recursive_into(sortedPosition, positionSize, arena, parallel);
+
+    for (size_t j = 0; j < positionSize; ++j) {
+        negative[j] = (signBits[j / 8] >> (j % 8)) & 1;
+    }
+
+    cww_ternary_merge(result, packedResult, numberOfZero, sortedPosition, negative, positionSize, arena, parallel);
+
+    arena_release(arena, arenaMark);
+}
+
+/**
+ * Function that creates a ternary word with fixed numbers of 1s and -1s, without allocating memory.
+ *
+ * @warning The arena must have room for cww_ternary_workspace_size(numberOfZero, numberOfPlusOne + numberOfMinusOne) bytes.
+ *
+ * @details The input is the insertion series of the non-zeros in a word of numberOfZero 0s: first numberOfPlusOne 1s, then numberOfMinusOne -1s, position[i] in [0, numberOfZero + i].
+ * @details Uniform positions give a uniform ternary word with exactly numberOfPlusOne 1s and numberOfMinusOne -1s, see cww_ternary_sort_into and cww_ternary_merge: no pass over the word other than the final merge.
+ *
+ * @param result the buffer of numberOfZero + numberOfPlusOne + numberOfMinusOne trits.
+ * @param numberOfZero the number of 0s.
+ * @param position the positions where the non-zeros will go.
+ * @param numberOfPlusOne the number of 1s.
+ * @param numberOfMinusOne the number of -1s.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_ternary_with_workspace(int8_t *result, int numberOfZero, const int *position, size_t numberOfPlusOne, size_t numberOfMinusOne, Arena *arena, short parallel) {
+    cww_ternary_fixed(result, NULL, numberOfZero, position, numberOfPlusOne, numberOfMinusOne, arena, parallel);
+}
+
+/**
+ * Function that creates a ternary word with fixed numbers of 1s and -1s packed in 2 bits per trit, without allocating memory.
+ *
+ * @warning The arena must have room for cww_ternary_workspace_size(numberOfZero, numberOfPlusOne + numberOfMinusOne) bytes.
+ *
+ * @details The input is the same of cww_ternary_with_workspace.
+ * @details The trit i is stored in the bits 2 * (i % 4) and 2 * (i % 4) + 1 of the byte i / 4: 00 for 0, 01 for 1, 11 for -1; the padding bits of the last byte are 0.
+ *
+ * @param result the buffer of (numberOfZero + numberOfPlusOne + numberOfMinusOne + 3) / 4 bytes.
+ * @param numberOfZero the number of 0s.
+ * @param position the positions where the non-zeros will go.
+ * @param numberOfPlusOne the number of 1s.
+ * @param numberOfMinusOne the number of -1s.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_ternary_packed_with_workspace(unsigned char *result, int numberOfZero, const int *position, size_t numberOfPlusOne, size_t numberOfMinusOne, Arena *arena, short parallel) {
+    cww_ternary_fixed(NULL, result, numberOfZero, position, numberOfPlusOne, numberOfMinusOne, arena, parallel);
+}
+
+/**
+ * Function that creates a ternary word with random signs, without allocating memory.
+ *
+ * @warning The arena must have room for cww_ternary_workspace_size(numberOfZero, positionSize) bytes.
+ *
+ * @details The positions are sorted as in cww_with_workspace, then the j-th sorted non-zero takes the sign of the bit j of signBits: 1 for -1, 0 for 1.
+ * @details The signs do not follow the positions through the sort, but independent uniform signs are still uniform after any permutation, so uniform inputs give a uniform ternary word of weight positionSize.
+ *
+ * @param result the buffer of numberOfZero + positionSize trits.
+ * @param numberOfZero the number of 0s.
+ * @param position the positions where the non-zeros will go, position[i] in [0, numberOfZero + i].
+ * @param positionSize the number of non-zeros.
+ * @param signBits the cww_byte_count(positionSize) bytes of the signs, the bit j is the bit j % 8 of the byte j / 8.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_ternary_random_sign_with_workspace(int8_t *result, int numberOfZero, const int *position, size_t positionSize, const unsigned char *signBits, Arena *arena, short parallel) {
+    cww_ternary_random(result, NULL, numberOfZero, position, positionSize, signBits, arena, parallel);
+}
+
+/**
+ * Function that creates a ternary word with random signs packed in 2 bits per trit, without allocating memory.
+ *
+ * @warning The arena must have room for cww_ternary_workspace_size(numberOfZero, positionSize) bytes.
+ *
+ * @details The input is the same of cww_ternary_random_sign_with_workspace, the output the same of cww_ternary_packed_with_workspace.
+ *
+ * @param result the buffer of (numberOfZero + positionSize + 3) / 4 bytes.
+ * @param numberOfZero the number of 0s.
+ * @param position the positions where the non-zeros will go, position[i] in [0, numberOfZero + i].
+ * @param positionSize the number of non-zeros.
+ * @param signBits the cww_byte_count(positionSize) bytes of the signs.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_ternary_random_sign_packed_with_workspace(unsigned char *result, int numberOfZero, const int *position, size_t positionSize, const unsigned char *signBits, Arena *arena, short parallel) {
+    cww_ternary_random(NULL, result, numberOfZero, position, positionSize, signBits, arena, parallel);
+}
+
+/**
+ * Function that creates a ternary word with fixed numbers of 1s and -1s.
+ *
+ * @warning numberOfPlusOne must not exceed the size of the list.
+ *
+ * @param result the buffer of numberOfZero + position->listSize trits.
+ * @param numberOfZero the number of 0s.
+ * @param position the list of positions where the non-zeros will go, see cww_ternary_with_workspace.
+ * @param numberOfPlusOne the number of 1s, the first ones of the list, the others are -1s.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_ternary(int8_t *result, int numberOfZero, const IntList *position, size_t numberOfPlusOne, short parallel) {
+    assert(numberOfPlusOne <= position->listSize && "More 1s than positions!!!");
+
+    /// The size of the scratch memory.
+    size_t workspaceSize = cww_ternary_workspace_size((size_t) numberOfZero, position->listSize);
+
+    /// The scratch memory of the ternary word.
+    void *workspace = arena_workspace_alloc(workspaceSize);
+    /// The arena over the scratch memory.
+    Arena arena;
+    arena_init(&arena, workspace, workspaceSize);
+
+    cww_ternary_with_workspace(result, numberOfZero, position->list, numberOfPlusOne, position->listSize - numberOfPlusOne, &arena, parallel);
+
+    arena_workspace_free(workspace, workspaceSize);
+}
+
+/**
+ * Function that creates a ternary word with random signs.
+ *
+ * @param result the buffer of numberOfZero + position->listSize trits.
+ * @param numberOfZero the number of 0s.
+ * @param position the list of positions where the non-zeros will go.
+ * @param signBits the signs of the non-zeros, see cww_ternary_random_sign_with_workspace.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_ternary_random_sign(int8_t *result, int numberOfZero, const IntList *position, const unsigned char *signBits, short parallel) {
+    /// The size of the scratch memory.
+    size_t workspaceSize = cww_ternary_workspace_size((size_t) numberOfZero, position->listSize);
+
+    /// The scratch memory of the ternary word.
+    void *workspace = arena_workspace_alloc(workspaceSize);
+    /// The arena over the scratch memory.
+    Arena arena;
+    arena_init(&arena, workspace, workspaceSize);
+
+    cww_ternary_random_sign_with_workspace(result, numberOfZero, position->list, position->listSize, signBits, &arena, parallel);
+
+    arena_workspace_free(workspace, workspaceSize);
+}
+
+
+/**
+ * Function that computes the scratch bytes needed by the constant-weight words sampled from a byte source.
+ *
+ * @note The size depends on the maximum number of OpenMP threads at the time of the call.
+ *
+ * @param numberOfZero the number of 0s in the constant-weight word.
+ * @param numberOfOne the number of 1s in the constant-weight word.
+ * @return the bytes to reserve in the arena.
+ */
+size_t cww_from_source_workspace_size(size_t numberOfZero, size_t numberOfOne) {
+    /// The bytes needed by the random stream of the positions.
+    size_t sampleSize = arena_size(numberOfOne * SAMPLE_RANDOM_BYTES);
+    /// The bytes needed while the word is built.
+    size_t wordSize = cww_in_place_workspace_size(numberOfZero, numberOfOne);
+
+    return arena_size(numberOfOne * sizeof(int)) + (sampleSize > wordSize ? sampleSize : wordSize);
+}
+
+/**
+ * Function that samples the positions of the 1s of a constant-weight word from a byte source.
+ *
+ * @details The whole random stream is drawn in one call, then every position is reduced in a single batch:
+ * position[i] is the product of 8 random bytes with numberOfZero + i + 1, shifted right by 64 bits, so it lies in [0, numberOfZero + i].
+ * @details There is no rejection, so the time does not depend on the random bytes; the bias of each position is below (numberOfZero + i + 1) / 2^64.
+ *
+ * @param position the buffer that will contain the positionSize positions.
+ * @param numberOfZero the number of 0s in the constant-weight word.
+ * @param positionSize the number of positions.
+ * @param source the source of the random bytes.
+ * @param arena the arena of the scratch buffers.
+ */
+void cww_sample_positions(int *position, int numberOfZero, size_t positionSize, ByteSource *source, Arena *arena) {
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+
+    /// The random stream of the positions.
+    unsigned char *random = arena_alloc(arena, positionSize * SAMPLE_RANDOM_BYTES);
+
+    source->generate(source->state, random, positionSize * SAMPLE_RANDOM_BYTES);
+    multiplyShiftRange(position, random, positionSize, (uint32_t) numberOfZero + 1);
+
+    arena_release(arena, arenaMark);
+}
+
+/**
+ * Function that creates a constant-weight word from a byte source, without allocating memory.
+ *
+ * @warning The arena must have room for cww_from_source_workspace_size(numberOfZero, numberOfOne) bytes.
+ *
+ * @details The positions are sampled in the arena and sorted where they are, so nothing is copied between the sampling and the sort.
+ *
+ * @param result the buffer that will contain the numberOfZero + numberOfOne bits of the word.
+ * @param numberOfZero the number of 0s in the constant-weight word.
+ * @param numberOfOne the number of 1s in the constant-weight word.
+ * @param source the source of the random bytes.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_from_source_with_workspace(int *result, int numberOfZero, size_t numberOfOne, ByteSource *source, Arena *arena, short parallel) {
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+
+    /// The positions in which to insert the 1s.
+    int *positionOfOne = arena_alloc(arena, numberOfOne * sizeof(int));
+
+    cww_sample_positions(positionOfOne, numberOfZero, numberOfOne, source, arena);
+    cww_in_place_with_workspace(result, numberOfZero, positionOfOne, numberOfOne, arena, parallel);
+
+    arena_release(arena, arenaMark);
+}
+
+/**
+ * Function that creates a constant-weight word packed in 64-bit limbs from a byte source, without allocating memory.
+ *
+ * @warning The arena must have room for cww_from_source_workspace_size(numberOfZero, numberOfOne) bytes.
+ *
+ * @param result the buffer of cww_limb_count(numberOfZero + numberOfOne) limbs.
+ * @param numberOfZero the number of 0s in the constant-weight word.
+ * @param numberOfOne the number of 1s in the constant-weight word.
+ * @param source the source of the random bytes.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_packed_from_source_with_workspace(uint64_t *result, int numberOfZero, size_t numberOfOne, ByteSource *source, Arena *arena, short parallel) {
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+
+    /// The positions in which to insert the 1s.
+    int *positionOfOne = arena_alloc(arena, numberOfOne * sizeof(int));
+
+    cww_sample_positions(positionOfOne, numberOfZero, numberOfOne, source, arena);
+    cww_pack_in_place(result, NULL, numberOfZero, positionOfOne, numberOfOne, arena, parallel);
+
+    arena_release(arena, arenaMark);
+}
+
+/**
+ * Function that creates a constant-weight word from a seed.
+ *
+ * @details The positions are sampled from the ChaCha20 keystream with the seed as key, a zero nonce and a zero block counter,
+ * so the same seed always gives the same word.
+ *
+ * @param result the buffer that will contain the numberOfZero + numberOfOne bits of the word, or NULL.
+ * @param packedResult the buffer of cww_limb_count(numberOfZero + numberOfOne) limbs, or NULL.
+ * @param numberOfZero the number of 0s in the constant-weight word.
+ * @param numberOfOne the number of 1s in the constant-weight word.
+ * @param seed the CHACHA20_KEY_SIZE bytes of the seed.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+static void cww_seed(int *result, uint64_t *packedResult, int numberOfZero, size_t numberOfOne, const unsigned char *seed, short parallel) {
+    /// The nonce of the keystream.
+    const unsigned char nonce[CHACHA20_NONCE_SIZE] = {0};
+    /// The keystream of the seed.
+    ChaCha20 chacha;
+    chacha20_init(&chacha, seed, nonce, 0);
+    /// The source over the keystream.
+    ByteSource source = chacha20_source(&chacha);
+
+    /// The size of the scratch memory.
+    size_t workspaceSize = cww_from_source_workspace_size((size_t) numberOfZero, numberOfOne);
+
+    /// The scratch memory of the constant-weight word.
+    void *workspace = arena_workspace_alloc(workspaceSize);
+    /// The arena over the scratch memory.
+    Arena arena;
+    arena_init(&arena, workspace, workspaceSize);
+
+    if (result) {
+        cww_from_source_with_workspace(result, numberOfZero, numberOfOne, &source, &arena, parallel);
+    }
+    else {
+        cww_packed_from_source_with_workspace(packedResult, numberOfZero, numberOfOne, &source, &arena, parallel);
+    }
+
+    arena_workspace_free(workspace, workspaceSize);
+    memset(&chacha, 0, sizeof chacha);
+}
+
+/**
+ * Function that creates a constant-weight word from a seed.
+ *
+ * @param result the buffer that will contain the numberOfZero + numberOfOne bits of the word.
+ * @param numberOfZero the number of 0s in the constant-weight word.
+ * @param numberOfOne the number of 1s in the constant-weight word.
+ * @param seed the CHACHA20_KEY_SIZE bytes of the seed.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_from_seed(int *result, int numberOfZero, size_t numberOfOne, const unsigned char *seed, short parallel) {
+    cww_seed(result, NULL, numberOfZero, numberOfOne, seed, parallel);
+}
+
+/**
+ * Function that creates a constant-weight word packed in 64-bit limbs from a seed.
+ *
+ * @param result the buffer of cww_limb_count(numberOfZero + numberOfOne) limbs.
+ * @param numberOfZero the number of 0s in the constant-weight word.
+ * @param numberOfOne the number of 1s in the constant-weight word.
+ * @param seed the CHACHA20_KEY_SIZE bytes of the seed.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_packed_from_seed(uint64_t *result, int numberOfZero, size_t numberOfOne, const unsigned char *seed, short parallel) {
+    cww_seed(NULL, result, numberOfZero, numberOfOne, seed, parallel);
+}
+
+
+/**
+ * Function that computes the scratch bytes needed by the interleaved constant-weight words.
+ *
+ * @param numberOfZero the number of 0s of each word.
+ * @param numberOfOne the number of 1s of each word.
+ * @param laneNumber the number of words built side by side.
+ * @return the bytes to reserve in the arena.
+ */
+size_t cww_interleaved_workspace_size(size_t numberOfZero, size_t numberOfOne, size_t laneNumber) {
+    /// The bytes needed while the positions of the 1s are sorted.
+    size_t sortSize = arena_size(numberOfOne * laneNumber * sizeof(PositionKey)) + arena_size(laneNumber * sizeof(int));
+    /// The bytes needed while the bits are merged.
+    size_t mergeSize = arena_size(laneNumber * sizeof(uint64_t)) + arena_size((numberOfZero + numberOfOne) * laneNumber * sizeof(PositionKey));
+
+    return arena_size(numberOfOne * laneNumber * sizeof(int)) + (sortSize > mergeSize ? sortSize : mergeSize);
+}
+
+/**
+ * Function that sorts laneNumber interleaved arrays of positions of the same size in place.
+ *
+ * @warning The arena must have room for arena_size(positionSize * laneNumber * sizeof(PositionKey)) + arena_size(laneNumber * sizeof(int)) bytes.
+ *
+ * @details The same bottom-up recursion as cww_sort_recursive_into, with every array in its own lane: the position i of the lane l is position[i * laneNumber + l].
+ * @details The merges use positionBitonicMergeInterleaved, so the comparators are shared by all the lanes, and the keys are built and emitted by loops over the lanes.
+ *
+ * @param position the interleaved arrays of positions to sort.
+ * @param positionSize the size of each array.
+ * @param laneNumber the number of arrays.
+ * @param arena the arena of the scratch buffers.
+ */
+void cww_interleaved_sort_into(int *position, size_t positionSize, size_t laneNumber, Arena *arena) {
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+
+    /// The position keys of a merge.
+    PositionKey *key = arena_alloc(arena, positionSize * laneNumber * sizeof(PositionKey));
+    /// The number of keys of each lane, already emitted, that do not come from the left run.
+    int *rightCount = arena_alloc(arena, laneNumber * sizeof(int));
+
+    for (size_t width = 1; width < positionSize; width *= 2) {
+        for (size_t start = 0; start + width < positionSize; start += 2 * width) {
+            /// The size of the right run, the last one can be shorter.
+            size_t rightSize = positionSize - start - width < width ? positionSize - start - width : width;
+            /// The positions of the two runs.
+            int *run = position + start * laneNumber;
+
+            // the left run in descending order, as the bitonic merge expects
+            for (size_t i = 0; i < width; ++i) {
+                for (size_t lane = 0; lane < laneNumber; ++lane) {
+                    key[(width - 1 - i) * laneNumber + lane] = packPositionKey(run[i * laneNumber + lane], 1);
+                }
+            }
+
+            for (size_t j = 0; j < rightSize; ++j) {
+                for (size_t lane = 0; lane < laneNumber; ++lane) {
+                    key[(width + j) * laneNumber + lane] = packPositionKey(run[(width + j) * laneNumber + lane] - (int) j, 0);
+                }
+            }
+
+            STATS_PHASE_BEGIN(STATS_PHASE_NETWORK);
+            positionBitonicMergeInterleaved(key, width + rightSize, laneNumber);
+            STATS_PHASE_END(STATS_PHASE_NETWORK);
+
+            memset(rightCount, 0, laneNumber * sizeof(int));
+
+            for (size_t i = 0; i < width + rightSize; ++i) {
+                for (size_t lane = 0; lane < laneNumber; ++lane) {
+                    /// The merged key.
+                    PositionKey mergedKey = key[i * laneNumber + lane];
+
+                    run[i * laneNumber + lane] = positionKeyIndex0(mergedKey) + rightCount[lane];
+                    rightCount[lane] += 1 - positionKeyFromLeft(mergedKey);
+                }
+            }
+        }
+    }
+
+    arena_release(arena, arenaMark);
+}
+
+/**
+ * Function that merges the sorted positions of the 1s of laneNumber interleaved words with the 0s.
+ *
+ * @details On return the key i * laneNumber + l does not come from the list of zeros if and only if the bit i of the word l is 1.
+ *
+ * @param key the buffer of (numberOfZero + numberOfOne) * laneNumber position keys.
+ * @param numberOfZero the number of 0s of each word.
+ * @param position the interleaved sorted positions of the 1s.
+ * @param numberOfOne the number of 1s of each word.
+ * @param laneNumber the number of words.
+ */
+static void cww_interleaved_keys(PositionKey *key, int numberOfZero, const int *position, size_t numberOfOne, size_t laneNumber) {
+    // the 0s in descending order, as the bitonic merge expects
+    for (int i = 0; i < numberOfZero; ++i) {
+        for (size_t lane = 0; lane < laneNumber; ++lane) {
+            key[(size_t) (numberOfZero - 1 - i) * laneNumber + lane] = packPositionKey(i, 1);
+        }
+    }
+
+    for (size_t j = 0; j < numberOfOne; ++j) {
+        for (size_t lane = 0; lane < laneNumber; ++lane) {
+            key[((size_t) numberOfZero + j) * laneNumber + lane] = packPositionKey(position[j * laneNumber + lane] - (int) j, 0);
+        }
+    }
+
+    STATS_PHASE_BEGIN(STATS_PHASE_NETWORK);
+    positionBitonicMergeInterleaved(key, (size_t) numberOfZero + numberOfOne, laneNumber);
+    STATS_PHASE_END(STATS_PHASE_NETWORK);
+}
+
+/**
+ * Function that creates laneNumber constant-weight words of the same sizes side by side, without allocating memory.
+ *
+ * @warning The arena must have room for cww_interleaved_workspace_size(numberOfZero, numberOfOne, laneNumber) bytes.
+ *
+ * @details The words are interleaved: the position j of the word l is positionOfOne[j * laneNumber + l] and its bit i is result[i * laneNumber + l].
+ * @details Every comparator of the networks is applied to all the words at once, so small words fill the vectors; with laneNumber = CWW_INTERLEAVE_LANES a stage of AVX-512 handles a comparator of every word per instruction.
+ * @details The words are built serially and their bits are the same of cww_with_workspace with the bitonic network.
+ *
+ * @param result the buffer of (numberOfZero + numberOfOne) * laneNumber interleaved bits.
+ * @param numberOfZero the number of 0s of each word.
+ * @param positionOfOne the interleaved positions of the 1s.
+ * @param numberOfOne the number of 1s of each word.
+ * @param laneNumber the number of words.
+ * @param arena the arena of the scratch buffers.
+ */
+void cww_interleaved_with_workspace(int *result, int numberOfZero, const int *positionOfOne, size_t numberOfOne, size_t laneNumber, Arena *arena) {
+    /// The size of the interleaved words.
+    size_t resultSize = ((size_t) numberOfZero + numberOfOne) * laneNumber;
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+
+    /// The interleaved positions of the 1s, sorted in place.
+    int *position = arena_alloc(arena, numberOfOne * laneNumber * sizeof(int));
+
+    if (numberOfOne) {
+        memcpy(position, positionOfOne, numberOfOne * laneNumber * sizeof *position);
+    }
+
+    cww_interleaved_sort_into(position, numberOfOne, laneNumber, arena);
+
+    /// The position keys.
+    PositionKey *key = arena_alloc(arena, resultSize * sizeof(PositionKey));
+
+    cww_interleaved_keys(key, numberOfZero, position, numberOfOne, laneNumber);
+
+    for (size_t i = 0; i < resultSize; ++i) {
+        result[i] = 1 - positionKeyFromLeft(key[i]);
+    }
+
+    arena_release(arena, arenaMark);
+}
+
+/**
+ * Function that creates laneNumber constant-weight words of the same sizes side by side, packed in 64-bit limbs, without allocating memory.
+ *
+ * @warning The arena must have room for cww_interleaved_workspace_size(numberOfZero, numberOfOne, laneNumber) bytes.
+ *
+ * @details The positions are interleaved as in cww_interleaved_with_workspace, the packed words are not: the word l is result[l * limbCount ... (l + 1) * limbCount - 1].
+ * @details As in cww_packed_with_workspace, up to CWW_PACK_POSITIONS_CUTOFF 1s the limbs are built from the sorted positions, above it from the merged keys.
+ *
+ * @param result the buffer of laneNumber words of cww_limb_count(numberOfZero + numberOfOne) limbs, one after the other.
+ * @param numberOfZero the number of 0s of each word.
+ * @param positionOfOne the interleaved positions of the 1s.
+ * @param numberOfOne the number of 1s of each word.
+ * @param laneNumber the number of words.
+ * @param arena the arena of the scratch buffers.
+ */
+void cww_interleaved_packed_with_workspace(uint64_t *result, int numberOfZero, const int *positionOfOne, size_t numberOfOne, size_t laneNumber, Arena *arena) {
+    /// The size of each word.
+    size_t wordSize = (size_t) numberOfZero + numberOfOne;
+    /// The number of limbs of each word.
+    size_t limbCount = cww_limb_count(wordSize);
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+
+    /// The interleaved positions of the 1s, sorted in place.
+    int *position = arena_alloc(arena, numberOfOne * laneNumber * sizeof(int));
+
+    if (numberOfOne) {
+        memcpy(position, positionOfOne, numberOfOne * laneNumber * sizeof *position);
+    }
+
+    cww_interleaved_sort_into(position, numberOfOne, laneNumber, arena);
+
+    /// The limb of each word being packed.
+    uint64_t *limb = arena_alloc(arena, laneNumber * sizeof(uint64_t));
+
+    if (numberOfOne <= CWW_PACK_POSITIONS_CUTOFF) {
+        // as cww_limb_of_positions, every position of every word is compared with each limb
+        for (size_t limbIndex = 0; limbIndex < limbCount; ++limbIndex) {
+            memset(limb, 0, laneNumber * sizeof(uint64_t));
+
+            for (size_t j = 0; j < numberOfOne; ++j) {
+                for (size_t lane = 0; lane < laneNumber; ++lane) {
+                    /// The bits that differ between the limb of the position and the current one, 0 if they are the same.
+                    uint32_t difference = ((uint32_t) position[j * laneNumber + lane] >> 6) ^ (uint32_t) limbIndex;
+                    /// The mux selector, all bits set if the position is inside the current limb, 0 otherwise.
+                    uint64_t muxSelector = 0 - (uint64_t) ((difference - 1) >> 31);
+
+                    limb[lane] |= muxSelector & ((uint64_t) 1 << (position[j * laneNumber + lane] & 63));
+                }
+            }
+
+            for (size_t lane = 0; lane < laneNumber; ++lane) {
+                result[lane * limbCount + limbIndex] = limb[lane];
+            }
+        }
+    }
+    else {
+        /// The position keys.
+        PositionKey *key = arena_alloc(arena, wordSize * laneNumber * sizeof(PositionKey));
+
+        cww_interleaved_keys(key, numberOfZero, position, numberOfOne, laneNumber);
+
+        for (size_t limbIndex = 0; limbIndex < limbCount; ++limbIndex) {
+            /// The first bit of the limb.
+            size_t first = 64 * limbIndex;
+            /// The bits of the limb, the last one can be shorter.
+            size_t bitCount = wordSize - first < 64 ? wordSize - first : 64;
+
+            memset(limb, 0, laneNumber * sizeof(uint64_t));
+
+            for (size_t bit = 0; bit < bitCount; ++bit) {
+                for (size_t lane = 0; lane < laneNumber; ++lane) {
+                    limb[lane] |= (uint64_t) (1 - positionKeyFromLeft(key[(first + bit) * laneNumber + lane])) << bit;
+                }
+            }
+
+            for (size_t lane = 0; lane < laneNumber; ++lane) {
+                result[lane * limbCount + limbIndex] = limb[lane];
+            }
+        }
+    }
+
+    arena_release(arena, arenaMark);
+}
+
+/**
+ * Function that creates laneNumber constant-weight words of the same sizes side by side.
+ *
+ * @param result the buffer of (numberOfZero + numberOfOne) * laneNumber interleaved bits, see cww_interleaved_with_workspace.
+ * @param numberOfZero the number of 0s of each word.
+ * @param positionOfOne the interleaved positions of the 1s.
+ * @param numberOfOne the number of 1s of each word.
+ * @param laneNumber the number of words.
+ */
+void cww_interleaved(int *result, int numberOfZero, const int *positionOfOne, size_t numberOfOne, size_t laneNumber) {
+    /// The size of the scratch memory.
+    size_t workspaceSize = cww_interleaved_workspace_size((size_t) numberOfZero, numberOfOne, laneNumber);
+
+    /// The scratch memory of the words.
+    void *workspace = arena_workspace_alloc(workspaceSize);
+    /// The arena over the scratch memory.
+    Arena arena;
+    arena_init(&arena, workspace, workspaceSize);
+
+    cww_interleaved_with_workspace(result, numberOfZero, positionOfOne, numberOfOne, laneNumber, &arena);
+
+    arena_workspace_free(workspace, workspaceSize);
+}
+
+
+/// The new type representing a batch of constant-weight words of the same sizes.
+typedef struct {
+    /// The buffer of the words, one integer per bit, or NULL.
+    int *result;
+    /// The buffer of the words packed in 64-bit limbs, or NULL.
+    uint64_t *packedResult;
+    /// The number of 0s of each word.
+    int numberOfZero;
+    /// The positions of the 1s of the words, numberOfOne per word, or NULL.
+    const int *positionOfOne;
+    /// The seeds of the words, CHACHA20_KEY_SIZE bytes per word, or NULL.
+    const unsigned char *seed;
+    /// The number of 1s of each word.
+    size_t numberOfOne;
+    /// The number of words.
+    size_t wordNumber;
+    /// The number of words of each instance of the batch, built side by side.
+    size_t laneNumber;
+} CwwBatch;
+
+/**
+ * Function that computes the number of words of a batch built side by side.
+ *
+ * @param wordSize the size of each word.
+ * @return CWW_INTERLEAVE_LANES for words smaller than CWW_INTERLEAVE_CUTOFF, 1 otherwise.
+ */
+static size_t cww_batch_lane_number(size_t wordSize) {
+    return wordSize < CWW_INTERLEAVE_CUTOFF ? CWW_INTERLEAVE_LANES : 1;
+}
+
+/**
+ * Function that computes the scratch bytes needed by an instance of a batch of constant-weight words.
+ *
+ * @note The size depends on the maximum number of OpenMP threads at the time of the call.
+ *
+ * @param numberOfZero the number of 0s of each word.
+ * @param numberOfOne the number of 1s of each word.
+ * @return the bytes to reserve for each instance, whatever the source of the positions and the output.
+ */
+static size_t cww_batch_instance_workspace_size(size_t numberOfZero, size_t numberOfOne) {
+    /// The number of words of each instance.
+    size_t laneNumber = cww_batch_lane_number(numberOfZero + numberOfOne);
+
+    if (laneNumber == 1) {
+        return cww_from_source_workspace_size(numberOfZero, numberOfOne);
+    }
+
+    /// The bytes needed while the positions of a word are sampled.
+    size_t sampleSize = arena_size(numberOfOne * sizeof(int)) + arena_size(numberOfOne * SAMPLE_RANDOM_BYTES);
+    /// The bytes needed while the words are built.
+    size_t wordSize = arena_size((numberOfZero + numberOfOne) * laneNumber * sizeof(int)) + cww_interleaved_workspace_size(numberOfZero, numberOfOne, laneNumber);
+
+    return arena_size(numberOfOne * laneNumber * sizeof(int)) + (sampleSize > wordSize ? sampleSize : wordSize);
+}
+
+/**
+ * Function that creates the constant-weight words of an instance of a batch.
+ *
+ * @details A single word is built by the functions of one word; several words are built side by side by the interleaved functions,
+ * their positions interleaved in the arena and, for one integer per bit, their bits deinterleaved into the result.
+ *
+ * @param batch the batch.
+ * @param instance the index of the instance in the batch.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+static void cww_batch_instance(const void *batch, size_t instance, Arena *arena, short parallel) {
+    /// The batch of constant-weight words.
+    const CwwBatch *cwwBatch = batch;
+    /// The number of 1s of each word.
+    size_t numberOfOne = cwwBatch->numberOfOne;
+    /// The size of each word.
+    size_t wordSize = (size_t) cwwBatch->numberOfZero + numberOfOne;
+    /// The first word of the instance.
+    size_t firstWord = instance * cwwBatch->laneNumber;
+    /// The number of words of the instance, the last instance can have fewer.
+    size_t laneNumber = cwwBatch->wordNumber - firstWord < cwwBatch->laneNumber ? cwwBatch->wordNumber - firstWord : cwwBatch->laneNumber;
+    /// The nonce of the keystreams.
+    const unsigned char nonce[CHACHA20_NONCE_SIZE] = {0};
+    /// The keystream of the seed of a word.
+    ChaCha20 chacha;
+    /// The source over the keystream.
+    ByteSource source = chacha20_source(&chacha);
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+
+    if (cwwBatch->laneNumber == 1) {
+        if (cwwBatch->seed) {
+            chacha20_init(&chacha, cwwBatch->seed + firstWord * CHACHA20_KEY_SIZE, nonce, 0);
+
+            if (cwwBatch->result) {
+                cww_from_source_with_workspace(cwwBatch->result + firstWord * wordSize, cwwBatch->numberOfZero, numberOfOne, &source, arena, parallel);
+            }
+            else {
+                cww_packed_from_source_with_workspace(cwwBatch->packedResult + firstWord * cww_limb_count(wordSize), cwwBatch->numberOfZero, numberOfOne, &source, arena, parallel);
+            }
+
+            memset(&chacha, 0, sizeof chacha);
+        }
+        else if (cwwBatch->result) {
+            cww_with_workspace(cwwBatch->result + firstWord * wordSize, cwwBatch->numberOfZero, cwwBatch->positionOfOne + firstWord * numberOfOne, numberOfOne, arena, parallel);
+        }
+        else {
+            cww_pack_with_workspace(cwwBatch->packedResult + firstWord * cww_limb_count(wordSize), NULL, cwwBatch->numberOfZero, cwwBatch->positionOfOne + firstWord * numberOfOne, numberOfOne, arena, parallel);
+        }
+
+        return;
+    }
+
+    /// The interleaved positions of the 1s of the words.
+    int *position = arena_alloc(arena, numberOfOne * laneNumber * sizeof(int));
+
+    for (size_t lane = 0; lane < laneNumber; ++lane) {
+        if (cwwBatch->seed) {
+            /// The position of the arena to restore after the sampling.
+            size_t sampleMark = arena_mark(arena);
+            /// The positions sampled from the seed of the word.
+            int *sampledPosition = arena_alloc(arena, numberOfOne * sizeof(int));
+
+            chacha20_init(&chacha, cwwBatch->seed + (firstWord + lane) * CHACHA20_KEY_SIZE, nonce, 0);
+            cww_sample_positions(sampledPosition, cwwBatch->numberOfZero, numberOfOne, &source, arena);
+
+            for (size_t j = 0; j < numberOfOne; ++j) {
+                position[j * laneNumber + lane] = sampledPosition[j];
+            }
+
+            arena_release(arena, sampleMark);
+        }
+        else {
+            /// The positions of the 1s of the word.
+            const int *wordPosition = cwwBatch->positionOfOne + (firstWord + lane) * numberOfOne;
+
+            for (size_t j = 0; j < numberOfOne; ++j) {
+                position[j * laneNumber + lane] = wordPosition[j];
+            }
+        }
+    }
+
+    if (cwwBatch->result) {
+        /// The interleaved bits of the words.
+        int *bit = arena_alloc(arena, wordSize * laneNumber * sizeof(int));
+        /// The first word of the instance in the result.
+        int *result = cwwBatch->result + firstWord * wordSize;
+
+        cww_interleaved_with_workspace(bit, cwwBatch->numberOfZero, position, numberOfOne, laneNumber, arena);
+
+        for (size_t lane = 0; lane < laneNumber; ++lane) {
+            for (size_t i = 0; i < wordSize; ++i) {
+                result[lane * wordSize + i] = bit[i * laneNumber + lane];
+            }
+        }
+    }
+    else {
+        cww_interleaved_packed_with_workspace(cwwBatch->packedResult + firstWord * cww_limb_count(wordSize), cwwBatch->numberOfZero, position, numberOfOne, laneNumber, arena);
+    }
+
+    memset(&chacha, 0, sizeof chacha);
+    arena_release(arena, arenaMark);
+}
+
+/**
+ * Function that computes the scratch bytes needed by a batch of constant-weight words.
+ *
+ * @note The size depends on the maximum number of OpenMP threads at the time of the call.
+ *
+ * @param numberOfZero the number of 0s of each word.
+ * @param numberOfOne the number of 1s of each word.
+ * @param wordNumber the number of words.
+ * @return the bytes to reserve in the arena.
+ */
+size_t cww_batch_workspace_size(size_t numberOfZero, size_t numberOfOne, size_t wordNumber) {
+    /// The number of words of each instance.
+    size_t laneNumber = cww_batch_lane_number(numberOfZero + numberOfOne);
+
+    return batchWorkspaceSize((wordNumber + laneNumber - 1) / laneNumber, numberOfZero + numberOfOne, cww_batch_instance_workspace_size(numberOfZero, numberOfOne));
+}
+
+/**
+ * Function that runs a batch of constant-weight words.
+ *
+ * @details Words smaller than CWW_INTERLEAVE_CUTOFF are grouped by CWW_INTERLEAVE_LANES and each group is an instance of the batch, see cww_interleaved_with_workspace.
+ *
+ * @param batch the batch, its laneNumber is set here.
+ * @param arena the arena of the scratch buffers, NULL to allocate them.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+static void cww_batch_run(CwwBatch *batch, Arena *arena, short parallel) {
+    /// The size of each word.
+    size_t wordSize = (size_t) batch->numberOfZero + batch->numberOfOne;
+    /// The scratch bytes of each instance.
+    size_t instanceWorkspaceSize = cww_batch_instance_workspace_size((size_t) batch->numberOfZero, batch->numberOfOne);
+
+    batch->laneNumber = cww_batch_lane_number(wordSize);
+
+    /// The number of instances.
+    size_t instanceNumber = (batch->wordNumber + batch->laneNumber - 1) / batch->laneNumber;
+
+    if (arena) {
+        batchRun(cww_batch_instance, batch, instanceNumber, wordSize, instanceWorkspaceSize, arena, parallel);
+
+        return;
+    }
+
+    /// The size of the scratch memory.
+    size_t workspaceSize = batchWorkspaceSize(instanceNumber, wordSize, instanceWorkspaceSize);
+
+    /// The scratch memory of the batch.
+    void *workspace = arena_workspace_alloc(workspaceSize);
+    /// The arena over the scratch memory.
+    Arena batchArena;
+    arena_init(&batchArena, workspace, workspaceSize);
+
+    batchRun(cww_batch_instance, batch, instanceNumber, wordSize, instanceWorkspaceSize, &batchArena, parallel);
+
+    arena_workspace_free(workspace, workspaceSize);
+}
+
+/**
+ * Function that creates a batch of constant-weight words, without allocating memory.
+ *
+ * @warning The arena must have room for cww_batch_workspace_size(numberOfZero, numberOfOne, wordNumber) bytes.
+ *
+ * @details In parallel mode small words are built one group per thread, see batchRun.
+ *
+ * @param result the buffer of wordNumber words of numberOfZero + numberOfOne bits, one after the other.
+ * @param numberOfZero the number of 0s of each word.
+ * @param positionOfOne the positions of the 1s, numberOfOne for each word, one word after the other.
+ * @param numberOfOne the number of 1s of each word.
+ * @param wordNumber the number of words.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_batch_with_workspace(int *result, int numberOfZero, const int *positionOfOne, size_t numberOfOne, size_t wordNumber, Arena *arena, short parallel) {
+    /// The batch of constant-weight words.
+    CwwBatch batch = {result, NULL, numberOfZero, positionOfOne, NULL, numberOfOne, wordNumber, 1};
+
+    cww_batch_run(&batch, arena, parallel);
+}
+
+/**
+ * Function that creates a batch of constant-weight words packed in 64-bit limbs, without allocating memory.
+ *
+ * @warning The arena must have room for cww_batch_workspace_size(numberOfZero, numberOfOne, wordNumber) bytes.
+ *
+ * @param result the buffer of wordNumber words of cww_limb_count(numberOfZero + numberOfOne) limbs, one after the other.
+ * @param numberOfZero the number of 0s of each word.
+ * @param positionOfOne the positions of the 1s, numberOfOne for each word, one word after the other.
+ * @param numberOfOne the number of 1s of each word.
+ * @param wordNumber the number of words.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_packed_batch_with_workspace(uint64_t *result, int numberOfZero, const int *positionOfOne, size_t numberOfOne, size_t wordNumber, Arena *arena, short parallel) {
+    /// The batch of constant-weight words.
+    CwwBatch batch = {NULL, result, numberOfZero, positionOfOne, NULL, numberOfOne, wordNumber, 1};
+
+    cww_batch_run(&batch, arena, parallel);
+}
+
+/**
+ * Function that creates a batch of constant-weight words.
+ *
+ * @param result the buffer of wordNumber words of numberOfZero + numberOfOne bits, one after the other.
+ * @param numberOfZero the number of 0s of each word.
+ * @param positionOfOne the positions of the 1s, numberOfOne for each word, one word after the other.
+ * @param numberOfOne the number of 1s of each word.
+ * @param wordNumber the number of words.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_batch(int *result, int numberOfZero, const int *positionOfOne, size_t numberOfOne, size_t wordNumber, short parallel) {
+    /// The batch of constant-weight words.
+    CwwBatch batch = {result, NULL, numberOfZero, positionOfOne, NULL, numberOfOne, wordNumber, 1};
+
+    cww_batch_run(&batch, NULL, parallel);
+}
+
+/**
+ * Function that creates a batch of constant-weight words packed in 64-bit limbs.
+ *
+ * @param result the buffer of wordNumber words of cww_limb_count(numberOfZero + numberOfOne) limbs, one after the other.
+ * @param numberOfZero the number of 0s of each word.
+ * @param positionOfOne the positions of the 1s, numberOfOne for each word, one word after the other.
+ * @param numberOfOne the number of 1s of each word.
+ * @param wordNumber the number of words.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_packed_batch(uint64_t *result, int numberOfZero, const int *positionOfOne, size_t numberOfOne, size_t wordNumber, short parallel) {
+    /// The batch of constant-weight words.
+    CwwBatch batch = {NULL, result, numberOfZero, positionOfOne, NULL, numberOfOne, wordNumber, 1};
+
+    cww_batch_run(&batch, NULL, parallel);
+}
+
+/**
+ * Function that creates a batch of constant-weight words from their seeds.
+ *
+ * @details The word i is the word of cww_from_seed with the seed i.
+ *
+ * @param result the buffer of wordNumber words of numberOfZero + numberOfOne bits, one after the other.
+ * @param numberOfZero the number of 0s of each word.
+ * @param numberOfOne the number of 1s of each word.
+ * @param seed the seeds, CHACHA20_KEY_SIZE bytes for each word, one word after the other.
+ * @param wordNumber the number of words.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_from_seed_batch(int *result, int numberOfZero, size_t numberOfOne, const unsigned char *seed, size_t wordNumber, short parallel) {
+    /// The batch of constant-weight words.
+    CwwBatch batch = {result, NULL, numberOfZero, NULL, seed, numberOfOne, wordNumber, 1};
+
+    cww_batch_run(&batch, NULL, parallel);
+}
+
+/**
+ * Function that creates a batch of constant-weight words packed in 64-bit limbs from their seeds.
+ *
+ * @param result the buffer of wordNumber words of cww_limb_count(numberOfZero + numberOfOne) limbs, one after the other.
+ * @param numberOfZero the number of 0s of each word.
+ * @param numberOfOne the number of 1s of each word.
+ * @param seed the seeds, CHACHA20_KEY_SIZE bytes for each word, one word after the other.
+ * @param wordNumber the number of words.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void cww_packed_from_seed_batch(uint64_t *result, int numberOfZero, size_t numberOfOne, const unsigned char *seed, size_t wordNumber, short parallel) {
+    /// The batch of constant-weight words.
+    CwwBatch batch = {NULL, result, numberOfZero, NULL, seed, numberOfOne, wordNumber, 1};
+
+    cww_batch_run(&batch, NULL, parallel);
+}
@@ -3,23 +3,92 @@
 
 
 #include <omp.h>
+#include <assert.h>
 #include <stddef.h>
+#include <stdint.h>
 
 
+#include "../utility/batch.h"
+#include "../utility/chacha20.h"
 #include "../utility/intList.h"
 #include "../utility/pairList.h"
+#include "../utility/sampleKernel.h"
 #include "../insertion_series/insertionSeries.h"
 
 
+/// The number of 1s up to which a packed word is built directly from the sorted positions instead of the merged keys.
+#define CWW_PACK_POSITIONS_CUTOFF 192
+/// The number of words built side by side by the interleaved mode, sixteen position keys fill an AVX-512 register.
+#define CWW_INTERLEAVE_LANES 16
+/// The size of the words from which a batch builds them one by one instead of side by side.
+#define CWW_INTERLEAVE_CUTOFF 16384
+
+
 IntList cww_via_insertionseries(int numberOfZero, IntList *positionOfOne, short parallel);
 
 
+size_t cww_sort_mergebits_workspace_size(size_t resultSize);
+void cww_sort_mergebits_keys(PositionKey *key, const int *positionOfZero, size_t positionOfZeroSize, const int *positionOfOne, size_t positionOfOneSize, short parallel);
+void cww_sort_mergebits_into(int *result, const int *positionOfZero, size_t positionOfZeroSize, const int *positionOfOne, size_t positionOfOneSize, Arena *arena, short parallel);
 IntList cww_sort_mergebits(const IntList *positionOfZero, const IntList *positionOfOne, short parallel);
+void cww_emit_merged(int *result, const PositionKey *key, size_t size, Arena *arena, short parallel);
+size_t cww_sort_mergepos_workspace_size(size_t resultSize);
+void cww_sort_mergepos_into(int *result, const int *firstList, size_t firstListSize, const int *secondList, size_t secondListSize, Arena *arena, short parallel);
 IntList cww_sort_mergepos(const IntList *firstList, const IntList *secondList, short parallel);
+size_t cww_sort_blocks(int *intList, size_t intListSize, Arena *arena);
+void cww_sort_level(int *intList, size_t intListSize, size_t width, Arena *arena, short parallel);
+void cww_sort_recursive_into(int *intList, size_t intListSize, Arena *arena, short parallel);
 IntList cww_sort_recursive(const IntList *intList, short parallel);
 
+size_t cww_in_place_workspace_size(size_t numberOfZero, size_t numberOfOne);
+size_t cww_workspace_size(size_t numberOfZero, size_t numberOfOne);
+void cww_in_place_with_workspace(int *result, int numberOfZero, int *positionOfOne, size_t positionOfOneSize, Arena *arena, short parallel);
+void cww_with_workspace(int *result, int numberOfZero, const int *positionOfOne, size_t positionOfOneSize, Arena *arena, short parallel);
 IntList cww_merge_after_sort_recursive(int numberOfZero, IntList *positionOfOne, short parallel);
 
+size_t cww_limb_count(size_t wordSize);
+size_t cww_byte_count(size_t wordSize);
+void cww_packed_with_workspace(uint64_t *result, int numberOfZero, const int *positionOfOne, size_t positionOfOneSize, Arena *arena, short parallel);
+void cww_bytes_with_workspace(unsigned char *result, int numberOfZero, const int *positionOfOne, size_t positionOfOneSize, Arena *arena, short parallel);
+void cww_packed(uint64_t *result, int numberOfZero, const IntList *positionOfOne, short parallel);
+void cww_bytes(unsigned char *result, int numberOfZero, const IntList *positionOfOne, short parallel);
+
+size_t cww_dense_workspace_size(size_t numberOfZero, size_t numberOfOne);
+void cww_dense_with_workspace(int *result, int numberOfZero, int numberOfOne, const int *position, Arena *arena, short parallel);
+void cww_dense_packed_with_workspace(uint64_t *result, int numberOfZero, int numberOfOne, const int *position, Arena *arena, short parallel);
+void cww_dense_bytes_with_workspace(unsigned char *result, int numberOfZero, int numberOfOne, const int *position, Arena *arena, short parallel);
+IntList cww_dense(int numberOfZero, int numberOfOne, const IntList *position, short parallel);
+
+size_t cww_ternary_workspace_size(size_t numberOfZero, size_t numberOfNonZero);
+void cww_ternary_sort_into(int *position, int *negative, size_t numberOfPlusOne, size_t numberOfMinusOne, Arena *arena, short parallel);
+void cww_ternary_with_workspace(int8_t *result, int numberOfZero, const int *position, size_t numberOfPlusOne, size_t numberOfMinusOne, Arena *arena, short parallel);
+void cww_ternary_packed_with_workspace(unsigned char *result, int numberOfZero, const int *position, size_t numberOfPlusOne, size_t numberOfMinusOne, Arena *arena, short parallel);
+void cww_ternary_random_sign_with_workspace(int8_t *result, int numberOfZero, const int *position, size_t positionSize, const unsigned char *signBits, Arena *arena, short parallel);
+void cww_ternary_random_sign_packed_with_workspace(unsigned char *result, int numberOfZero, const int *position, size_t positionSize, const unsigned char *signBits, Arena *arena, short parallel);
+void cww_ternary(int8_t *result, int numberOfZero, const IntList *position, size_t numberOfPlusOne, short parallel);
+void cww_ternary_random_sign(int8_t *result, int numberOfZero, const IntList *position, const unsigned char *signBits, short parallel);
+
+size_t cww_from_source_workspace_size(size_t numberOfZero, size_t numberOfOne);
+void cww_sample_positions(int *position, int numberOfZero, size_t positionSize, ByteSource *source, Arena *arena);
+void cww_from_source_with_workspace(int *result, int numberOfZero, size_t numberOfOne, ByteSource *source, Arena *arena, short parallel);
+void cww_packed_from_source_with_workspace(uint64_t *result, int numberOfZero, size_t numberOfOne, ByteSource *source, Arena *arena, short parallel);
+void cww_from_seed(int *result, int numberOfZero, size_t numberOfOne, const unsigned char *seed, short parallel);
+void cww_packed_from_seed(uint64_t *result, int numberOfZero, size_t numberOfOne, const unsigned char *seed, short parallel);
+
+size_t cww_interleaved_workspace_size(size_t numberOfZero, size_t numberOfOne, size_t laneNumber);
+void cww_interleaved_sort_into(int *position, size_t positionSize, size_t laneNumber, Arena *arena);
+void cww_interleaved_with_workspace(int *result, int numberOfZero, const int *positionOfOne, size_t numberOfOne, size_t laneNumber, Arena *arena);
+void cww_interleaved_packed_with_workspace(uint64_t *result, int numberOfZero, const int *positionOfOne, size_t numberOfOne, size_t laneNumber, Arena *arena);
+void cww_interleaved(int *result, int numberOfZero, const int *positionOfOne, size_t numberOfOne, size_t laneNumber);
+
+size_t cww_batch_workspace_size(size_t numberOfZero, size_t numberOfOne, size_t wordNumber);
+void cww_batch_with_workspace(int *result, int numberOfZero, const int *positionOfOne, size_t numberOfOne, size_t wordNumber, Arena *arena, short parallel);
+void cww_packed_batch_with_workspace(uint64_t *result, int numberOfZero, const int *positionOfOne, size_t numberOfOne, size_t wordNumber, Arena *arena, short parallel);
+void cww_batch(int *result, int numberOfZero, const int *positionOfOne, size_t numberOfOne, size_t wordNumber, short parallel);
+void cww_packed_batch(uint64_t *result, int numberOfZero, const int *positionOfOne, size_t numberOfOne, size_t wordNumber, short parallel);
+void cww_from_seed_batch(int *result, int numberOfZero, size_t numberOfOne, const unsigned char *seed, size_t wordNumber, short parallel);
+void cww_packed_from_seed_batch(uint64_t *result, int numberOfZero, size_t numberOfOne, const unsigned char *seed, size_t wordNumber, short parallel);
+
 
 #define cww cww_merge_after_sort_recursive
 
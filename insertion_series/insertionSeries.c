@@ -1,6 +1,272 @@
 #include "insertionSeries.h"
 
 
+/**
+ * Function that computes the scratch bytes needed by prefixSumInto and prefixSumFromLeftInverseInto.
+ *
+ * @note The size depends on the maximum number of OpenMP threads at the time of the call.
+ *
+ * @return the bytes to reserve in the arena.
+ */
+size_t prefixSumWorkspaceSize(void) {
+    return arena_size((size_t) omp_get_max_threads() * sizeof(int));
+}
+
+/**
+ * Function that computes the cumulative prefixes of an array into a buffer.
+ *
+ * @note The first element is always 0.
+ *
+ * @param result the buffer of size listSize + 1, where all element is the sum of all previous elements of the input array, it may be the array itself.
+ * @param list the array.
+ * @param listSize the array size.
+ * @param arena the arena that has room for prefixSumWorkspaceSize bytes.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void prefixSumInto(int *result, const int *list, size_t listSize, Arena *arena, short parallel) {
+    if (parallel && listSize >= PREFIX_SUM_PARALLEL_CUTOFF) {
+        prefixSumParallelInto(result, list, listSize, arena);
+    }
+    else {
+        prefixSumSerialInto(result, list, listSize);
+    }
+}
+
+/**
+ * Function that computes the cumulative prefixes of an array into a buffer.
+ *
+ * @details Serial version, the elements are scanned inside the vector registers by the exclusiveScan kernel.
+ * @note The first element is always 0.
+ *
+ * @param result the buffer of size listSize + 1, where all element is the sum of all previous elements of the input array, it may be the array itself.
+ * @param list the array.
+ * @param listSize the array size.
+ */
+void prefixSumSerialInto(int *result, const int *list, size_t listSize) {
+    STATS_PHASE_BEGIN(STATS_PHASE_PREFIX_SUM);
+    result[listSize] = exclusiveScan(result, list, listSize, 0);
+    STATS_PHASE_END(STATS_PHASE_PREFIX_SUM);
+}
+
+/**
+ * Function that computes the cumulative prefixes of an array into a buffer.
+ *
+ * @details Parallel version, reduce-then-scan: each thread sums its chunk, the sums of the chunks are scanned once, then each thread scans its chunk from its offset.
+ * @details Each element is written once, and the chunks are aligned to the vector registers.
+ * @note The first element is always 0.
+ *
+ * @param result the buffer of size listSize + 1, where all element is the sum of all previous elements of the input array, it may be the array itself.
+ * @param list the array.
+ * @param listSize the array size.
+ * @param arena the arena that has room for prefixSumWorkspaceSize bytes.
+ */
+void prefixSumParallelInto(int *result, const int *list, size_t listSize, Arena *arena) {
+    STATS_PHASE_BEGIN(STATS_PHASE_PREFIX_SUM);
+
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+    /// List of partial sum, one for each thread.
+    int *partialSumList = arena_alloc(arena, (size_t) omp_get_max_threads() * sizeof(int));
+
+#pragma omp parallel
+    {
+        /// Thread ID.
+        int threadID = omp_get_thread_num();
+        /// Number of thread.
+        int numberThread = omp_get_num_threads();
+
+        /// Chunk per thread, a multiple of the vector width.
+        size_t chunk = ((listSize + numberThread - 1) / numberThread + PREFIX_SUM_ALIGNMENT - 1) & ~(size_t) (PREFIX_SUM_ALIGNMENT - 1);
+        /// Start position.
+        size_t start = (size_t) threadID * chunk < listSize ? (size_t) threadID * chunk : listSize;
+        /// End position.
+        size_t end = start + chunk < listSize ? start + chunk : listSize;
+
+        partialSumList[threadID] = sumIntegers(list + start, end - start);
+
+#pragma omp barrier
+#pragma omp single
+        {
+            /// The sum of the previous chunks.
+            int offset = 0;
+
+            for (int i = 0; i < numberThread; ++i) {
+                /// The sum of the chunk.
+                int chunkSum = partialSumList[i];
+
+                partialSumList[i] = offset;
+                offset += chunkSum;
+            }
+
+            result[listSize] = offset;
+        }
+
+        exclusiveScan(result + start, list + start, end - start, partialSumList[threadID]);
+    }
+
+    arena_release(arena, arenaMark);
+
+    STATS_PHASE_END(STATS_PHASE_PREFIX_SUM);
+}
+
+/**
+ * Function that computes the cumulative prefixes of the inverse of the fromLeft of an array of keys into a buffer.
+ *
+ * @details The elements 1 - fromLeft are generated from the keys while they are scanned, without being stored.
+ * @note The first element is always 0.
+ *
+ * @param result the buffer of size keySize + 1, where all element is the number of previous keys that do not come from the left list.
+ * @param key the array of keys.
+ * @param keySize the array size.
+ * @param arena the arena that has room for prefixSumWorkspaceSize bytes.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void prefixSumFromLeftInverseInto(int *result, const SortKey *key, size_t keySize, Arena *arena, short parallel) {
+    if (parallel && keySize >= PREFIX_SUM_PARALLEL_CUTOFF) {
+        prefixSumFromLeftInverseParallelInto(result, key, keySize, arena);
+    }
+    else {
+        prefixSumFromLeftInverseSerialInto(result, key, keySize);
+    }
+}
+
+/**
+ * Function that computes the cumulative prefixes of the inverse of the fromLeft of an array of keys into a buffer.
+ *
+ * @details Serial version, the elements are scanned inside the vector registers by the exclusiveScanFromLeftInverse kernel.
+ * @note The first element is always 0.
+ *
+ * @param result the buffer of size keySize + 1, where all element is the number of previous keys that do not come from the left list.
+ * @param key the array of keys.
+ * @param keySize the array size.
+ */
+void prefixSumFromLeftInverseSerialInto(int *result, const SortKey *key, size_t keySize) {
+    STATS_PHASE_BEGIN(STATS_PHASE_PREFIX_SUM);
+    result[keySize] = exclusiveScanFromLeftInverse(result, key, keySize, 0);
+    STATS_PHASE_END(STATS_PHASE_PREFIX_SUM);
+}
+
+/**
+ * Function that computes the cumulative prefixes of the inverse of the fromLeft of an array of keys into a buffer.
+ *
+ * @details Parallel version, reduce-then-scan as in prefixSumParallelInto.
+ * @note The first element is always 0.
+ *
+ * @param result the buffer of size keySize + 1, where all element is the number of previous keys that do not come from the left list.
+ * @param key the array of keys.
+ * @param keySize the array size.
+ * @param arena the arena that has room for prefixSumWorkspaceSize bytes.
+ */
+void prefixSumFromLeftInverseParallelInto(int *result, const SortKey *key, size_t keySize, Arena *arena) {
+    STATS_PHASE_BEGIN(STATS_PHASE_PREFIX_SUM);
+
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+    /// List of partial sum, one for each thread.
+    int *partialSumList = arena_alloc(arena, (size_t) omp_get_max_threads() * sizeof(int));
+
+#pragma omp parallel
+    {
+        /// Start position.
+        size_t start;
+        /// End position.
+        size_t end;
+        /// The number of keys before the chunk that do not come from the left list.
+        int offset = prefixSumFromLeftInverseTeam(key, keySize, partialSumList, &start, &end);
+
+        /// The number of keys up to the end of the chunk that do not come from the left list.
+        int chunkEnd = exclusiveScanFromLeftInverse(result + start, key + start, end - start, offset);
+
+        // the last chunk always ends with the array
+        if (omp_get_thread_num() == omp_get_num_threads() - 1) {
+            result[keySize] = chunkEnd;
+        }
+    }
+
+    arena_release(arena, arenaMark);
+
+    STATS_PHASE_END(STATS_PHASE_PREFIX_SUM);
+}
+
+/**
+ * Function that splits an array of keys among the threads of the current team and computes the offset of the chunk of the calling thread.
+ *
+ * @warning It must be called by all the threads of the team, with the same arguments.
+ *
+ * @details Each thread counts the keys of its chunk that do not come from the left list, then the counts are scanned by prefixSumOffsetTeam.
+ *
+ * @param key the array of keys.
+ * @param keySize the array size.
+ * @param partialSumList the buffer of one offset for each thread.
+ * @param start the first key of the chunk of the calling thread.
+ * @param end the last key of the chunk of the calling thread, excluded.
+ * @return the number of keys before the chunk that do not come from the left list.
+ */
+int prefixSumFromLeftInverseTeam(const SortKey *key, size_t keySize, int *partialSumList, size_t *start, size_t *end) {
+    prefixSumChunk(keySize, start, end);
+
+    return prefixSumOffsetTeam(countFromLeftInverse(key + *start, *end - *start), partialSumList);
+}
+
+/**
+ * Function that computes the chunk of an array of the calling thread of the current team.
+ *
+ * @details The chunks are a multiple of the vector width, so only the last one has a scalar tail.
+ *
+ * @param size the array size.
+ * @param start the first element of the chunk of the calling thread.
+ * @param end the last element of the chunk of the calling thread, excluded.
+ */
+void prefixSumChunk(size_t size, size_t *start, size_t *end) {
+    /// Thread ID.
+    int threadID = omp_get_thread_num();
+    /// Number of thread.
+    int numberThread = omp_get_num_threads();
+
+    /// Chunk per thread, a multiple of the vector width.
+    size_t chunk = ((size + numberThread - 1) / numberThread + PREFIX_SUM_ALIGNMENT - 1) & ~(size_t) (PREFIX_SUM_ALIGNMENT - 1);
+
+    *start = (size_t) threadID * chunk < size ? (size_t) threadID * chunk : size;
+    *end = *start + chunk < size ? *start + chunk : size;
+}
+
+/**
+ * Function that computes the offset of the chunk of the calling thread from the sums of the chunks of the current team.
+ *
+ * @warning It must be called by all the threads of the team.
+ *
+ * @details A single thread scans the sums of the chunks, all the threads see the offsets on return.
+ *
+ * @param chunkSum the sum of the chunk of the calling thread.
+ * @param partialSumList the buffer of one offset for each thread.
+ * @return the sum of the chunks before the one of the calling thread.
+ */
+int prefixSumOffsetTeam(int chunkSum, int *partialSumList) {
+    /// Thread ID.
+    int threadID = omp_get_thread_num();
+    /// Number of thread.
+    int numberThread = omp_get_num_threads();
+
+    partialSumList[threadID] = chunkSum;
+
+#pragma omp barrier
+#pragma omp single
+    {
+        /// The sum of the previous chunks.
+        int offset = 0;
+
+        for (int i = 0; i < numberThread; ++i) {
+            /// The sum of the chunk.
+            int sum = partialSumList[i];
+
+            partialSumList[i] = offset;
+            offset += sum;
+        }
+    }
+
+    return partialSumList[threadID];
+}
+
 /**
  * Function that computes the cumulative prefixes of an intList.
  *
@@ -33,15 +299,9 @@ IntList prefixSumSerial(const IntList *list) {
     IntList result;
     intlist_init(&result);
     intlist_reserve(&result, list->listSize + 1);
+    result.listSize = list->listSize + 1;
 
-    /// The partial sum of each element.
-    int sum = 0;
-
-    intlist_append(&result, 0);
-    for(size_t i = 0; i < list->listSize; ++i) {
-        sum += list->list[i];
-        intlist_append(&result, sum);
-    }
+    prefixSumSerialInto(result.list, list->list, list->listSize);
 
     return result;
 }
@@ -60,121 +320,63 @@ IntList prefixSumParallel(const IntList *list) {
     IntList result;
     intlist_init(&result);
     intlist_reserve(&result, list->listSize + 1);
+    result.listSize = list->listSize + 1;
 
-    /// List size.
-    size_t listSize = list->listSize;
-    /// Output list.
-    int *output = malloc((listSize + 1) * sizeof(int));
-    assert(output && "Malloc error!!!");
-
-    output[0] = 0;
-
-    /// Number of threads used.
-    int numberThreadUsed = 0;
-    /// List of partial sum.
-    int *partialSumList = NULL;
-
-#pragma omp parallel
-    {
-        /// Thread ID.
-        int threadID = omp_get_thread_num();
-        /// Number of thread.
-        int numberThread = omp_get_num_threads();
-
-#pragma omp single
-        {
-            numberThreadUsed = numberThread;
-            partialSumList = calloc(numberThreadUsed, sizeof(int));
-        }
-
-        /// Chunk per thread.
-        size_t chunk = (listSize + numberThread - 1) / numberThread;
-        /// Start position.
-        size_t start = threadID * chunk;
-
-        /// The mux selector.
-        /// @details start + chunk < listSize --> -1 = 0xFF...FF
-        /// @details start + chunk > listSize --> 0  = 0x00...00
-        size_t muxSelector = (size_t)(-(start + chunk < listSize));
-
-        /// End position.
-        size_t end = ((start + chunk) & muxSelector) | (listSize & !muxSelector);
-
-        /// Local sum value.
-        int localSum = 0;
-
-        for (size_t i = start; i < end; ++i) {
-            localSum += list->list[i];
-            output[i + 1] = localSum;
-        }
-        partialSumList[threadID] = localSum;
-
-#pragma omp barrier
-
-        /// Offset used to insert thread results into the output list.
-        int offset = 0;
-
-        for (int i = 0; i < threadID; ++i) {
-            offset += partialSumList[i];
-        }
+    /// The size of the scratch memory.
+    size_t workspaceSize = prefixSumWorkspaceSize();
 
-        for (size_t i = start + 1; i <= end; ++i) {
-            output[i] += offset;
-        }
-    }
+    /// The scratch memory of the partial sums.
+    void *workspace = arena_workspace_alloc(workspaceSize);
+    /// The arena over the scratch memory.
+    Arena arena;
+    arena_init(&arena, workspace, workspaceSize);
 
-    for (size_t i = 0; i <= listSize; ++i) {
-        intlist_append(&result, output[i]);
-    }
+    prefixSumParallelInto(result.list, list->list, list->listSize, &arena);
 
-    free(output);
-    free(partialSumList);
+    arena_workspace_free(workspace, workspaceSize);
 
     return result;
 }
 
 
 /**
- * Function that merge and sort two list of quadruple.
+ * Function that merges two sorted lists of quadruple.
+ *
+ * @note The values are merged only if both lists have values.
  *
  * @param firstList the first list of quadruple.
- * @param firstListSize the size of the first list of quadruple.
  * @param secondList the second list of quadruple.
- * @param secondListSize the size of the second list of quadruple.
  * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
  * @return the ordered union of the two input lists.
  */
-Quadruple *merge(Quadruple *firstList, size_t firstListSize, Quadruple *secondList, size_t secondListSize, short parallel) {
+QuadrupleArray merge(const QuadrupleArray *firstList, const QuadrupleArray *secondList, short parallel) {
     if (parallel) {
-        return mergeParallel(firstList, firstListSize, secondList, secondListSize);
+        return mergeParallel(firstList, secondList);
     }
     else {
-        return mergeSerial(firstList, firstListSize, secondList, secondListSize);
+        return mergeSerial(firstList, secondList);
     }
 }
 
 /**
- * Function that merge and sort two list of quadruple.
+ * Function that merges two sorted lists of quadruple.
  *
  * @details Serial version.
+ * @details The two lists are merged by the active merging network, see mergeNetworkSelect.
  *
  * @param firstList the first list of quadruple.
- * @param firstListSize the size of the first list of quadruple.
  * @param secondList the second list of quadruple.
- * @param secondListSize the size of the second list of quadruple.
  * @return the ordered union of the two input lists.
  */
-Quadruple *mergeSerial(Quadruple *firstList, size_t firstListSize, Quadruple *secondList, size_t secondListSize) {
-    /// The size of the new list of quadruple.
-    size_t resultSize = firstListSize + secondListSize;
+QuadrupleArray mergeSerial(const QuadrupleArray *firstList, const QuadrupleArray *secondList) {
     /// The new array of quadruple that contains the quadruple of the first and the second input list.
-    Quadruple *result = malloc(resultSize * sizeof * result);
-    assert(result && "Malloc error!!!");
+    QuadrupleArray result;
+    quadruplearray_alloc(&result, firstList->arraySize + secondList->arraySize, firstList->value && secondList->value);
 
-    // merge(L, R) = copy the first; copy the second; sort
-    memcpy(result, firstList, firstListSize * sizeof * result);
-    memcpy(result + firstListSize, secondList, secondListSize * sizeof * result);
-    bitonicSort(result, 0, resultSize, ASCENDING, SERIAL);
+    // merge(L, R) = copy the first in the order of the network; copy the second; merging network
+    STATS_PHASE_BEGIN(STATS_PHASE_NETWORK);
+    mergeNetworkSortedLists(&result, firstList, secondList, SERIAL);
+    STATS_PHASE_END(STATS_PHASE_NETWORK);
 
     return result;
 }
@@ -183,188 +385,520 @@ Quadruple *mergeSerial(Quadruple *firstList, size_t firstListSize, Quadruple *se
  * Merge two sorted arrays of Quadruple into a single sorted array.
  *
  * @details Parallel version.
+ * @details The two lists are merged by the active merging network, see mergeNetworkSelect.
  *
  * @param firstList the first list of quadruple.
- * @param firstListSize the size of the first list of quadruple.
  * @param secondList the second list of quadruple.
- * @param secondListSize the size of the second list of quadruple.
  * @return the ordered union of the two input lists.
  */
-Quadruple *mergeParallel(Quadruple *firstList, size_t firstListSize, Quadruple *secondList, size_t secondListSize) {
-    // The size of the new list of quadruple.
-    size_t resultSize = firstListSize + secondListSize;
+QuadrupleArray mergeParallel(const QuadrupleArray *firstList, const QuadrupleArray *secondList) {
     /// The new array of quadruple that contains the quadruple of the first and the second input list.
-    Quadruple *result = malloc(resultSize * sizeof * result);
-    assert(result && "Malloc error!!!");
-
-    // merge(L, R) = copy the first; copy the second; sort
-#pragma omp parallel sections
-    {
-#pragma omp section
-        memcpy(result, firstList, firstListSize * sizeof *result);
-
-#pragma omp section
-        memcpy(result + firstListSize, secondList, secondListSize * sizeof *result);
-    }
+    QuadrupleArray result;
+    quadruplearray_alloc(&result, firstList->arraySize + secondList->arraySize, firstList->value && secondList->value);
 
-    bitonicSort(result, 0, resultSize, ASCENDING, PARALLEL);
+    // merge(L, R) = copy the first in the order of the network; copy the second; merging network
+    STATS_PHASE_BEGIN(STATS_PHASE_NETWORK);
+    mergeNetworkSortedLists(&result, firstList, secondList, PARALLEL);
+    STATS_PHASE_END(STATS_PHASE_NETWORK);
 
     return result;
 }
 
 
 /**
- * Function that performs an ordered merging of two pairLists.
+ * Function that writes the merged pairs, each value with its final position.
  *
- * @param firstList the first pairList.
- * @param secondList the second pairList.
+ * @details The final position is the index0 of the quadruple plus the number of previous quadruples that do not come from the left list.
+ * @details Each quadruple is read once, in the same sweep that scans the fromLeft and writes the pair, by the emitMergedPairs kernel.
+ * @details Parallel version, blocked: the threads count the fromLeft of their chunk, then each one sweeps its chunk from its offset.
+ *
+ * @param result the buffer of size pairs.
+ * @param key the merged keys.
+ * @param value the merged values.
+ * @param size the number of quadruples.
+ * @param arena the arena that has room for prefixSumWorkspaceSize bytes.
  * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
- * @return the ordered merged pairList.
  */
-PairList insertionseries_sort_merge(const PairList *firstList, const PairList *secondList, short parallel) {
-    /// List size of firstList.
-    size_t firstListSize = firstList->listSize;
-    /// List size of secondList.
-    size_t secondListSize = secondList->listSize;
+void insertionseries_emit_merged(Pair *result, const SortKey *key, const int *value, size_t size, Arena *arena, short parallel) {
+    STATS_PHASE_BEGIN(STATS_PHASE_COPY_OUT);
 
-    /// Array of quadruple, each quadruple value corresponds to the firstList values.
-    Quadruple *firstListQuadrupleArray = malloc(firstListSize * sizeof * firstListQuadrupleArray);
-    assert(firstListQuadrupleArray && "Malloc error!!!");
+    if (parallel && size >= PREFIX_SUM_PARALLEL_CUTOFF) {
+        /// The position of the arena to restore.
+        size_t arenaMark = arena_mark(arena);
+        /// List of partial sum, one for each thread.
+        int *partialSumList = arena_alloc(arena, (size_t) omp_get_max_threads() * sizeof(int));
 
-    /// Array of quadruple, each quadruple value corresponds to the secondList values.
-    Quadruple *secondListQuadrupleArray = malloc(secondListSize * sizeof * secondListQuadrupleArray);
-    assert(secondListQuadrupleArray && "Malloc error!!!");
+#pragma omp parallel
+        {
+            /// Start position.
+            size_t start;
+            /// End position.
+            size_t end;
+            /// The number of quadruples before the chunk that do not come from the left list.
+            int offset = prefixSumFromLeftInverseTeam(key, size, partialSumList, &start, &end);
+
+            emitMergedPairs(result + start, key + start, value + start, end - start, offset);
+        }
 
-    // create quadruple arrays - [<key, value, fromLeft, indexInOriginalList>]
-    if (parallel) {
+        arena_release(arena, arenaMark);
+    }
+    else {
+        emitMergedPairs(result, key, value, size, 0);
+    }
+
+    STATS_PHASE_END(STATS_PHASE_COPY_OUT);
+}
+
+/**
+ * Function that computes the scratch bytes needed by insertionseries_sort_merge_into.
+ *
+ * @param resultSize the size of the merged array.
+ * @return the bytes to reserve in the arena.
+ */
+size_t insertionseries_sort_merge_workspace_size(size_t resultSize) {
+    return arena_size(resultSize * sizeof(SortKey))     // keys of the quadruples
+         + arena_size(resultSize * sizeof(int))         // values of the quadruples
+         + prefixSumWorkspaceSize();
+}
+
+/**
+ * Function that performs an ordered merging of two sorted arrays of pairs into a buffer.
+ *
+ * @warning The arena must have room for insertionseries_sort_merge_workspace_size(firstListSize + secondListSize) bytes.
+ *
+ * @details The quadruples are written directly in the arena, the first list in the order expected by the active merging network followed by the second one normalized, and merged there by the network.
+ * @details The inputs are completely read before the result is written, so the result may overlap them: when the two lists are contiguous in the result the merge is in place.
+ * @details All the scratch buffers are released before returning.
+ *
+ * @param result the buffer that will contain the firstListSize + secondListSize merged pairs.
+ * @param firstList the first sorted array of pairs.
+ * @param firstListSize the size of the first array.
+ * @param secondList the second sorted array of pairs.
+ * @param secondListSize the size of the second array.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void insertionseries_sort_merge_into(Pair *result, const Pair *firstList, size_t firstListSize, const Pair *secondList, size_t secondListSize, Arena *arena, short parallel) {
+    /// The size of the merged array.
+    size_t resultSize = firstListSize + secondListSize;
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+
+    /// The quadruples used by the merging network.
+    QuadrupleArray workspace;
+    workspace.key = arena_alloc(arena, resultSize * sizeof(SortKey));
+    workspace.value = arena_alloc(arena, resultSize * sizeof(int));
+    workspace.arraySize = resultSize;
+
+    /// The packed keys of the quadruples.
+    SortKey *key = workspace.key;
+    /// The values of the quadruples.
+    int *value = workspace.value;
+    /// 1 if the merging network expects the first list in descending order.
+    short reversedFirstRun = mergeNetwork->reversedFirstRun;
+
+    STATS_PHASE_BEGIN(STATS_PHASE_KEYS);
+
+    // create the two runs of quadruples - [<packed key <index0, fromLeft, indexInItsList>, value>]
+    if (parallel && resultSize >= PREFIX_SUM_PARALLEL_CUTOFF) {
 #pragma omp parallel
         {
 #pragma omp for schedule(static) nowait
             for(size_t j = 0; j < firstListSize; ++j) {
-                firstListQuadrupleArray[j].index0 = firstList->list[j].index0;
-                firstListQuadrupleArray[j].index1 = firstList->list[j].index1;
-                firstListQuadrupleArray[j].fromLeft = 1;
-                firstListQuadrupleArray[j].indexInItsList = 0;
+                key[reversedFirstRun ? firstListSize - 1 - j : j] = packSortKey(firstList[j].index0, 1, 0);
+                value[reversedFirstRun ? firstListSize - 1 - j : j] = firstList[j].index1;
             }
 
 #pragma omp for schedule(static)
             // normalize the index 0
             for(size_t j = 0; j < secondListSize; ++j) {
-                secondListQuadrupleArray[j].index0 = secondList->list[j].index0 - (int)j;
-                secondListQuadrupleArray[j].index1 = secondList->list[j].index1;
-                secondListQuadrupleArray[j].fromLeft = 0;
-                secondListQuadrupleArray[j].indexInItsList = (int)j;
+                key[firstListSize + j] = packSortKey(secondList[j].index0 - (int)j, 0, (int)j);
+                value[firstListSize + j] = secondList[j].index1;
             }
         }
     }
     else {
         for(size_t j = 0; j < firstListSize; ++j) {
-            firstListQuadrupleArray[j].index0 = firstList->list[j].index0;
-            firstListQuadrupleArray[j].index1 = firstList->list[j].index1;
-            firstListQuadrupleArray[j].fromLeft = 1;
-            firstListQuadrupleArray[j].indexInItsList = 0;
+            key[reversedFirstRun ? firstListSize - 1 - j : j] = packSortKey(firstList[j].index0, 1, 0);
+            value[reversedFirstRun ? firstListSize - 1 - j : j] = firstList[j].index1;
         }
 
         // normalize the index 0
         for(size_t j = 0; j < secondListSize; ++j) {
-            secondListQuadrupleArray[j].index0 = secondList->list[j].index0 - (int)j;
-            secondListQuadrupleArray[j].index1 = secondList->list[j].index1;
-            secondListQuadrupleArray[j].fromLeft = 0;
-            secondListQuadrupleArray[j].indexInItsList = (int)j;
+            key[firstListSize + j] = packSortKey(secondList[j].index0 - (int)j, 0, (int)j);
+            value[firstListSize + j] = secondList[j].index1;
         }
     }
 
-    /// The size of the new list of quadruple.
-    size_t newQuadrupleArraySize = firstListSize + secondListSize;
-    /// The new array of quadruple that contains the quadruple of the first and the second input list.
-    Quadruple *newQuadrupleArray = merge(firstListQuadrupleArray, firstListSize, secondListQuadrupleArray, secondListSize, parallel);
+    STATS_PHASE_END(STATS_PHASE_KEYS);
 
+    STATS_PHASE_BEGIN(STATS_PHASE_NETWORK);
+    mergeNetwork->mergeRuns(&workspace, firstListSize, secondListSize, parallel);
+    STATS_PHASE_END(STATS_PHASE_NETWORK);
 
-    /// IntList that contains the inverse of newQuadrupleArray.fromLeft.
-    IntList fromLeftInverse;
-    intlist_init(&fromLeftInverse);
-    intlist_reserve(&fromLeftInverse, newQuadrupleArraySize);
+    insertionseries_emit_merged(result, key, value, resultSize, arena, parallel);
 
-    for(size_t i = 0; i < newQuadrupleArraySize; ++i) {
-        intlist_append(&fromLeftInverse, 1 - newQuadrupleArray[i].fromLeft);
-    }
+    arena_release(arena, arenaMark);
+}
 
-    /// The list of true offset to add at each element of newQuadrupleArray.index0.
-    IntList offsetList = prefixSum(&fromLeftInverse, parallel);
+/**
+ * Function that performs an ordered merging of two pairLists.
+ *
+ * @param firstList the first pairList.
+ * @param secondList the second pairList.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ * @return the ordered merged pairList.
+ */
+PairList insertionseries_sort_merge(const PairList *firstList, const PairList *secondList, short parallel) {
+    /// The size of the merged pairList.
+    size_t resultSize = firstList->listSize + secondList->listSize;
+    /// The size of the scratch memory.
+    size_t workspaceSize = insertionseries_sort_merge_workspace_size(resultSize);
+
+    /// The scratch memory of the merge.
+    void *workspace = arena_workspace_alloc(workspaceSize);
+    /// The arena over the scratch memory.
+    Arena arena;
+    arena_init(&arena, workspace, workspaceSize);
 
     /// The output pairList.
     PairList result;
     pairlist_init(&result);
-    pairlist_reserve(&result, newQuadrupleArraySize);
+    pairlist_reserve(&result, resultSize);
+    result.listSize = resultSize;
 
-    for(size_t i = 0; i < newQuadrupleArraySize; ++i) {
-        pairlist_append(&result, newQuadrupleArray[i].index0 + offsetList.list[i], newQuadrupleArray[i].index1);
-    }
+    insertionseries_sort_merge_into(result.list, firstList->list, firstList->listSize, secondList->list, secondList->listSize, &arena, parallel);
 
-    // clean the allocated list
-    free(firstListQuadrupleArray);
-    free(secondListQuadrupleArray);
-    free(newQuadrupleArray);
-    intlist_free(&fromLeftInverse);
-    intlist_free(&offsetList);
+    arena_workspace_free(workspace, workspaceSize);
 
     return result;
 }
 
 /**
- * Function that sorts a pairList.
+ * Function that computes how many threads can merge independent runs at the same time.
+ *
+ * @details Each thread needs its own part of the arena, so the number of threads is bounded by the free bytes of the arena, by the number of runs and by the OpenMP threads.
+ *
+ * @param taskNumber the number of independent merges.
+ * @param taskWorkspaceSize the bytes of the arena needed by each merge.
+ * @param arena the arena of the scratch buffers.
+ * @return the number of threads, 1 if the merges must be executed one after another.
+ */
+int sortThreadNumber(size_t taskNumber, size_t taskWorkspaceSize, const Arena *arena) {
+    /// The number of threads.
+    size_t threadNumber = (size_t) omp_get_max_threads();
+
+    if (taskNumber < threadNumber) {
+        threadNumber = taskNumber;
+    }
+    if (arena_available(arena) / taskWorkspaceSize < threadNumber) {
+        threadNumber = arena_available(arena) / taskWorkspaceSize;
+    }
+
+    return threadNumber ? (int) threadNumber : 1;
+}
+
+/**
+ * Function that moves a view of the insertions forward.
+ *
+ * @param elements the insertions.
+ * @param offset the number of insertions to skip.
+ * @return the insertions from the offset on.
+ */
+static InsertionElements insertionseries_elements_at(InsertionElements elements, size_t offset) {
+    if (elements.pairList) {
+        elements.pairList += offset;
+    }
+    else {
+        elements.position += offset;
+        elements.payload += offset * elements.payloadSize;
+    }
+
+    return elements;
+}
+
+/**
+ * Function that computes the scratch bytes needed by the merge of two adjacent runs of insertions.
+ *
+ * @param elements the insertions.
+ * @param resultSize the size of the merged runs.
+ * @return the bytes to reserve in the arena.
+ */
+static size_t insertionseries_merge_elements_workspace_size(InsertionElements elements, size_t resultSize) {
+    return elements.pairList ? insertionseries_sort_merge_workspace_size(resultSize) : insertionseries_payload_merge_workspace_size(resultSize);
+}
+
+/**
+ * Function that merges two adjacent runs of insertions in place.
+ *
+ * @details The pairs are merged by insertionseries_sort_merge_into, the positions with payloads by insertionseries_payload_merge_into.
+ *
+ * @param elements the insertions, the left run followed by the right one.
+ * @param leftSize the size of the left run.
+ * @param rightSize the size of the right run.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+static void insertionseries_merge_elements(InsertionElements elements, size_t leftSize, size_t rightSize, Arena *arena, short parallel) {
+    if (elements.pairList) {
+        insertionseries_sort_merge_into(elements.pairList, elements.pairList, leftSize, elements.pairList + leftSize, rightSize, arena, parallel);
+    }
+    else {
+        insertionseries_payload_merge_into(elements.position, elements.payload, leftSize, rightSize, elements.payloadSize, arena, parallel);
+    }
+}
+
+/**
+ * Function that sorts the blocks of SORT_TASK_CUTOFF insertions at the same time.
+ *
+ * @details Each block is a subtree of the recursion: it is sorted by a single thread, serially, inside its own part of the arena.
+ *
+ * @param elements the insertions to sort.
+ * @param size the number of insertions.
+ * @param arena the arena of the scratch buffers.
+ * @return the width of the runs already sorted, 1 if the blocks have not been sorted.
+ */
+size_t insertionseries_sort_blocks(InsertionElements elements, size_t size, Arena *arena) {
+    /// The number of blocks.
+    size_t blockNumber = (size + SORT_TASK_CUTOFF - 1) / SORT_TASK_CUTOFF;
+    /// The bytes of the arena used by each thread.
+    size_t threadWorkspaceSize = insertionseries_merge_elements_workspace_size(elements, size < SORT_TASK_CUTOFF ? size : SORT_TASK_CUTOFF);
+    /// The number of threads.
+    int threadNumber = sortThreadNumber(blockNumber, threadWorkspaceSize, arena);
+
+    if (threadNumber < 2) {
+        return 1;
+    }
+
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+    /// The memory shared by the threads.
+    unsigned char *threadWorkspace = arena_alloc(arena, (size_t) threadNumber * threadWorkspaceSize);
+
+#pragma omp parallel num_threads(threadNumber)
+    {
+        /// The part of the arena of this thread.
+        Arena threadArena;
+        arena_init(&threadArena, threadWorkspace + (size_t) omp_get_thread_num() * threadWorkspaceSize, threadWorkspaceSize);
+
+#pragma omp for schedule(dynamic, 1)
+        for (size_t block = 0; block < blockNumber; ++block) {
+            /// The first insertion of the block.
+            size_t start = block * SORT_TASK_CUTOFF;
+            /// The block size, the last one can be shorter.
+            size_t blockSize = size - start < SORT_TASK_CUTOFF ? size - start : SORT_TASK_CUTOFF;
+
+            insertionseries_sort_elements_into(insertionseries_elements_at(elements, start), blockSize, &threadArena, SERIAL);
+        }
+    }
+
+    arena_release(arena, arenaMark);
+
+    return SORT_TASK_CUTOFF;
+}
+
+/**
+ * Function that merges two by two the sorted runs of a given width.
  *
- * @note The function works recursively.
+ * @details In parallel mode, when there are enough runs to occupy all the threads, the merges are independent subtrees of the recursion: each thread merges its runs serially, inside its own part of the arena.
+ * @details Otherwise the merges are executed one after another, each one parallelized inside.
+ *
+ * @param elements the insertions.
+ * @param size the number of insertions.
+ * @param width the width of the sorted runs.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void insertionseries_sort_level(InsertionElements elements, size_t size, size_t width, Arena *arena, short parallel) {
+    /// The number of merges of the level.
+    size_t mergeNumber = (size - width + 2 * width - 1) / (2 * width);
+    /// The bytes of the arena used by each thread.
+    size_t threadWorkspaceSize = insertionseries_merge_elements_workspace_size(elements, size < 2 * width ? size : 2 * width);
+    /// The number of threads that merge at the same time.
+    int threadNumber = parallel && mergeNumber >= (size_t) omp_get_max_threads() ? sortThreadNumber(mergeNumber, threadWorkspaceSize, arena) : 1;
+
+    if (threadNumber > 1) {
+        /// The position of the arena to restore.
+        size_t arenaMark = arena_mark(arena);
+        /// The memory shared by the threads.
+        unsigned char *threadWorkspace = arena_alloc(arena, (size_t) threadNumber * threadWorkspaceSize);
+
+#pragma omp parallel num_threads(threadNumber)
+        {
+            /// The part of the arena of this thread.
+            Arena threadArena;
+            arena_init(&threadArena, threadWorkspace + (size_t) omp_get_thread_num() * threadWorkspaceSize, threadWorkspaceSize);
+
+#pragma omp for schedule(static)
+            for (size_t merge = 0; merge < mergeNumber; ++merge) {
+                /// The first insertion of the left run.
+                size_t start = merge * 2 * width;
+                /// The size of the right run, the last one can be shorter.
+                size_t rightSize = size - start - width < width ? size - start - width : width;
+
+                insertionseries_merge_elements(insertionseries_elements_at(elements, start), width, rightSize, &threadArena, SERIAL);
+            }
+        }
+
+        arena_release(arena, arenaMark);
+    }
+    else {
+        for (size_t start = 0; start + width < size; start += 2 * width) {
+            /// The size of the right run, the last one can be shorter.
+            size_t rightSize = size - start - width < width ? size - start - width : width;
+
+            insertionseries_merge_elements(insertionseries_elements_at(elements, start), width, rightSize, arena, parallel);
+        }
+    }
+}
+
+/**
+ * Function that sorts insertions in place.
+ *
+ * @warning The arena must have room for the scratch bytes of a merge of size insertions: insertionseries_sort_merge_workspace_size for pairs, insertionseries_payload_merge_workspace_size for payloads.
+ *
+ * @details The recursion of the reference algorithm is executed bottom-up: the runs of width 1, 2, 4, ... are merged two by two, inside the array.
+ * @details The result does not depend on where the array is split, so it is the same of the top-down recursion.
+ * @details Each merge takes its scratch buffers from the arena and releases them, so the arena is reused by all the merges.
+ * @details In parallel mode the subtrees of SORT_TASK_CUTOFF insertions are sorted at the same time, one per thread, and so are the merges of a level with at least one run per thread.
+ * @details An array of at most SORT_TASK_CUTOFF insertions is sorted serially even in parallel mode.
+ *
+ * @param elements the insertions to sort.
+ * @param size the number of insertions.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void insertionseries_sort_elements_into(InsertionElements elements, size_t size, Arena *arena, short parallel) {
+    // an array of at most SORT_TASK_CUTOFF insertions is a single subtree, sorted by a single thread
+    if (size <= SORT_TASK_CUTOFF) {
+        parallel = SERIAL;
+    }
+
+    /// The width of the runs already sorted.
+    size_t width = parallel ? insertionseries_sort_blocks(elements, size, arena) : 1;
+
+    for (; width < size; width *= 2) {
+        insertionseries_sort_level(elements, size, width, arena, parallel);
+    }
+}
+
+/**
+ * Function that sorts an array of pairs in place.
+ *
+ * @warning The arena must have room for insertionseries_sort_merge_workspace_size(pairListSize) bytes.
+ *
+ * @details The pairs are sorted by insertionseries_sort_elements_into.
+ *
+ * @param pairList the array of pairs to sort.
+ * @param pairListSize the array size.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void insertionseries_sort_recursive_into(Pair *pairList, size_t pairListSize, Arena *arena, short parallel) {
+    insertionseries_sort_elements_into((InsertionElements) {pairList, NULL, NULL, 0}, pairListSize, arena, parallel);
+}
+
+/**
+ * Function that sorts a pairList.
  *
  * @param pairList the pairList to sort.
  * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
  * @return the pairList sorted.
  */
 PairList insertionseries_sort_recursive(const PairList *pairList, short parallel) {
-    // base case
-    if (pairList->listSize <= 1) {
-        /// The sorted pairList.
-        PairList result;
+    /// The pairList size.
+    size_t pairListSize = pairList->listSize;
+    /// The size of the scratch memory.
+    size_t workspaceSize = insertionseries_sort_merge_workspace_size(pairListSize);
 
-        pairlist_copy(&result, pairList);
+    /// The sorted pairList.
+    PairList result;
+    pairlist_init(&result);
+    pairlist_reserve(&result, pairListSize);
+    result.listSize = pairListSize;
 
-        return result;
+    if (pairListSize) {
+        memcpy(result.list, pairList->list, pairListSize * sizeof *result.list);
     }
 
-    /// The pairList size.
-    size_t pairListSize = pairList->listSize;
-    /// The half of pairListSize.
-    size_t halfPairListSize = pairListSize / 2;
+    /// The scratch memory of the merges.
+    void *workspace = arena_workspace_alloc(workspaceSize);
+    /// The arena over the scratch memory.
+    Arena arena;
+    arena_init(&arena, workspace, workspaceSize);
 
-    /// The left part of the input pairList.
-    PairList left;
-    pairlist_init(&left);
-    pairlist_reserve(&left, halfPairListSize);
-    /// The right part of the input pairList.
-    PairList right;
-    pairlist_init(&right);
-    pairlist_reserve(&right, pairListSize - halfPairListSize);
+    insertionseries_sort_recursive_into(result.list, pairListSize, &arena, parallel);
 
-    for(size_t i = 0; i < halfPairListSize; ++i) {
-        pairlist_append(&left, pairList->list[i].index0, pairList->list[i].index1);
+    arena_workspace_free(workspace, workspaceSize);
+
+    return result;
+}
+
+/**
+ * Function that computes the scratch bytes needed by insertionseries_with_workspace.
+ *
+ * @note The size depends on the maximum number of OpenMP threads at the time of the call.
+ *
+ * @param listSize the size of the list where to insert the new values.
+ * @param pairListSize the number of values to insert.
+ * @return the bytes to reserve in the arena.
+ */
+size_t insertionseries_workspace_size(size_t listSize, size_t pairListSize) {
+    return arena_size((listSize + pairListSize) * sizeof(Pair))
+         + insertionseries_sort_merge_workspace_size(listSize + pairListSize);
+}
+
+/**
+ * Function that inserts a list of values at specific positions in a list, without allocating memory.
+ *
+ * @warning The arena must have room for insertionseries_workspace_size(listSize, pairListSize) bytes.
+ *
+ * @details The list and the pairs share a single buffer of pairs: the pairs are sorted in place in its tail, then the whole buffer is merged in place.
+ * @details The arena is left as it was found, so the same memory can be reused by every call with the same sizes.
+ *
+ * @param result the buffer that will contain the listSize + pairListSize values.
+ * @param list the array where to insert the new values.
+ * @param listSize the size of the array.
+ * @param pairList the pairs that contain the positions and the values to insert in the array.
+ * @param pairListSize the number of pairs.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void insertionseries_with_workspace(int *result, const int *list, size_t listSize, const Pair *pairList, size_t pairListSize, Arena *arena, short parallel) {
+    /// The size of the output.
+    size_t resultSize = listSize + pairListSize;
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+
+    /// The pairs of the list - <actual_position, element> - followed by the pairs to insert.
+    Pair *pairs = arena_alloc(arena, resultSize * sizeof(Pair));
+
+    STATS_PHASE_BEGIN(STATS_PHASE_KEYS);
+
+    for(size_t i = 0; i < listSize; ++i) {
+        pairs[i].index0 = (int) i;
+        pairs[i].index1 = list[i];
     }
-    for(size_t i = halfPairListSize; i < pairListSize; ++i) {
-        pairlist_append(&right, pairList->list[i].index0, pairList->list[i].index1);
+
+    if (pairListSize) {
+        memcpy(pairs + listSize, pairList, pairListSize * sizeof *pairs);
     }
 
-    /// The sorted left part of the input pairList.
-    PairList sortedLeft = insertionseries_sort_recursive(&left, parallel);
-    /// The sorted right part of the input pairList
-    PairList sortedRight = insertionseries_sort_recursive(&right, parallel);
-    /// The initial sorted pairList.
-    PairList result = insertionseries_sort_merge(&sortedLeft, &sortedRight, parallel);
+    STATS_PHASE_END(STATS_PHASE_KEYS);
 
-    pairlist_free(&left);
-    pairlist_free(&right);
-    pairlist_free(&sortedLeft);
-    pairlist_free(&sortedRight);
+    // the index is modified: now it is the actual index where the element must be inserted
+    insertionseries_sort_recursive_into(pairs + listSize, pairListSize, arena, parallel);
+    insertionseries_sort_merge_into(pairs, pairs, listSize, pairs + listSize, pairListSize, arena, parallel);
 
-    return result;
+    STATS_PHASE_BEGIN(STATS_PHASE_COPY_OUT);
+
+    for(size_t i = 0; i < resultSize; ++i) {
+        result[i] = pairs[i].index1;
+    }
+
+    STATS_PHASE_END(STATS_PHASE_COPY_OUT);
+
+    arena_release(arena, arenaMark);
 }
 
 /**
@@ -376,34 +910,409 @@ PairList insertionseries_sort_recursive(const PairList *pairList, short parallel
  * @return the new intList with the value inserted.
  */
 IntList insertionseries_merge_after_sort_recursive(const IntList *list, const PairList *pairList, short parallel) {
-    /// The pairList that contains all the value in the list - <actual_position, element>.
-    PairList listPair;
-    pairlist_init(&listPair);
-    pairlist_reserve(&listPair, list->listSize);
-
-    for(size_t i = 0; i < list->listSize; ++i) {
-        pairlist_append(&listPair, (int) i, list->list[i]);
-    }
+    /// The size of the scratch memory.
+    size_t workspaceSize = insertionseries_workspace_size(list->listSize, pairList->listSize);
 
-    /// The pairList of positions where to insert an ordered element.
-    /// @details The index is modified. Now it is the actual index where the element must be inserted.
-    /// @note The pairs are sorted by index.
-    PairList pairListSorted = insertionseries_sort_recursive(pairList, parallel);
-    /// The new sorted pairList containing the original list and the inserted elements.
-    PairList finalPairList = insertionseries_sort_merge(&listPair, &pairListSorted, parallel);
+    /// The scratch memory of the insertion series.
+    void *workspace = arena_workspace_alloc(workspaceSize);
+    /// The arena over the scratch memory.
+    Arena arena;
+    arena_init(&arena, workspace, workspaceSize);
 
     /// The new intList with the value inserted.
     IntList result;
     intlist_init(&result);
-    intlist_reserve(&result, finalPairList.listSize);
+    intlist_reserve(&result, list->listSize + pairList->listSize);
+    result.listSize = list->listSize + pairList->listSize;
 
-    for(size_t i = 0; i < finalPairList.listSize; ++i) {
-        intlist_append(&result, finalPairList.list[i].index1);
-    }
+    insertionseries_with_workspace(result.list, list->list, list->listSize, pairList->list, pairList->listSize, &arena, parallel);
 
-    pairlist_free(&listPair);
-    pairlist_free(&pairListSorted);
-    pairlist_free(&finalPairList);
+    arena_workspace_free(workspace, workspaceSize);
 
     return result;
 }
+
+
+/// The new type representing a batch of insertion series of the same sizes.
+typedef struct {
+    /// The buffer of the results, listSize + pairListSize values per instance.
+    int *result;
+    /// The arrays where to insert the new values, listSize values per instance.
+    const int *list;
+    /// The size of each array.
+    size_t listSize;
+    /// The pairs to insert, pairListSize pairs per instance.
+    const Pair *pairList;
+    /// The number of pairs of each instance.
+    size_t pairListSize;
+} InsertionSeriesBatch;
+
+/**
+ * Function that computes the insertion series of a batch.
+ *
+ * @param batch the batch.
+ * @param instance the index of the insertion series in the batch.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+static void insertionseries_batch_instance(const void *batch, size_t instance, Arena *arena, short parallel) {
+    /// The batch of insertion series.
+    const InsertionSeriesBatch *seriesBatch = batch;
+
+    insertionseries_with_workspace(seriesBatch->result + instance * (seriesBatch->listSize + seriesBatch->pairListSize),
+                                   seriesBatch->list + instance * seriesBatch->listSize, seriesBatch->listSize,
+                                   seriesBatch->pairList + instance * seriesBatch->pairListSize, seriesBatch->pairListSize, arena, parallel);
+}
+
+/**
+ * Function that computes the scratch bytes needed by a batch of insertion series.
+ *
+ * @note The size depends on the maximum number of OpenMP threads at the time of the call.
+ *
+ * @param listSize the size of each array.
+ * @param pairListSize the number of pairs of each instance.
+ * @param instanceNumber the number of instances.
+ * @return the bytes to reserve in the arena.
+ */
+size_t insertionseries_batch_workspace_size(size_t listSize, size_t pairListSize, size_t instanceNumber) {
+    return batchWorkspaceSize(instanceNumber, listSize + pairListSize, insertionseries_workspace_size(listSize, pairListSize));
+}
+
+/**
+ * Function that computes a batch of insertion series, without allocating memory.
+ *
+ * @warning The arena must have room for insertionseries_batch_workspace_size(listSize, pairListSize, instanceNumber) bytes.
+ *
+ * @details In parallel mode small instances are computed one per thread, see batchRun.
+ *
+ * @param result the buffer of instanceNumber results of listSize + pairListSize values, one after the other.
+ * @param list the arrays where to insert the new values, one after the other.
+ * @param listSize the size of each array.
+ * @param pairList the pairs to insert, one instance after the other.
+ * @param pairListSize the number of pairs of each instance.
+ * @param instanceNumber the number of instances.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void insertionseries_batch_with_workspace(int *result, const int *list, size_t listSize, const Pair *pairList, size_t pairListSize, size_t instanceNumber, Arena *arena, short parallel) {
+    /// The batch of insertion series.
+    InsertionSeriesBatch batch = {result, list, listSize, pairList, pairListSize};
+
+    batchRun(insertionseries_batch_instance, &batch, instanceNumber, listSize + pairListSize, insertionseries_workspace_size(listSize, pairListSize), arena, parallel);
+}
+
+/**
+ * Function that computes a batch of insertion series.
+ *
+ * @param result the buffer of instanceNumber results of listSize + pairListSize values, one after the other.
+ * @param list the arrays where to insert the new values, one after the other.
+ * @param listSize the size of each array.
+ * @param pairList the pairs to insert, one instance after the other.
+ * @param pairListSize the number of pairs of each instance.
+ * @param instanceNumber the number of instances.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void insertionseries_batch(int *result, const int *list, size_t listSize, const Pair *pairList, size_t pairListSize, size_t instanceNumber, short parallel) {
+    /// The size of the scratch memory.
+    size_t workspaceSize = insertionseries_batch_workspace_size(listSize, pairListSize, instanceNumber);
+
+    /// The scratch memory of the batch.
+    void *workspace = arena_workspace_alloc(workspaceSize);
+    /// The arena over the scratch memory.
+    Arena arena;
+    arena_init(&arena, workspace, workspaceSize);
+
+    insertionseries_batch_with_workspace(result, list, listSize, pairList, pairListSize, instanceNumber, &arena, parallel);
+
+    arena_workspace_free(workspace, workspaceSize);
+}
+
+
+/**
+ * Function that computes the scratch bytes needed by insertionseries_payload_merge_into.
+ *
+ * @param resultSize the size of the merged runs.
+ * @return the bytes to reserve in the arena.
+ */
+size_t insertionseries_payload_merge_workspace_size(size_t resultSize) {
+    return arena_size(resultSize * sizeof(SortKey))     // keys
+         + prefixSumWorkspaceSize();
+}
+
+/**
+ * Function that writes the final position of each merged insertion.
+ *
+ * @details The final position is the index0 of the key plus the number of previous keys that do not come from the left run.
+ *
+ * @param position the buffer of count positions.
+ * @param key the merged keys.
+ * @param count the number of keys.
+ * @param offset the number of keys before the first one that do not come from the left run.
+ */
+static void insertionseries_payload_positions(int *position, const SortKey *key, size_t count, int offset) {
+    for (size_t i = 0; i < count; ++i) {
+        position[i] = sortKeyIndex0(key[i]) + offset;
+        offset += 1 - sortKeyFromLeft(key[i]);
+    }
+}
+
+/**
+ * Function that merges two adjacent runs of insertions with payloads, in place.
+ *
+ * @warning The arena must have room for insertionseries_payload_merge_workspace_size(leftSize + rightSize) bytes.
+ *
+ * @details The same merge of insertionseries_sort_merge_into: the left run is reversed, the keys are <position, 1, 0> for the left run and <position - j, 0, j> for the right one,
+ * the adapted bitonic network merges them moving the payloads, and the final position of each insertion is its index0 plus the number of previous keys of the right run.
+ * @details In parallel mode the keys and the final positions are computed by the threads from PREFIX_SUM_PARALLEL_CUTOFF insertions, the network from BITONIC_PARALLEL_CUTOFF.
+ *
+ * @param position the positions of the two runs, merged on return.
+ * @param payload the payloads of the two runs, merged on return.
+ * @param leftSize the size of the left run.
+ * @param rightSize the size of the right run.
+ * @param payloadSize the size of each payload.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void insertionseries_payload_merge_into(int *position, unsigned char *payload, size_t leftSize, size_t rightSize, size_t payloadSize, Arena *arena, short parallel) {
+    /// The size of the merged runs.
+    size_t resultSize = leftSize + rightSize;
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+
+    /// The keys of the left run, reversed, followed by the keys of the right one.
+    SortKey *key = arena_alloc(arena, resultSize * sizeof(SortKey));
+
+    STATS_PHASE_BEGIN(STATS_PHASE_KEYS);
+
+    // the left run in descending order, as the bitonic merge expects
+    if (parallel && resultSize >= PREFIX_SUM_PARALLEL_CUTOFF) {
+#pragma omp parallel
+        {
+#pragma omp for schedule(static) nowait
+            for (size_t i = 0; i < leftSize / 2; ++i) {
+                payloadSwap(payload + i * payloadSize, payload + (leftSize - 1 - i) * payloadSize, payloadSize);
+            }
+
+#pragma omp for schedule(static) nowait
+            for (size_t i = 0; i < leftSize; ++i) {
+                key[i] = packSortKey(position[leftSize - 1 - i], 1, 0);
+            }
+
+#pragma omp for schedule(static)
+            // normalize the index 0
+            for (size_t j = 0; j < rightSize; ++j) {
+                key[leftSize + j] = packSortKey(position[leftSize + j] - (int) j, 0, (int) j);
+            }
+        }
+    }
+    else {
+        payloadReverse(payload, leftSize, payloadSize);
+
+        for (size_t i = 0; i < leftSize; ++i) {
+            key[i] = packSortKey(position[leftSize - 1 - i], 1, 0);
+        }
+
+        // normalize the index 0
+        for (size_t j = 0; j < rightSize; ++j) {
+            key[leftSize + j] = packSortKey(position[leftSize + j] - (int) j, 0, (int) j);
+        }
+    }
+
+    STATS_PHASE_END(STATS_PHASE_KEYS);
+
+    STATS_PHASE_BEGIN(STATS_PHASE_NETWORK);
+    payloadBitonicMerge(key, payload, resultSize, payloadSize, parallel);
+    STATS_PHASE_END(STATS_PHASE_NETWORK);
+
+    STATS_PHASE_BEGIN(STATS_PHASE_PREFIX_SUM);
+
+    if (parallel && resultSize >= PREFIX_SUM_PARALLEL_CUTOFF) {
+        /// List of partial sum, one for each thread.
+        int *partialSumList = arena_alloc(arena, (size_t) omp_get_max_threads() * sizeof(int));
+
+#pragma omp parallel
+        {
+            /// Start position.
+            size_t start;
+            /// End position.
+            size_t end;
+            /// The number of keys before the chunk that do not come from the left run.
+            int offset = prefixSumFromLeftInverseTeam(key, resultSize, partialSumList, &start, &end);
+
+            insertionseries_payload_positions(position + start, key + start, end - start, offset);
+        }
+    }
+    else {
+        insertionseries_payload_positions(position, key, resultSize, 0);
+    }
+
+    STATS_PHASE_END(STATS_PHASE_PREFIX_SUM);
+
+    arena_release(arena, arenaMark);
+}
+
+/**
+ * Function that computes the scratch bytes needed by insertionseries_payload_with_workspace.
+ *
+ * @param listSize the size of the list.
+ * @param pairListSize the number of insertions.
+ * @param payloadSize the size of each payload.
+ * @return the bytes to reserve in the arena.
+ */
+size_t insertionseries_payload_workspace_size(size_t listSize, size_t pairListSize, size_t payloadSize) {
+    if (payloadSize == sizeof(int)) {
+        return insertionseries_workspace_size(listSize, pairListSize);
+    }
+
+    return arena_size((listSize + pairListSize) * sizeof(int))        // positions
+         + arena_size((listSize + pairListSize) * payloadSize)        // payloads
+         + insertionseries_payload_merge_workspace_size(listSize + pairListSize);
+}
+
+/**
+ * Function that inserts 4-byte values at specific positions in a list, with the pairs of insertionseries_with_workspace.
+ *
+ * @warning The arena must have room for insertionseries_workspace_size(listSize, pairListSize) bytes.
+ *
+ * @details The values are copied bytewise into the pairs and out of them, so they can be of any 4-byte type.
+ *
+ * @param result the buffer of listSize + pairListSize values.
+ * @param list the listSize values of the list.
+ * @param listSize the size of the list.
+ * @param position the positions of the insertions.
+ * @param value the pairListSize values to insert.
+ * @param pairListSize the number of insertions.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+static void insertionseries_payload_int_with_workspace(void *result, const void *list, size_t listSize, const int *position, const void *value, size_t pairListSize, Arena *arena, short parallel) {
+    /// The size of the output.
+    size_t resultSize = listSize + pairListSize;
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+
+    /// The pairs of the list - <actual_position, element> - followed by the pairs to insert.
+    Pair *pairs = arena_alloc(arena, resultSize * sizeof(Pair));
+
+    STATS_PHASE_BEGIN(STATS_PHASE_KEYS);
+
+    for (size_t i = 0; i < listSize; ++i) {
+        pairs[i].index0 = (int) i;
+        memcpy(&pairs[i].index1, (const unsigned char *) list + i * sizeof(int), sizeof(int));
+    }
+
+    for (size_t j = 0; j < pairListSize; ++j) {
+        pairs[listSize + j].index0 = position[j];
+        memcpy(&pairs[listSize + j].index1, (const unsigned char *) value + j * sizeof(int), sizeof(int));
+    }
+
+    STATS_PHASE_END(STATS_PHASE_KEYS);
+
+    insertionseries_sort_recursive_into(pairs + listSize, pairListSize, arena, parallel);
+    insertionseries_sort_merge_into(pairs, pairs, listSize, pairs + listSize, pairListSize, arena, parallel);
+
+    STATS_PHASE_BEGIN(STATS_PHASE_COPY_OUT);
+
+    for (size_t i = 0; i < resultSize; ++i) {
+        memcpy((unsigned char *) result + i * sizeof(int), &pairs[i].index1, sizeof(int));
+    }
+
+    STATS_PHASE_END(STATS_PHASE_COPY_OUT);
+
+    arena_release(arena, arenaMark);
+}
+
+/**
+ * Function that inserts values of any size at specific positions in a list, without allocating memory.
+ *
+ * @warning The arena must have room for insertionseries_payload_workspace_size(listSize, pairListSize, payloadSize) bytes.
+ *
+ * @details The values are payloads of payloadSize bytes: 1, 2, 4 or 8 bytes for the integer types, any size for records.
+ * @details The 4-byte payloads are the values of the pairs of insertionseries_with_workspace, so they take the vectorized path of the integers and its active merging network.
+ * @details The other payloads are sorted by insertionseries_sort_elements_into, then merged with the list, always with the adapted bitonic network:
+ * only the 64-bit keys are compared and each payload is moved at its own width by the comparators, see payloadMinMaxStage, so there is neither a widening to int nor a second pass.
+ * @details The memory accesses do not depend on the positions nor on the values.
+ *
+ * @param result the buffer of listSize + pairListSize payloads.
+ * @param list the listSize payloads of the list.
+ * @param listSize the size of the list.
+ * @param position the positions of the insertions, each one in the list after the previous insertions.
+ * @param value the pairListSize payloads to insert.
+ * @param pairListSize the number of insertions.
+ * @param payloadSize the size of each payload.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void insertionseries_payload_with_workspace(void *result, const void *list, size_t listSize, const int *position, const void *value, size_t pairListSize, size_t payloadSize, Arena *arena, short parallel) {
+    if (payloadSize == sizeof(int)) {
+        insertionseries_payload_int_with_workspace(result, list, listSize, position, value, pairListSize, arena, parallel);
+        return;
+    }
+
+    /// The size of the output.
+    size_t resultSize = listSize + pairListSize;
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+
+    /// The positions of the list followed by the positions of the insertions.
+    int *elementPosition = arena_alloc(arena, resultSize * sizeof(int));
+    /// The payloads of the list followed by the payloads of the insertions.
+    unsigned char *payload = arena_alloc(arena, resultSize * payloadSize);
+
+    STATS_PHASE_BEGIN(STATS_PHASE_KEYS);
+
+    for (size_t i = 0; i < listSize; ++i) {
+        elementPosition[i] = (int) i;
+    }
+
+    if (listSize) {
+        memcpy(payload, list, listSize * payloadSize);
+    }
+
+    if (pairListSize) {
+        memcpy(elementPosition + listSize, position, pairListSize * sizeof(int));
+        memcpy(payload + listSize * payloadSize, value, pairListSize * payloadSize);
+    }
+
+    STATS_PHASE_END(STATS_PHASE_KEYS);
+
+    insertionseries_sort_elements_into((InsertionElements) {NULL, elementPosition + listSize, payload + listSize * payloadSize, payloadSize}, pairListSize, arena, parallel);
+    insertionseries_payload_merge_into(elementPosition, payload, listSize, pairListSize, payloadSize, arena, parallel);
+
+    STATS_PHASE_BEGIN(STATS_PHASE_COPY_OUT);
+
+    if (resultSize) {
+        memcpy(result, payload, resultSize * payloadSize);
+    }
+
+    STATS_PHASE_END(STATS_PHASE_COPY_OUT);
+
+    arena_release(arena, arenaMark);
+}
+
+/**
+ * Function that inserts values of any size at specific positions in a list.
+ *
+ * @param result the buffer of listSize + pairListSize payloads.
+ * @param list the listSize payloads of the list.
+ * @param listSize the size of the list.
+ * @param position the positions of the insertions, each one in the list after the previous insertions.
+ * @param value the pairListSize payloads to insert.
+ * @param pairListSize the number of insertions.
+ * @param payloadSize the size of each payload.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void insertionseries_payload(void *result, const void *list, size_t listSize, const int *position, const void *value, size_t pairListSize, size_t payloadSize, short parallel) {
+    /// The size of the scratch memory.
+    size_t workspaceSize = insertionseries_payload_workspace_size(listSize, pairListSize, payloadSize);
+
+    /// The scratch memory of the insertion series.
+    void *workspace = arena_workspace_alloc(workspaceSize);
+    /// The arena over the scratch memory.
+    Arena arena;
+    arena_init(&arena, workspace, workspaceSize);
+
+    insertionseries_payload_with_workspace(result, list, listSize, position, value, pairListSize, payloadSize, &arena, parallel);
+
+    arena_workspace_free(workspace, workspaceSize);
+}
@@ -4,28 +4,83 @@
 
 #include <omp.h>
 #include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
 
 #include "../utility/tuple.h"
 #include "../utility/intList.h"
 #include "../utility/pairList.h"
+#include "../utility/quadrupleArray.h"
+#include "../utility/arena.h"
+#include "../utility/batch.h"
 #include "../utility/bitonicSort.h"
+#include "../utility/mergeNetwork.h"
+#include "../utility/payloadNetwork.h"
+#include "../utility/scanKernel.h"
 
 
-#define PARALLEL 1
-#define SERIAL 0
+/// The number of elements below which a subtree of the sorting recursion is sorted serially by a single thread.
+#define SORT_TASK_CUTOFF 4096
+/// The number of elements below which a prefix sum is computed serially even in parallel mode.
+#define PREFIX_SUM_PARALLEL_CUTOFF 16384
+/// The alignment, in elements, of the chunks of the parallel prefix sums.
+#define PREFIX_SUM_ALIGNMENT 16
 
 
+/// The new type representing the insertions sorted by the bottom-up recursion, either pairs or positions with payloads of any size.
+typedef struct {
+    /// The pairs, NULL if the insertions are positions with payloads.
+    Pair *pairList;
+    /// The positions of the insertions, NULL for pairs.
+    int *position;
+    /// The payloads of the positions, NULL for pairs.
+    unsigned char *payload;
+    /// The size of each payload.
+    size_t payloadSize;
+} InsertionElements;
+
+
+size_t prefixSumWorkspaceSize(void);
+void prefixSumInto(int *result, const int *list, size_t listSize, Arena *arena, short parallel);
+void prefixSumSerialInto(int *result, const int *list, size_t listSize);
+void prefixSumParallelInto(int *result, const int *list, size_t listSize, Arena *arena);
+void prefixSumFromLeftInverseInto(int *result, const SortKey *key, size_t keySize, Arena *arena, short parallel);
+void prefixSumFromLeftInverseSerialInto(int *result, const SortKey *key, size_t keySize);
+void prefixSumFromLeftInverseParallelInto(int *result, const SortKey *key, size_t keySize, Arena *arena);
+int prefixSumFromLeftInverseTeam(const SortKey *key, size_t keySize, int *partialSumList, size_t *start, size_t *end);
+void prefixSumChunk(size_t size, size_t *start, size_t *end);
+int prefixSumOffsetTeam(int chunkSum, int *partialSumList);
+
 IntList prefixSum(const IntList *list, short parallel);
 IntList prefixSumSerial(const IntList *list);
 IntList prefixSumParallel(const IntList *list);
 
-Quadruple *merge(Quadruple *firstList, size_t firstListSize, Quadruple *secondList, size_t secondListSize, short parallel);
-Quadruple *mergeSerial(Quadruple *firstList, size_t firstListSize, Quadruple *secondList, size_t secondListSize);
-Quadruple *mergeParallel(Quadruple *firstList, size_t firstListSize, Quadruple *secondList, size_t secondListSize);
+QuadrupleArray merge(const QuadrupleArray *firstList, const QuadrupleArray *secondList, short parallel);
+QuadrupleArray mergeSerial(const QuadrupleArray *firstList, const QuadrupleArray *secondList);
+QuadrupleArray mergeParallel(const QuadrupleArray *firstList, const QuadrupleArray *secondList);
 
+void insertionseries_emit_merged(Pair *result, const SortKey *key, const int *value, size_t size, Arena *arena, short parallel);
+size_t insertionseries_sort_merge_workspace_size(size_t resultSize);
+void insertionseries_sort_merge_into(Pair *result, const Pair *firstList, size_t firstListSize, const Pair *secondList, size_t secondListSize, Arena *arena, short parallel);
 PairList insertionseries_sort_merge(const PairList *firstList, const PairList *secondList, short parallel);
+int sortThreadNumber(size_t taskNumber, size_t taskWorkspaceSize, const Arena *arena);
+size_t insertionseries_sort_blocks(InsertionElements elements, size_t size, Arena *arena);
+void insertionseries_sort_level(InsertionElements elements, size_t size, size_t width, Arena *arena, short parallel);
+void insertionseries_sort_elements_into(InsertionElements elements, size_t size, Arena *arena, short parallel);
+void insertionseries_sort_recursive_into(Pair *pairList, size_t pairListSize, Arena *arena, short parallel);
 PairList insertionseries_sort_recursive(const PairList *pairList, short parallel);
+size_t insertionseries_workspace_size(size_t listSize, size_t pairListSize);
+void insertionseries_with_workspace(int *result, const int *list, size_t listSize, const Pair *pairList, size_t pairListSize, Arena *arena, short parallel);
 IntList insertionseries_merge_after_sort_recursive(const IntList *list, const PairList *pairList, short parallel);
+size_t insertionseries_batch_workspace_size(size_t listSize, size_t pairListSize, size_t instanceNumber);
+void insertionseries_batch_with_workspace(int *result, const int *list, size_t listSize, const Pair *pairList, size_t pairListSize, size_t instanceNumber, Arena *arena, short parallel);
+void insertionseries_batch(int *result, const int *list, size_t listSize, const Pair *pairList, size_t pairListSize, size_t instanceNumber, short parallel);
+size_t insertionseries_payload_merge_workspace_size(size_t resultSize);
+void insertionseries_payload_merge_into(int *position, unsigned char *payload, size_t leftSize, size_t rightSize, size_t payloadSize, Arena *arena, short parallel);
+size_t insertionseries_payload_workspace_size(size_t listSize, size_t pairListSize, size_t payloadSize);
+void insertionseries_payload_with_workspace(void *result, const void *list, size_t listSize, const int *position, const void *value, size_t pairListSize, size_t payloadSize, Arena *arena, short parallel);
+void insertionseries_payload(void *result, const void *list, size_t listSize, const int *position, const void *value, size_t pairListSize, size_t payloadSize, short parallel);
 
 
 #define insertionseries insertionseries_merge_after_sort_recursive
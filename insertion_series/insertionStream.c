@@ -0,0 +1,171 @@
+#include "insertionStream.h"
+
+
+/**
+ * Function that initializes an empty insertion stream.
+ *
+ * @param stream the insertion stream to initialize.
+ */
+void insertionstream_init(InsertionStream *stream) {
+    pairlist_init(&stream->pairList);
+    stream->workspace = NULL;
+    stream->workspaceSize = 0;
+}
+
+/**
+ * Function that pushes an insertion at the end of the stream.
+ *
+ * @details The insertion is a run of one pair; then, as in a binary counter, the two newest runs are merged while they have the same size,
+ * with the same merge of the bottom-up recursion of insertionseries_sort_recursive_into, in place.
+ * @details The result does not depend on where the pairs are split, so after n pushes the runs are the subtrees of the recursion over the sizes of the binary digits of n:
+ * each pair takes part in a merge of at most log2(n) levels, and the merges of a level cost the network of twice the size of its runs.
+ * @details A merge of two runs of r pairs costs about r * log2(2r) comparators, so a push costs amortized O(log^2(n)) comparators,
+ * not the O(log(n)) of an insertion into a balanced tree: each level of a pair costs the log2 depth of its bitonic merge.
+ *
+ * @param stream the insertion stream.
+ * @param position the position of the value in the list after all the previous insertions.
+ * @param value the value to insert.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void insertionstream_push(InsertionStream *stream, int position, int value, short parallel) {
+    pairlist_append(&stream->pairList, position, value);
+
+    /// The number of pairs.
+    size_t pairListSize = stream->pairList.listSize;
+
+    // the runs to merge are as many as the trailing zeros of the number of pairs
+    for (size_t runSize = 1; !(pairListSize & runSize); runSize *= 2) {
+        /// The scratch bytes of the merge.
+        size_t workspaceSize = insertionseries_sort_merge_workspace_size(2 * runSize);
+
+        if (workspaceSize > stream->workspaceSize) {
+            arena_workspace_free(stream->workspace, stream->workspaceSize);
+            stream->workspace = arena_workspace_alloc(workspaceSize);
+            stream->workspaceSize = workspaceSize;
+        }
+
+        /// The arena over the scratch memory.
+        Arena arena;
+        arena_init(&arena, stream->workspace, stream->workspaceSize);
+        /// The first pair of the older run.
+        Pair *run = &stream->pairList.list[pairListSize - 2 * runSize];
+
+        insertionseries_sort_merge_into(run, run, runSize, run + runSize, runSize, &arena, parallel);
+    }
+}
+
+/**
+ * Function that computes the scratch bytes needed by insertionstream_apply_with_workspace.
+ *
+ * @note The size depends on the maximum number of OpenMP threads at the time of the call.
+ *
+ * @param stream the insertion stream.
+ * @param listSize the size of the list where to insert the values.
+ * @return the bytes to reserve in the arena.
+ */
+size_t insertionstream_apply_workspace_size(const InsertionStream *stream, size_t listSize) {
+    return arena_size((listSize + stream->pairList.listSize) * sizeof(Pair))
+         + insertionseries_sort_merge_workspace_size(listSize + stream->pairList.listSize);
+}
+
+/**
+ * Function that inserts the values of the stream in a list, without allocating memory.
+ *
+ * @warning The arena must have room for insertionstream_apply_workspace_size(stream, listSize) bytes.
+ *
+ * @details The runs are copied after the pairs of the list and merged there, from the newest to the oldest, then merged with the list as in insertionseries_with_workspace.
+ * @details The stream is not modified, so it can receive more insertions and be applied again.
+ *
+ * @param result the buffer that will contain the listSize + number of insertions values.
+ * @param stream the insertion stream.
+ * @param list the array where to insert the new values.
+ * @param listSize the size of the array.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void insertionstream_apply_with_workspace(int *result, const InsertionStream *stream, const int *list, size_t listSize, Arena *arena, short parallel) {
+    /// The number of pairs.
+    size_t pairListSize = stream->pairList.listSize;
+    /// The size of the output.
+    size_t resultSize = listSize + pairListSize;
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+
+    /// The pairs of the list - <actual_position, element> - followed by the runs.
+    Pair *pairs = arena_alloc(arena, resultSize * sizeof(Pair));
+
+    for (size_t i = 0; i < listSize; ++i) {
+        pairs[i].index0 = (int) i;
+        pairs[i].index1 = list[i];
+    }
+
+    if (pairListSize) {
+        memcpy(pairs + listSize, stream->pairList.list, pairListSize * sizeof *pairs);
+    }
+
+    /// The pairs of the stream.
+    Pair *run = pairs + listSize;
+    /// The first pair of the runs already merged, from the newest one.
+    size_t mergedStart = pairListSize;
+
+    // the runs from the newest, that is the binary digits of the number of pairs from the lowest
+    for (size_t runSize = 1; runSize <= pairListSize; runSize *= 2) {
+        if (pairListSize & runSize) {
+            if (mergedStart < pairListSize) {
+                insertionseries_sort_merge_into(&run[mergedStart - runSize], &run[mergedStart - runSize], runSize, &run[mergedStart], pairListSize - mergedStart, arena, parallel);
+            }
+
+            mergedStart -= runSize;
+        }
+    }
+
+    insertionseries_sort_merge_into(pairs, pairs, listSize, run, pairListSize, arena, parallel);
+
+    for (size_t i = 0; i < resultSize; ++i) {
+        result[i] = pairs[i].index1;
+    }
+
+    arena_release(arena, arenaMark);
+}
+
+/**
+ * Function that inserts the values of the stream in an intList.
+ *
+ * @param stream the insertion stream.
+ * @param list the intList where to insert the new values.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ * @return the new intList with the values inserted.
+ */
+IntList insertionstream_apply(const InsertionStream *stream, const IntList *list, short parallel) {
+    /// The size of the scratch memory.
+    size_t workspaceSize = insertionstream_apply_workspace_size(stream, list->listSize);
+
+    /// The scratch memory of the insertion series.
+    void *workspace = arena_workspace_alloc(workspaceSize);
+    /// The arena over the scratch memory.
+    Arena arena;
+    arena_init(&arena, workspace, workspaceSize);
+
+    /// The new intList with the values inserted.
+    IntList result;
+    intlist_init(&result);
+    intlist_reserve(&result, list->listSize + stream->pairList.listSize);
+    result.listSize = list->listSize + stream->pairList.listSize;
+
+    insertionstream_apply_with_workspace(result.list, stream, list->list, list->listSize, &arena, parallel);
+
+    arena_workspace_free(workspace, workspaceSize);
+
+    return result;
+}
+
+/**
+ * Function that frees the memory of an insertion stream.
+ *
+ * @param stream the insertion stream.
+ */
+void insertionstream_free(InsertionStream *stream) {
+    pairlist_free(&stream->pairList);
+    arena_workspace_free(stream->workspace, stream->workspaceSize);
+    insertionstream_init(stream);
+}
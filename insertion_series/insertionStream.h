@@ -0,0 +1,32 @@
+#ifndef DJB_INSERTIONSTREAM_H
+#define DJB_INSERTIONSTREAM_H
+
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "insertionSeries.h"
+
+
+/// The new type representing an insertion series that receives its insertions one at a time.
+typedef struct {
+    /// The pairs pushed, grouped in sorted runs whose sizes are the binary digits of their number, the oldest and largest run first.
+    PairList pairList;
+    /// The scratch memory of the merges of the runs.
+    void *workspace;
+    /// The size of the scratch memory.
+    size_t workspaceSize;
+} InsertionStream;
+
+
+void insertionstream_init(InsertionStream *stream);
+void insertionstream_push(InsertionStream *stream, int position, int value, short parallel);
+size_t insertionstream_apply_workspace_size(const InsertionStream *stream, size_t listSize);
+void insertionstream_apply_with_workspace(int *result, const InsertionStream *stream, const int *list, size_t listSize, Arena *arena, short parallel);
+IntList insertionstream_apply(const InsertionStream *stream, const IntList *list, short parallel);
+void insertionstream_free(InsertionStream *stream);
+
+
+#endif //DJB_INSERTIONSTREAM_H
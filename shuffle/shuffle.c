@@ -0,0 +1,188 @@
+#include "shuffle.h"
+
+
+/**
+ * Function that computes the scratch bytes needed by ct_shuffle_with_workspace.
+ *
+ * @param arraySize the number of elements.
+ * @param elementSize the size of each element, 0 if only the permutation is needed.
+ * @param withPermutation 1 if the permutation is returned, 0 otherwise.
+ * @return the bytes to reserve in the arena.
+ */
+size_t ct_shuffle_workspace_size(size_t arraySize, size_t elementSize, short withPermutation) {
+    /// The size of the payload of each element.
+    size_t payloadSize = elementSize + (withPermutation ? sizeof(int) : 0);
+    /// The bytes needed by the random stream of the positions.
+    size_t sampleSize = arena_size(arraySize * SAMPLE_RANDOM_BYTES);
+    /// The bytes needed by the insertion series: the pairs of the int path, or the payloads.
+    size_t insertionSize = !elementSize || (elementSize == sizeof(int) && !withPermutation)
+                         ? arena_size(arraySize * sizeof(Pair)) + insertionseries_workspace_size(0, arraySize)
+                         : (withPermutation ? arena_size(arraySize * payloadSize) : 0) + insertionseries_payload_workspace_size(0, arraySize, payloadSize);
+
+    return arena_size(arraySize * sizeof(int)) + (sampleSize > insertionSize ? sampleSize : insertionSize);
+}
+
+/**
+ * Function that samples the insertion positions of a random permutation.
+ *
+ * @details The position i is uniform in [0, i] up to a bias below (i + 1) / 2^64: the 8 random bytes of each position are reduced by multiplication and shift, without rejection, in a single batch, see multiplyShiftRange.
+ *
+ * @param position the buffer of arraySize positions.
+ * @param arraySize the number of positions.
+ * @param source the source of the random bytes.
+ * @param arena the arena that has room for arena_size(arraySize * SAMPLE_RANDOM_BYTES) bytes.
+ */
+void ct_shuffle_positions(int *position, size_t arraySize, ByteSource *source, Arena *arena) {
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+
+    /// The random stream of the positions.
+    unsigned char *random = arena_alloc(arena, arraySize * SAMPLE_RANDOM_BYTES);
+
+    source->generate(source->state, random, arraySize * SAMPLE_RANDOM_BYTES);
+    multiplyShiftRange(position, random, arraySize, 1);
+
+    arena_release(arena, arenaMark);
+}
+
+/**
+ * Function that shuffles an array in constant time, without allocating memory.
+ *
+ * @warning The arena must have room for ct_shuffle_workspace_size(arraySize, elementSize, permutation != NULL) bytes.
+ * @warning The array must have less than 2^30 elements.
+ *
+ * @details The element i is inserted at the position X[i] uniform in [0, i] of the elements before it: every sequence of positions gives a different permutation, so the permutation is uniform.
+ * @details The insertions are an insertion series over an empty list, with the elements as payloads, see insertionseries_payload_with_workspace:
+ * the memory accesses do not depend on the positions nor on the elements, unlike Fisher-Yates.
+ * @details When only the permutation is requested, or the elements are 4 bytes without the permutation, the insertions are the pairs <X[i], i> or <X[i], element i> of insertionseries_with_workspace, the vectorized int path.
+ * @details Otherwise, if the permutation is requested, the index of each element is appended to its payload, so both are moved by the same network.
+ *
+ * @param array the arraySize elements to shuffle in place, NULL if elementSize is 0.
+ * @param arraySize the number of elements.
+ * @param elementSize the size of each element, 0 if only the permutation is needed.
+ * @param permutation the buffer of arraySize indexes that will contain the original index of each shuffled element, or NULL.
+ * @param source the source of the random bytes.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void ct_shuffle_with_workspace(void *array, size_t arraySize, size_t elementSize, int *permutation, ByteSource *source, Arena *arena, short parallel) {
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+
+    /// The insertion positions.
+    int *position = arena_alloc(arena, arraySize * sizeof(int));
+
+    ct_shuffle_positions(position, arraySize, source, arena);
+
+    if (!elementSize || (elementSize == sizeof(int) && !permutation)) {
+        /// The insertions - <X[i], index or element>.
+        Pair *pairs = arena_alloc(arena, arraySize * sizeof(Pair));
+        /// The shuffled values, the positions are no longer needed once the pairs are built.
+        int *shuffled = permutation ? permutation : position;
+
+        for (size_t i = 0; i < arraySize; ++i) {
+            pairs[i].index0 = position[i];
+            pairs[i].index1 = (int) i;
+
+            if (elementSize) {
+                memcpy(&pairs[i].index1, (unsigned char *) array + i * sizeof(int), sizeof(int));
+            }
+        }
+
+        insertionseries_with_workspace(shuffled, NULL, 0, pairs, arraySize, arena, parallel);
+
+        if (elementSize && arraySize) {
+            memcpy(array, shuffled, arraySize * sizeof(int));
+        }
+
+        arena_release(arena, arenaMark);
+
+        return;
+    }
+
+    if (!permutation) {
+        // the payloads are the elements, shuffled in place
+        insertionseries_payload_with_workspace(array, NULL, 0, position, array, arraySize, elementSize, arena, parallel);
+        arena_release(arena, arenaMark);
+
+        return;
+    }
+
+    /// The size of each payload: the element followed by its index.
+    size_t payloadSize = elementSize + sizeof(int);
+    /// The payloads.
+    unsigned char *payload = arena_alloc(arena, arraySize * payloadSize);
+
+    for (size_t i = 0; i < arraySize; ++i) {
+        /// The index of the element.
+        int index = (int) i;
+
+        if (elementSize) {
+            memcpy(payload + i * payloadSize, (unsigned char *) array + i * elementSize, elementSize);
+        }
+
+        memcpy(payload + i * payloadSize + elementSize, &index, sizeof index);
+    }
+
+    insertionseries_payload_with_workspace(payload, NULL, 0, position, payload, arraySize, payloadSize, arena, parallel);
+
+    for (size_t i = 0; i < arraySize; ++i) {
+        if (elementSize) {
+            memcpy((unsigned char *) array + i * elementSize, payload + i * payloadSize, elementSize);
+        }
+
+        memcpy(&permutation[i], payload + i * payloadSize + elementSize, sizeof *permutation);
+    }
+
+    arena_release(arena, arenaMark);
+}
+
+/**
+ * Function that shuffles an array in constant time from a seed.
+ *
+ * @details The positions are sampled from the ChaCha20 keystream with the seed as key, a zero nonce and a zero block counter, so the same seed always gives the same permutation.
+ *
+ * @param array the arraySize elements to shuffle in place, NULL if elementSize is 0.
+ * @param arraySize the number of elements.
+ * @param elementSize the size of each element, 0 if only the permutation is needed.
+ * @param seed the CHACHA20_KEY_SIZE bytes of the seed.
+ * @param permutation the buffer of arraySize indexes that will contain the original index of each shuffled element, or NULL.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void ct_shuffle(void *array, size_t arraySize, size_t elementSize, const unsigned char *seed, int *permutation, short parallel) {
+    /// The nonce of the keystream.
+    const unsigned char nonce[CHACHA20_NONCE_SIZE] = {0};
+    /// The keystream of the seed.
+    ChaCha20 chacha;
+    chacha20_init(&chacha, seed, nonce, 0);
+    /// The source over the keystream.
+    ByteSource source = chacha20_source(&chacha);
+
+    /// The size of the scratch memory.
+    size_t workspaceSize = ct_shuffle_workspace_size(arraySize, elementSize, permutation != NULL);
+
+    /// The scratch memory of the shuffle.
+    void *workspace = arena_workspace_alloc(workspaceSize);
+    /// The arena over the scratch memory.
+    Arena arena;
+    arena_init(&arena, workspace, workspaceSize);
+
+    ct_shuffle_with_workspace(array, arraySize, elementSize, permutation, &source, &arena, parallel);
+
+    arena_workspace_free(workspace, workspaceSize);
+    memset(&chacha, 0, sizeof chacha);
+}
+
+/**
+ * Function that draws a random permutation in constant time from a seed.
+ *
+ * @details The permutation is the one ct_shuffle applies with the same seed: the shuffled element i is the original element permutation[i].
+ *
+ * @param permutation the buffer of arraySize indexes.
+ * @param arraySize the number of indexes.
+ * @param seed the CHACHA20_KEY_SIZE bytes of the seed.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void ct_permutation(int *permutation, size_t arraySize, const unsigned char *seed, short parallel) {
+    ct_shuffle(NULL, arraySize, 0, seed, permutation, parallel);
+}
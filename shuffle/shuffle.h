@@ -0,0 +1,24 @@
+#ifndef DJB_SHUFFLE_H
+#define DJB_SHUFFLE_H
+
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "../utility/arena.h"
+#include "../utility/chacha20.h"
+#include "../utility/sampleKernel.h"
+#include "../insertion_series/insertionSeries.h"
+
+
+size_t ct_shuffle_workspace_size(size_t arraySize, size_t elementSize, short withPermutation);
+void ct_shuffle_positions(int *position, size_t arraySize, ByteSource *source, Arena *arena);
+void ct_shuffle_with_workspace(void *array, size_t arraySize, size_t elementSize, int *permutation, ByteSource *source, Arena *arena, short parallel);
+void ct_shuffle(void *array, size_t arraySize, size_t elementSize, const unsigned char *seed, int *permutation, short parallel);
+void ct_permutation(int *permutation, size_t arraySize, const unsigned char *seed, short parallel);
+
+
+#endif //DJB_SHUFFLE_H
@@ -0,0 +1,122 @@
+#include "arena.h"
+
+
+/**
+ * Function that initializes the arena over a memory block.
+ *
+ * @note The arena never allocates nor frees the memory block, it belongs to the caller.
+ *
+ * @param arena the arena to initialize.
+ * @param memory the memory block, it should be aligned to ARENA_ALIGNMENT.
+ * @param arenaSize the size of the memory block.
+ */
+void arena_init(Arena *arena, void *memory, size_t arenaSize) {
+    arena->memory = memory;
+    arena->arenaSize = arenaSize;
+    arena->arenaUsed = 0;
+}
+
+/**
+ * Function that allocates a block from the arena.
+ *
+ * @warning The arena must have room for the block, arena_size gives the bytes needed by each block.
+ *
+ * @details The block starts at the first offset multiple of ARENA_ALIGNMENT.
+ *
+ * @param arena the arena.
+ * @param size the size of the block.
+ * @return the pointer to the block.
+ */
+void *arena_alloc(Arena *arena, size_t size) {
+    /// The offset of the block.
+    size_t offset = arena->arenaUsed;
+
+    assert(arena_size(size) <= arena->arenaSize - offset && "Arena exhausted!!!");
+
+    arena->arenaUsed = offset + arena_size(size);
+    STATS_ARENA_USED(arena->arenaUsed);
+
+    return arena->memory + offset;
+}
+
+/**
+ * Function that returns the current position of the arena.
+ *
+ * @param arena the arena.
+ * @return the mark to pass to arena_release.
+ */
+size_t arena_mark(const Arena *arena) {
+    return arena->arenaUsed;
+}
+
+/**
+ * Function that returns the number of bytes that can still be allocated.
+ *
+ * @param arena the arena.
+ * @return the bytes not yet in use.
+ */
+size_t arena_available(const Arena *arena) {
+    return arena->arenaSize - arena->arenaUsed;
+}
+
+/**
+ * Function that frees all the blocks allocated after a mark.
+ *
+ * @param arena the arena.
+ * @param mark the mark returned by arena_mark.
+ */
+void arena_release(Arena *arena, size_t mark) {
+    assert(mark <= arena->arenaUsed);
+
+    arena->arenaUsed = mark;
+}
+
+/**
+ * Function that computes the bytes taken in the arena by a block.
+ *
+ * @param size the size of the block.
+ * @return the size rounded up to a multiple of ARENA_ALIGNMENT.
+ */
+size_t arena_size(size_t size) {
+    return (size + ARENA_ALIGNMENT - 1) & ~(size_t) (ARENA_ALIGNMENT - 1);
+}
+
+/**
+ * Function that allocates the scratch memory of an arena.
+ *
+ * @details The memory is aligned to ARENA_ALIGNMENT, an empty workspace still gets a block so the pointer is never NULL.
+ *
+ * @param workspaceSize the size of the scratch memory, a multiple of ARENA_ALIGNMENT as the sums of arena_size.
+ * @return the scratch memory, to release with arena_workspace_free.
+ */
+void *arena_workspace_alloc(size_t workspaceSize) {
+    STATS_PHASE_BEGIN(STATS_PHASE_ALLOCATION);
+
+    /// The scratch memory.
+    void *workspace = aligned_alloc(ARENA_ALIGNMENT, workspaceSize ? workspaceSize : ARENA_ALIGNMENT);
+    assert(workspace && "Malloc error!!!");
+
+    STATS_ALLOCATE(workspaceSize);
+    STATS_PHASE_END(STATS_PHASE_ALLOCATION);
+
+    return workspace;
+}
+
+/**
+ * Function that releases the scratch memory of an arena.
+ *
+ * @param workspace the scratch memory returned by arena_workspace_alloc, or NULL.
+ * @param workspaceSize the size passed to arena_workspace_alloc.
+ */
+void arena_workspace_free(void *workspace, size_t workspaceSize) {
+    if (!workspace) {
+        return;
+    }
+
+    STATS_PHASE_BEGIN(STATS_PHASE_ALLOCATION);
+
+    free(workspace);
+
+    STATS_DEALLOCATE(workspaceSize);
+    STATS_PHASE_END(STATS_PHASE_ALLOCATION);
+}
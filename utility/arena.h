@@ -0,0 +1,37 @@
+#ifndef DJB_ARENA_H
+#define DJB_ARENA_H
+
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "stats.h"
+
+
+/// The alignment of every block returned by the arena, a cache line.
+#define ARENA_ALIGNMENT 64
+
+
+/// The new type representing a stack allocator over a caller-owned memory block.
+typedef struct {
+    /// The memory block, it should be aligned to ARENA_ALIGNMENT.
+    unsigned char *memory;
+    /// The size of the memory block.
+    size_t arenaSize;
+    /// The number of bytes currently in use.
+    size_t arenaUsed;
+} Arena;
+
+
+void arena_init(Arena *arena, void *memory, size_t arenaSize);
+void *arena_alloc(Arena *arena, size_t size);
+size_t arena_mark(const Arena *arena);
+size_t arena_available(const Arena *arena);
+void arena_release(Arena *arena, size_t mark);
+size_t arena_size(size_t size);
+void *arena_workspace_alloc(size_t workspaceSize);
+void arena_workspace_free(void *workspace, size_t workspaceSize);
+
+
+#endif //DJB_ARENA_H
@@ -0,0 +1,86 @@
+#include "batch.h"
+
+
+/**
+ * Function that computes the number of threads that build the instances of a batch side by side.
+ *
+ * @details Small instances are built one per thread, serially, so there is a single parallel region per batch and none inside the instances;
+ * from BATCH_INSTANCE_CUTOFF elements an instance is big enough to use the whole team, so the instances are built one after the other.
+ *
+ * @param instanceNumber the number of instances.
+ * @param instanceSize the number of elements of each instance.
+ * @return the number of threads, 1 when the instances are built one after the other.
+ */
+int batchThreadNumber(size_t instanceNumber, size_t instanceSize) {
+    /// The number of threads of the team.
+    int threadNumber = omp_get_max_threads();
+
+    if (instanceSize >= BATCH_INSTANCE_CUTOFF || instanceNumber < 2) {
+        return 1;
+    }
+
+    return instanceNumber < (size_t) threadNumber ? (int) instanceNumber : threadNumber;
+}
+
+/**
+ * Function that computes the scratch bytes needed by a batch.
+ *
+ * @note The size depends on the maximum number of OpenMP threads at the time of the call.
+ *
+ * @param instanceNumber the number of instances.
+ * @param instanceSize the number of elements of each instance.
+ * @param instanceWorkspaceSize the scratch bytes needed by each instance, a multiple of ARENA_ALIGNMENT.
+ * @return the bytes to reserve in the arena: one instance workspace for each thread.
+ */
+size_t batchWorkspaceSize(size_t instanceNumber, size_t instanceSize, size_t instanceWorkspaceSize) {
+    return (size_t) batchThreadNumber(instanceNumber, instanceSize) * instanceWorkspaceSize;
+}
+
+/**
+ * Function that builds every instance of a batch.
+ *
+ * @warning The arena must have room for batchWorkspaceSize(instanceNumber, instanceSize, instanceWorkspaceSize) bytes.
+ *
+ * @details In parallel mode each thread gets its own arena, a slice of instanceWorkspaceSize bytes, and builds a contiguous range of instances serially.
+ * @details Otherwise, or for big instances, the instances are built one after the other with the arena of the batch and the given mode.
+ *
+ * @param build the function that builds an instance.
+ * @param batch the description of the batch, passed to build.
+ * @param instanceNumber the number of instances.
+ * @param instanceSize the number of elements of each instance.
+ * @param instanceWorkspaceSize the scratch bytes needed by each instance, a multiple of ARENA_ALIGNMENT.
+ * @param arena the arena of the scratch buffers.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void batchRun(BatchInstance build, const void *batch, size_t instanceNumber, size_t instanceSize, size_t instanceWorkspaceSize, Arena *arena, short parallel) {
+    /// The number of threads that build the instances side by side.
+    int threadNumber = parallel ? batchThreadNumber(instanceNumber, instanceSize) : 1;
+
+    if (threadNumber == 1) {
+        for (size_t i = 0; i < instanceNumber; ++i) {
+            build(batch, i, arena, parallel);
+        }
+
+        return;
+    }
+
+    /// The position of the arena to restore.
+    size_t arenaMark = arena_mark(arena);
+
+    /// The scratch memory of the threads.
+    unsigned char *threadWorkspace = arena_alloc(arena, (size_t) threadNumber * instanceWorkspaceSize);
+
+#pragma omp parallel num_threads(threadNumber)
+    {
+        /// The arena of the thread.
+        Arena threadArena;
+        arena_init(&threadArena, threadWorkspace + (size_t) omp_get_thread_num() * instanceWorkspaceSize, instanceWorkspaceSize);
+
+#pragma omp for schedule(static)
+        for (size_t i = 0; i < instanceNumber; ++i) {
+            build(batch, i, &threadArena, 0);
+        }
+    }
+
+    arena_release(arena, arenaMark);
+}
@@ -0,0 +1,24 @@
+#ifndef DJB_BATCH_H
+#define DJB_BATCH_H
+
+
+#include <omp.h>
+#include <stddef.h>
+
+#include "arena.h"
+
+
+/// The size of an instance from which the instances of a batch are built one after the other, each one by the whole team.
+#define BATCH_INSTANCE_CUTOFF 65536
+
+
+/// Function that builds the instance of a batch, with the scratch buffers of the arena.
+typedef void (*BatchInstance)(const void *batch, size_t instance, Arena *arena, short parallel);
+
+
+int batchThreadNumber(size_t instanceNumber, size_t instanceSize);
+size_t batchWorkspaceSize(size_t instanceNumber, size_t instanceSize, size_t instanceWorkspaceSize);
+void batchRun(BatchInstance build, const void *batch, size_t instanceNumber, size_t instanceSize, size_t instanceWorkspaceSize, Arena *arena, short parallel);
+
+
+#endif //DJB_BATCH_H
@@ -0,0 +1,393 @@
+#include "bitonicKernel.h"
+#include "bitonicSort.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BITONIC_KERNEL_X86 1
+#include <immintrin.h>
+#endif
+
+
+static void compareAndSwapStageScalar(SortKey *firstKey, SortKey *secondKey, int *firstValue, int *secondValue, size_t count, short direction);
+static void bitonicMergeRegisterBlockScalar(SortKey *key, int *value, short direction);
+
+
+/// The active compare-and-swap stage kernel.
+void (*compareAndSwapStage)(SortKey *firstKey, SortKey *secondKey, int *firstValue, int *secondValue, size_t count, short direction) = compareAndSwapStageScalar;
+/// The active register block merge kernel.
+void (*bitonicMergeRegisterBlock)(SortKey *key, int *value, short direction) = bitonicMergeRegisterBlockScalar;
+
+/// The instruction set of the active kernels.
+static BitonicKernel activeKernel = BITONIC_KERNEL_SCALAR;
+
+
+/**
+ * Function that compares and swaps two arrays of keys element by element.
+ *
+ * @details Scalar version.
+ *
+ * @param firstKey the first array of keys.
+ * @param secondKey the second array of keys.
+ * @param firstValue the values of the first array, NULL if they are not needed.
+ * @param secondValue the values of the second array, NULL if they are not needed.
+ * @param count the number of comparators.
+ * @param direction the sorting direction.
+ */
+static void compareAndSwapStageScalar(SortKey *firstKey, SortKey *secondKey, int *firstValue, int *secondValue, size_t count, short direction) {
+    if (firstValue) {
+        for (size_t i = 0; i < count; ++i) {
+            compareAndSwap(&firstKey[i], &secondKey[i], &firstValue[i], &secondValue[i], direction);
+        }
+    }
+    else {
+        for (size_t i = 0; i < count; ++i) {
+            compareAndSwap(&firstKey[i], &secondKey[i], NULL, NULL, direction);
+        }
+    }
+}
+
+/**
+ * Function that merges a bitonic block of BITONIC_REGISTER_BLOCK keys.
+ *
+ * @details Scalar version.
+ *
+ * @param key the keys of the bitonic block.
+ * @param value the values of the bitonic block, NULL if they are not needed.
+ * @param direction the sorting direction.
+ */
+static void bitonicMergeRegisterBlockScalar(SortKey *key, int *value, short direction) {
+    for (size_t distance = BITONIC_REGISTER_BLOCK / 2; distance > 0; distance /= 2) {
+        for (size_t i = 0; i < BITONIC_REGISTER_BLOCK; ++i) {
+            if (!(i & distance)) {
+                compareAndSwap(&key[i], &key[i + distance], value ? &value[i] : NULL, value ? &value[i + distance] : NULL, direction);
+            }
+        }
+    }
+}
+
+
+#ifdef BITONIC_KERNEL_X86
+
+/**
+ * Function that compares the keys contained in two AVX2 registers.
+ *
+ * @details The keys are compared as unsigned integers by flipping their sign bit before the signed comparison.
+ *
+ * @param first the first four keys.
+ * @param second the second four keys.
+ * @return for each 64-bit lane, all bits set if the first key is greater than the second one, 0 otherwise.
+ */
+__attribute__((target("avx2")))
+static inline __m256i keyGreaterAvx2(__m256i first, __m256i second) {
+    /// The sign bit of the keys.
+    __m256i signBit = _mm256_set1_epi64x((long long) 0x8000000000000000ull);
+
+    return _mm256_cmpgt_epi64(_mm256_xor_si256(first, signBit), _mm256_xor_si256(second, signBit));
+}
+
+/**
+ * Function that narrows four 64-bit lanes to four 32-bit lanes.
+ *
+ * @details Used both for the masks of the keys, which become the masks of the values, and for the widened values.
+ *
+ * @param lanes the four 64-bit lanes.
+ * @return the low 32 bits of each lane.
+ */
+__attribute__((target("avx2")))
+static inline __m128i narrowLanesAvx2(__m256i lanes) {
+    return _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(lanes, _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7)));
+}
+
+/**
+ * Function that compares and swaps two arrays of keys element by element.
+ *
+ * @details AVX2 version, four comparators per instruction.
+ *
+ * @param firstKey the first array of keys.
+ * @param secondKey the second array of keys.
+ * @param firstValue the values of the first array, NULL if they are not needed.
+ * @param secondValue the values of the second array, NULL if they are not needed.
+ * @param count the number of comparators.
+ * @param direction the sorting direction.
+ */
+__attribute__((target("avx2")))
+static void compareAndSwapStageAvx2(SortKey *firstKey, SortKey *secondKey, int *firstValue, int *secondValue, size_t count, short direction) {
+    /// The mask that inverts the comparison in descending direction.
+    __m256i inverseDirection = _mm256_set1_epi64x(-(long long) (direction == DESCENDING));
+    /// The position in the arrays.
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        /// The four keys of the first array.
+        __m256i first = _mm256_loadu_si256((const __m256i *) &firstKey[i]);
+        /// The four keys of the second array.
+        __m256i second = _mm256_loadu_si256((const __m256i *) &secondKey[i]);
+        /// The swap selector.
+        __m256i muxSelector = _mm256_xor_si256(keyGreaterAvx2(first, second), inverseDirection);
+
+        _mm256_storeu_si256((__m256i *) &firstKey[i], _mm256_blendv_epi8(first, second, muxSelector));
+        _mm256_storeu_si256((__m256i *) &secondKey[i], _mm256_blendv_epi8(second, first, muxSelector));
+
+        if (firstValue) {
+            /// The four values of the first array.
+            __m128i firstValues = _mm_loadu_si128((const __m128i *) &firstValue[i]);
+            /// The four values of the second array.
+            __m128i secondValues = _mm_loadu_si128((const __m128i *) &secondValue[i]);
+            /// The swap selector of the values.
+            __m128i valueMuxSelector = narrowLanesAvx2(muxSelector);
+
+            _mm_storeu_si128((__m128i *) &firstValue[i], _mm_blendv_epi8(firstValues, secondValues, valueMuxSelector));
+            _mm_storeu_si128((__m128i *) &secondValue[i], _mm_blendv_epi8(secondValues, firstValues, valueMuxSelector));
+        }
+    }
+
+    compareAndSwapStageScalar(firstKey + i, secondKey + i, firstValue ? firstValue + i : NULL, secondValue ? secondValue + i : NULL, count - i, direction);
+}
+
+/**
+ * Function that executes a stage inside an AVX2 register.
+ *
+ * @details Each lane is compared with the same lane of the exchanged register, the lower lanes of the comparators keep the decision of key > exchangedKey, the upper ones of exchangedKey > key.
+ *
+ * @param key the four keys.
+ * @param value the four values, widened to 64 bits.
+ * @param exchangedKey the keys permuted so that each lane faces its partner.
+ * @param exchangedValue the values permuted so that each lane faces its partner.
+ * @param lowerLanes the mask of the lanes that are the lower element of their comparator.
+ * @param inverseDirection the mask that inverts the comparison in descending direction.
+ */
+__attribute__((target("avx2")))
+static inline void registerStageAvx2(__m256i *key, __m256i *value, __m256i exchangedKey, __m256i exchangedValue, __m256i lowerLanes, __m256i inverseDirection) {
+    /// The swap selector.
+    __m256i muxSelector = _mm256_xor_si256(_mm256_blendv_epi8(keyGreaterAvx2(exchangedKey, *key), keyGreaterAvx2(*key, exchangedKey), lowerLanes), inverseDirection);
+
+    *key = _mm256_blendv_epi8(*key, exchangedKey, muxSelector);
+    *value = _mm256_blendv_epi8(*value, exchangedValue, muxSelector);
+}
+
+/**
+ * Function that merges a bitonic block of BITONIC_REGISTER_BLOCK keys.
+ *
+ * @details AVX2 version, the block is kept in two registers for the three stages, the values are widened to the lanes of the keys.
+ *
+ * @param key the keys of the bitonic block.
+ * @param value the values of the bitonic block, NULL if they are not needed.
+ * @param direction the sorting direction.
+ */
+__attribute__((target("avx2")))
+static void bitonicMergeRegisterBlockAvx2(SortKey *key, int *value, short direction) {
+    /// The mask that inverts the comparison in descending direction.
+    __m256i inverseDirection = _mm256_set1_epi64x(-(long long) (direction == DESCENDING));
+    /// The keys 0 to 3.
+    __m256i lowKey = _mm256_loadu_si256((const __m256i *) &key[0]);
+    /// The keys 4 to 7.
+    __m256i highKey = _mm256_loadu_si256((const __m256i *) &key[4]);
+    /// The values 0 to 3.
+    __m256i lowValue = value ? _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i *) &value[0])) : _mm256_setzero_si256();
+    /// The values 4 to 7.
+    __m256i highValue = value ? _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i *) &value[4])) : _mm256_setzero_si256();
+
+    // stage at distance 4: the two registers against each other
+    /// The swap selector.
+    __m256i muxSelector = _mm256_xor_si256(keyGreaterAvx2(lowKey, highKey), inverseDirection);
+    /// The temporary variable used for the swap.
+    __m256i temp = _mm256_blendv_epi8(lowKey, highKey, muxSelector);
+    highKey = _mm256_blendv_epi8(highKey, lowKey, muxSelector);
+    lowKey = temp;
+    temp = _mm256_blendv_epi8(lowValue, highValue, muxSelector);
+    highValue = _mm256_blendv_epi8(highValue, lowValue, muxSelector);
+    lowValue = temp;
+
+    // stage at distance 2: lanes 0, 1 against 2, 3 of each register
+    /// The lower lanes of the comparators at distance 2.
+    __m256i lowerLanes = _mm256_setr_epi64x(-1, -1, 0, 0);
+    registerStageAvx2(&lowKey, &lowValue, _mm256_permute4x64_epi64(lowKey, _MM_SHUFFLE(1, 0, 3, 2)), _mm256_permute4x64_epi64(lowValue, _MM_SHUFFLE(1, 0, 3, 2)), lowerLanes, inverseDirection);
+    registerStageAvx2(&highKey, &highValue, _mm256_permute4x64_epi64(highKey, _MM_SHUFFLE(1, 0, 3, 2)), _mm256_permute4x64_epi64(highValue, _MM_SHUFFLE(1, 0, 3, 2)), lowerLanes, inverseDirection);
+
+    // stage at distance 1: lanes 0, 2 against 1, 3 of each register
+    lowerLanes = _mm256_setr_epi64x(-1, 0, -1, 0);
+    registerStageAvx2(&lowKey, &lowValue, _mm256_permute4x64_epi64(lowKey, _MM_SHUFFLE(2, 3, 0, 1)), _mm256_permute4x64_epi64(lowValue, _MM_SHUFFLE(2, 3, 0, 1)), lowerLanes, inverseDirection);
+    registerStageAvx2(&highKey, &highValue, _mm256_permute4x64_epi64(highKey, _MM_SHUFFLE(2, 3, 0, 1)), _mm256_permute4x64_epi64(highValue, _MM_SHUFFLE(2, 3, 0, 1)), lowerLanes, inverseDirection);
+
+    _mm256_storeu_si256((__m256i *) &key[0], lowKey);
+    _mm256_storeu_si256((__m256i *) &key[4], highKey);
+
+    if (value) {
+        _mm_storeu_si128((__m128i *) &value[0], narrowLanesAvx2(lowValue));
+        _mm_storeu_si128((__m128i *) &value[4], narrowLanesAvx2(highValue));
+    }
+}
+
+
+/**
+ * Function that compares and swaps two arrays of keys element by element.
+ *
+ * @details AVX-512 version, eight comparators per instruction, the tail is handled by masked loads and stores.
+ * @details Without values the keys are exchanged by unsigned min and max.
+ *
+ * @param firstKey the first array of keys.
+ * @param secondKey the second array of keys.
+ * @param firstValue the values of the first array, NULL if they are not needed.
+ * @param secondValue the values of the second array, NULL if they are not needed.
+ * @param count the number of comparators.
+ * @param direction the sorting direction.
+ */
+__attribute__((target("avx512f")))
+static void compareAndSwapStageAvx512(SortKey *firstKey, SortKey *secondKey, int *firstValue, int *secondValue, size_t count, short direction) {
+    /// The mask that inverts the comparison in descending direction.
+    __mmask8 inverseDirection = (__mmask8) -(direction == DESCENDING);
+
+    for (size_t i = 0; i < count; i += 8) {
+        /// The lanes in use, all of them except for the last iteration.
+        __mmask8 loadMask = (__mmask8) (count - i >= 8 ? 0xFF : (1u << (count - i)) - 1);
+        /// The eight keys of the first array.
+        __m512i first = _mm512_maskz_loadu_epi64(loadMask, &firstKey[i]);
+        /// The eight keys of the second array.
+        __m512i second = _mm512_maskz_loadu_epi64(loadMask, &secondKey[i]);
+
+        if (firstValue) {
+            /// The swap selector.
+            __mmask8 muxSelector = _mm512_cmpgt_epu64_mask(first, second) ^ inverseDirection;
+            /// The eight values of the first array.
+            __m512i firstValues = _mm512_maskz_loadu_epi32(loadMask, &firstValue[i]);
+            /// The eight values of the second array.
+            __m512i secondValues = _mm512_maskz_loadu_epi32(loadMask, &secondValue[i]);
+
+            _mm512_mask_storeu_epi64(&firstKey[i], loadMask, _mm512_mask_blend_epi64(muxSelector, first, second));
+            _mm512_mask_storeu_epi64(&secondKey[i], loadMask, _mm512_mask_blend_epi64(muxSelector, second, first));
+            _mm512_mask_storeu_epi32(&firstValue[i], loadMask, _mm512_mask_blend_epi32(muxSelector, firstValues, secondValues));
+            _mm512_mask_storeu_epi32(&secondValue[i], loadMask, _mm512_mask_blend_epi32(muxSelector, secondValues, firstValues));
+        }
+        else {
+            /// The minimum keys.
+            __m512i minimum = _mm512_min_epu64(first, second);
+            /// The maximum keys.
+            __m512i maximum = _mm512_max_epu64(first, second);
+
+            _mm512_mask_storeu_epi64(&firstKey[i], loadMask, _mm512_mask_blend_epi64(inverseDirection, minimum, maximum));
+            _mm512_mask_storeu_epi64(&secondKey[i], loadMask, _mm512_mask_blend_epi64(inverseDirection, maximum, minimum));
+        }
+    }
+}
+
+/**
+ * Function that executes a stage inside an AVX-512 register.
+ *
+ * @details Each lane is compared with the same lane of the exchanged register, the lower lanes of the comparators keep the decision of key > exchangedKey, the upper ones of exchangedKey > key.
+ *
+ * @param key the eight keys.
+ * @param value the eight values, widened to 64 bits.
+ * @param exchangedKey the keys permuted so that each lane faces its partner.
+ * @param exchangedValue the values permuted so that each lane faces its partner.
+ * @param lowerLanes the mask of the lanes that are the lower element of their comparator.
+ * @param inverseDirection the mask that inverts the comparison in descending direction.
+ */
+__attribute__((target("avx512f")))
+static inline void registerStageAvx512(__m512i *key, __m512i *value, __m512i exchangedKey, __m512i exchangedValue, __mmask8 lowerLanes, __mmask8 inverseDirection) {
+    /// The swap selector.
+    __mmask8 muxSelector = ((_mm512_cmpgt_epu64_mask(*key, exchangedKey) & lowerLanes) | (_mm512_cmpgt_epu64_mask(exchangedKey, *key) & ~lowerLanes)) ^ inverseDirection;
+
+    *key = _mm512_mask_blend_epi64(muxSelector, *key, exchangedKey);
+    *value = _mm512_mask_blend_epi64(muxSelector, *value, exchangedValue);
+}
+
+/**
+ * Function that merges a bitonic block of BITONIC_REGISTER_BLOCK keys.
+ *
+ * @details AVX-512 version, the block is kept in a single register for the three stages, the values are widened to the lanes of the keys.
+ *
+ * @param key the keys of the bitonic block.
+ * @param value the values of the bitonic block, NULL if they are not needed.
+ * @param direction the sorting direction.
+ */
+__attribute__((target("avx512f")))
+static void bitonicMergeRegisterBlockAvx512(SortKey *key, int *value, short direction) {
+    /// The mask that inverts the comparison in descending direction.
+    __mmask8 inverseDirection = (__mmask8) -(direction == DESCENDING);
+    /// The eight keys.
+    __m512i blockKey = _mm512_loadu_si512(key);
+    /// The eight values.
+    __m512i blockValue = value ? _mm512_cvtepu32_epi64(_mm256_loadu_si256((const __m256i *) value)) : _mm512_setzero_si512();
+
+    // stage at distance 4: lanes 0 to 3 against 4 to 7
+    registerStageAvx512(&blockKey, &blockValue, _mm512_shuffle_i64x2(blockKey, blockKey, _MM_SHUFFLE(1, 0, 3, 2)), _mm512_shuffle_i64x2(blockValue, blockValue, _MM_SHUFFLE(1, 0, 3, 2)), 0x0F, inverseDirection);
+    // stage at distance 2: lanes 0, 1 against 2, 3 of each half
+    registerStageAvx512(&blockKey, &blockValue, _mm512_permutex_epi64(blockKey, _MM_SHUFFLE(1, 0, 3, 2)), _mm512_permutex_epi64(blockValue, _MM_SHUFFLE(1, 0, 3, 2)), 0x33, inverseDirection);
+    // stage at distance 1: even lanes against odd lanes
+    registerStageAvx512(&blockKey, &blockValue, _mm512_permutex_epi64(blockKey, _MM_SHUFFLE(2, 3, 0, 1)), _mm512_permutex_epi64(blockValue, _MM_SHUFFLE(2, 3, 0, 1)), 0x55, inverseDirection);
+
+    _mm512_storeu_si512(key, blockKey);
+
+    if (value) {
+        _mm256_storeu_si256((__m256i *) value, _mm512_cvtepi64_epi32(blockValue));
+    }
+}
+
+#endif
+
+
+/**
+ * Function that selects the kernels of the bitonic network.
+ *
+ * @details If the requested instruction set is not supported by the CPU, the best supported one that is not wider is used.
+ *
+ * @param kernel the requested instruction set.
+ * @return the instruction set actually selected.
+ */
+BitonicKernel bitonicKernelSelect(BitonicKernel kernel) {
+    compareAndSwapStage = compareAndSwapStageScalar;
+    bitonicMergeRegisterBlock = bitonicMergeRegisterBlockScalar;
+    activeKernel = BITONIC_KERNEL_SCALAR;
+
+#ifdef BITONIC_KERNEL_X86
+    __builtin_cpu_init();
+
+    if (kernel >= BITONIC_KERNEL_AVX512 && __builtin_cpu_supports("avx512f")) {
+        compareAndSwapStage = compareAndSwapStageAvx512;
+        bitonicMergeRegisterBlock = bitonicMergeRegisterBlockAvx512;
+        activeKernel = BITONIC_KERNEL_AVX512;
+    }
+    else if (kernel >= BITONIC_KERNEL_AVX2 && __builtin_cpu_supports("avx2")) {
+        compareAndSwapStage = compareAndSwapStageAvx2;
+        bitonicMergeRegisterBlock = bitonicMergeRegisterBlockAvx2;
+        activeKernel = BITONIC_KERNEL_AVX2;
+    }
+#else
+    (void) kernel;
+#endif
+
+    return activeKernel;
+}
+
+/**
+ * Function that returns the instruction set of the active kernels.
+ *
+ * @return the instruction set of the active kernels.
+ */
+BitonicKernel bitonicKernelActive(void) {
+    return activeKernel;
+}
+
+/**
+ * Function that returns the name of an instruction set.
+ *
+ * @param kernel the instruction set.
+ * @return the name of the instruction set.
+ */
+const char *bitonicKernelName(BitonicKernel kernel) {
+    switch (kernel) {
+        case BITONIC_KERNEL_AVX512:
+            return "avx512";
+        case BITONIC_KERNEL_AVX2:
+            return "avx2";
+        default:
+            return "scalar";
+    }
+}
+
+/**
+ * Function that selects the widest kernels supported by the CPU when the program is loaded.
+ */
+__attribute__((constructor))
+static void bitonicKernelInit(void) {
+    bitonicKernelSelect(BITONIC_KERNEL_AVX512);
+}
@@ -0,0 +1,38 @@
+#ifndef DJB_BITONICKERNEL_H
+#define DJB_BITONICKERNEL_H
+
+
+#include <stddef.h>
+
+#include "tuple.h"
+#include "stats.h"
+
+
+/// The number of quadruples that are merged entirely inside the vector registers.
+#define BITONIC_REGISTER_BLOCK 8
+/// The number of comparators of the merge of a register block, log2(BITONIC_REGISTER_BLOCK) stages of BITONIC_REGISTER_BLOCK / 2.
+#define BITONIC_REGISTER_COMPARATORS (BITONIC_REGISTER_BLOCK / 2 * 3)
+
+
+/// The instruction set used by the kernels of the bitonic network.
+typedef enum {
+    /// Portable C implementation.
+    BITONIC_KERNEL_SCALAR,
+    /// 256-bit implementation, four keys per register.
+    BITONIC_KERNEL_AVX2,
+    /// 512-bit implementation, eight keys per register.
+    BITONIC_KERNEL_AVX512
+} BitonicKernel;
+
+
+/// Kernel that compares and swaps firstKey[i] with secondKey[i], and the values if they are not NULL, for each i less than count.
+extern void (*compareAndSwapStage)(SortKey *firstKey, SortKey *secondKey, int *firstValue, int *secondValue, size_t count, short direction);
+/// Kernel that merges a bitonic block of BITONIC_REGISTER_BLOCK keys, and the values if they are not NULL.
+extern void (*bitonicMergeRegisterBlock)(SortKey *key, int *value, short direction);
+
+BitonicKernel bitonicKernelSelect(BitonicKernel kernel);
+BitonicKernel bitonicKernelActive(void);
+const char *bitonicKernelName(BitonicKernel kernel);
+
+
+#endif //DJB_BITONICKERNEL_H
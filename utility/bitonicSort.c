@@ -5,6 +5,9 @@
  * The sort algorithm of bitonic sort.
  *
  * @details This algorithm is an adaptation of the original algorithm, which only works with arrays whose size is a power of 2.
+ * @details In parallel mode the whole network is executed inside a single parallel region, see bitonicSortTeam.
+ *
+ * @note The values of the array are moved with their keys only if they are not NULL.
  *
  * @param array the unsorted array.
  * @param startPosition the starting position.
@@ -12,62 +15,291 @@
  * @param direction the sorting direction.
  * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
  */
-void bitonicSort(Quadruple *array, size_t startPosition, size_t arraySize, short direction, short parallel) {
-    if (arraySize > 1) {
+void bitonicSort(QuadrupleArray *array, size_t startPosition, size_t arraySize, short direction, short parallel) {
+    if (parallel && arraySize >= BITONIC_PARALLEL_CUTOFF) {
+#pragma omp parallel
+        {
+            bitonicSortTeam(array, startPosition, arraySize, direction);
+        }
+    }
+    else if (arraySize > 1) {
         /// The subarray size.
         size_t subarraySize = arraySize / 2;
 
-        if (parallel) {
-#pragma omp parallel sections
-            {
-#pragma omp section
-                {
-                    bitonicSort(array, startPosition, subarraySize, !direction, parallel);
-                }
+        bitonicSort(array, startPosition, subarraySize, !direction, SERIAL);
+        bitonicSort(array, startPosition + subarraySize, arraySize - subarraySize, direction, SERIAL);
 
-#pragma omp section
-                {
-                    bitonicSort(array, startPosition + subarraySize, arraySize - subarraySize, direction, parallel);
-                }
-            }
-        }
-        else {
-            bitonicSort(array, startPosition, subarraySize, !direction, parallel);
-            bitonicSort(array, startPosition + subarraySize, arraySize - subarraySize, direction, parallel);
-        }
-
-        bitonicMerge(array, startPosition, arraySize, direction, parallel);
+        bitonicMerge(array, startPosition, arraySize, direction, SERIAL);
     }
 }
 
 /**
  * The merge algorithm of adapted bitonic sort.
  *
+ * @details Each stage of comparators is executed by the compareAndSwapStage kernel selected at load time.
+ * @details The blocks of BITONIC_REGISTER_BLOCK elements are merged inside the vector registers by the bitonicMergeRegisterBlock kernel.
+ * @details In parallel mode the whole network is executed inside a single parallel region, see bitonicMergeTeam.
+ *
  * @param array the unsorted array.
  * @param startPosition the starting position.
  * @param arraySize the array size.
  * @param direction the sorting direction.
-* @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
  */
-void bitonicMerge(Quadruple *array, size_t startPosition, size_t arraySize, short direction, short parallel) {
-    if (arraySize > 1) {
+void bitonicMerge(QuadrupleArray *array, size_t startPosition, size_t arraySize, short direction, short parallel) {
+    /// The keys of the array.
+    SortKey *key = array->key;
+    /// The values of the array, NULL if they are not needed.
+    int *value = array->value;
+
+    if (parallel && arraySize >= BITONIC_PARALLEL_CUTOFF) {
+#pragma omp parallel
+        {
+            bitonicMergeTeam(array, startPosition, arraySize, direction);
+        }
+    }
+    else if (arraySize == BITONIC_REGISTER_BLOCK) {
+        bitonicMergeRegisterBlock(&key[startPosition], value ? &value[startPosition] : NULL, direction);
+        STATS_COMPARATORS(BITONIC_REGISTER_COMPARATORS);
+    }
+    else if (arraySize > 1) {
         /// The subarray size.
         size_t subarraySize = greatestPowerOf2LessThan(arraySize);
 
-        if (parallel) {
-#pragma omp parallel for
-            for (size_t i = startPosition; i < startPosition + arraySize - subarraySize; ++i) {
-                compareAndSwap(&array[i], &array[i + subarraySize], direction);
-            }
+        compareAndSwapStage(&key[startPosition], &key[startPosition + subarraySize],
+                            value ? &value[startPosition] : NULL, value ? &value[startPosition + subarraySize] : NULL,
+                            arraySize - subarraySize, direction);
+        STATS_COMPARATORS(arraySize - subarraySize);
+
+        bitonicMerge(array, startPosition, subarraySize, direction, SERIAL);
+        bitonicMerge(array, startPosition + subarraySize, arraySize - subarraySize, direction, SERIAL);
+    }
+}
+
+/**
+ * The merge algorithm of adapted bitonic sort, executed by all the threads of the current team.
+ *
+ * @warning It must be called by all the threads of the team, with the same arguments.
+ *
+ * @details The adapted network is the network of the next power of two without the comparators that reach past the array, so its stages are flattened: the stage at distance d compares i with i + d, for each i whose bit d is 0.
+ * @details Each stage is split in equal slices of comparators, one per thread, separated by a barrier.
+ * @details As soon as the blocks of 2d elements are at least BITONIC_TEAM_BLOCKS per thread, the rest of the network is independent inside each block: the blocks are shared among the threads and merged serially, without other barriers.
+ * @details All the threads see the merged array on return.
+ *
+ * @param array the unsorted array.
+ * @param startPosition the starting position.
+ * @param arraySize the array size.
+ * @param direction the sorting direction.
+ */
+void bitonicMergeTeam(QuadrupleArray *array, size_t startPosition, size_t arraySize, short direction) {
+    /// Thread ID.
+    size_t threadID = (size_t) omp_get_thread_num();
+    /// Number of thread.
+    size_t threadNumber = (size_t) omp_get_num_threads();
+
+    /// The keys of the array.
+    SortKey *key = array->key + startPosition;
+    /// The values of the array, NULL if they are not needed.
+    int *value = array->value ? array->value + startPosition : NULL;
+
+    if (arraySize < 2) {
+        return;
+    }
+
+    /// The distance of the comparators of the stage.
+    size_t distance = greatestPowerOf2LessThan(arraySize);
+
+    while (2 * distance > BITONIC_REGISTER_BLOCK && (arraySize + 2 * distance - 1) / (2 * distance) < BITONIC_TEAM_BLOCKS * threadNumber) {
+        /// The number of comparators of the stage: distance for each full block, the ones that fit in the last partial block.
+        size_t comparatorNumber = arraySize / (2 * distance) * distance + (arraySize % (2 * distance) > distance ? arraySize % (2 * distance) - distance : 0);
+        /// The first comparator of the thread.
+        size_t comparator = comparatorNumber * threadID / threadNumber;
+        /// The last comparator of the thread, excluded.
+        size_t lastComparator = comparatorNumber * (threadID + 1) / threadNumber;
+
+        while (comparator < lastComparator) {
+            /// The position of the comparator inside its block.
+            size_t offset = comparator % distance;
+            /// The first element compared.
+            size_t i = 2 * (comparator - offset) + offset;
+            /// The consecutive comparators of the block.
+            size_t run = distance - offset < lastComparator - comparator ? distance - offset : lastComparator - comparator;
+
+            compareAndSwapStage(&key[i], &key[i + distance], value ? &value[i] : NULL, value ? &value[i + distance] : NULL, run, direction);
+            STATS_COMPARATORS(run);
+
+            comparator += run;
+        }
+
+#pragma omp barrier
+
+        distance /= 2;
+    }
+
+    /// The size of the independent blocks.
+    size_t blockSize = 2 * distance;
+    /// The number of independent blocks.
+    size_t blockNumber = (arraySize + blockSize - 1) / blockSize;
+
+#pragma omp for schedule(static)
+    for (size_t block = 0; block < blockNumber; ++block) {
+        /// The first element of the block.
+        size_t blockStart = block * blockSize;
+
+        bitonicMerge(array, startPosition + blockStart, arraySize - blockStart < blockSize ? arraySize - blockStart : blockSize, direction, SERIAL);
+    }
+}
+
+/**
+ * The sort algorithm of bitonic sort, executed by all the threads of the current team.
+ *
+ * @warning It must be called by all the threads of the team, with the same arguments.
+ *
+ * @details The subtrees of the recursion at the first depth with at least one subtree per thread are sorted serially, one per thread.
+ * @details The merges above them are executed one after another by the whole team, with bitonicMergeTeam.
+ *
+ * @param array the unsorted array.
+ * @param startPosition the starting position.
+ * @param arraySize the array size.
+ * @param direction the sorting direction.
+ */
+void bitonicSortTeam(QuadrupleArray *array, size_t startPosition, size_t arraySize, short direction) {
+    /// Number of thread.
+    size_t threadNumber = (size_t) omp_get_num_threads();
+
+    /// The depth of the subtrees sorted serially.
+    int depth = 0;
+
+    while (((size_t) 1 << depth) < threadNumber) {
+        ++depth;
+    }
+
+#pragma omp for schedule(static)
+    for (size_t node = 0; node < ((size_t) 1 << depth); ++node) {
+        /// The first element of the subtree.
+        size_t nodeStart;
+        /// The size of the subtree.
+        size_t nodeSize;
+        /// The sorting direction of the subtree.
+        short nodeDirection;
+
+        bitonicSortNode(arraySize, direction, depth, node, &nodeStart, &nodeSize, &nodeDirection);
+        bitonicSort(array, startPosition + nodeStart, nodeSize, nodeDirection, SERIAL);
+    }
+
+    while (depth-- > 0) {
+        for (size_t node = 0; node < ((size_t) 1 << depth); ++node) {
+            /// The first element of the subtree.
+            size_t nodeStart;
+            /// The size of the subtree.
+            size_t nodeSize;
+            /// The sorting direction of the subtree.
+            short nodeDirection;
+
+            bitonicSortNode(arraySize, direction, depth, node, &nodeStart, &nodeSize, &nodeDirection);
+            bitonicMergeTeam(array, startPosition + nodeStart, nodeSize, nodeDirection);
+        }
+    }
+}
+
+/**
+ * Function that finds a subtree of the recursion of bitonicSort.
+ *
+ * @param arraySize the array size.
+ * @param direction the sorting direction of the array.
+ * @param depth the depth of the subtree.
+ * @param node the index of the subtree among the ones at the same depth, from left to right.
+ * @param nodeStart the first element of the subtree, relative to the array.
+ * @param nodeSize the size of the subtree.
+ * @param nodeDirection the sorting direction of the subtree.
+ */
+void bitonicSortNode(size_t arraySize, short direction, int depth, size_t node, size_t *nodeStart, size_t *nodeSize, short *nodeDirection) {
+    *nodeStart = 0;
+    *nodeSize = arraySize;
+    *nodeDirection = direction;
+
+    while (depth-- > 0) {
+        /// The size of the left subtree.
+        size_t subarraySize = *nodeSize / 2;
+
+        if ((node >> depth) & 1) {
+            *nodeStart += subarraySize;
+            *nodeSize -= subarraySize;
         }
         else {
-            for (size_t i = startPosition; i < startPosition + arraySize - subarraySize; ++i) {
-                compareAndSwap(&array[i], &array[i + subarraySize], direction);
+            *nodeSize = subarraySize;
+            *nodeDirection = !*nodeDirection;
+        }
+    }
+}
+
+/**
+ * The merge algorithm of two lists already sorted in ascending order.
+ *
+ * @warning Both input lists must be sorted in ascending order and must not overlap the result.
+ * @warning If the result has values, both input lists must have values.
+ *
+ * @details The first list is copied reversed in front of the second one, so that the result is a descending run followed by an ascending run, i.e. a bitonic sequence.
+ * @details Only the bitonicMerge network is then applied: O(n log n) comparators instead of the O(n log^2 n) of a full bitonicSort.
+ * @details The adapted bitonicMerge sorts any descending run followed by an ascending run, whatever the two sizes are, so non-power-of-two sizes are supported.
+ * @details The sequence of comparators only depends on the list sizes, so the merge is constant-time.
+ * @details In parallel mode the copy and the network share a single parallel region.
+ *
+ * @param result the array that will contain the merged list, of size firstList->arraySize + secondList->arraySize.
+ * @param firstList the first sorted list.
+ * @param secondList the second sorted list.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void bitonicMergeSortedLists(QuadrupleArray *result, const QuadrupleArray *firstList, const QuadrupleArray *secondList, short parallel) {
+    /// The size of the first list.
+    size_t firstListSize = firstList->arraySize;
+    /// The size of the second list.
+    size_t secondListSize = secondList->arraySize;
+
+    if (parallel && firstListSize + secondListSize >= BITONIC_PARALLEL_CUTOFF) {
+#pragma omp parallel
+        {
+#pragma omp for schedule(static) nowait
+            for (size_t i = 0; i < firstListSize; ++i) {
+                result->key[i] = firstList->key[firstListSize - 1 - i];
+            }
+
+#pragma omp for schedule(static) nowait
+            for (size_t i = 0; i < secondListSize; ++i) {
+                result->key[firstListSize + i] = secondList->key[i];
+            }
+
+            if (result->value) {
+#pragma omp for schedule(static) nowait
+                for (size_t i = 0; i < firstListSize; ++i) {
+                    result->value[i] = firstList->value[firstListSize - 1 - i];
+                }
+
+#pragma omp for schedule(static) nowait
+                for (size_t i = 0; i < secondListSize; ++i) {
+                    result->value[firstListSize + i] = secondList->value[i];
+                }
             }
+
+#pragma omp barrier
+
+            bitonicMergeTeam(result, 0, firstListSize + secondListSize, ASCENDING);
         }
+    }
+    else {
+        for (size_t i = 0; i < firstListSize; ++i) {
+            result->key[i] = firstList->key[firstListSize - 1 - i];
+        }
+        memcpy(result->key + firstListSize, secondList->key, secondListSize * sizeof *result->key);
 
-        bitonicMerge(array, startPosition, subarraySize, direction, parallel);
-        bitonicMerge(array, startPosition + subarraySize, arraySize - subarraySize, direction, parallel);
+        if (result->value) {
+            for (size_t i = 0; i < firstListSize; ++i) {
+                result->value[i] = firstList->value[firstListSize - 1 - i];
+            }
+            memcpy(result->value + firstListSize, secondList->value, secondListSize * sizeof *result->value);
+        }
+
+        bitonicMerge(result, 0, firstListSize + secondListSize, ASCENDING, SERIAL);
     }
 }
 
@@ -75,33 +307,34 @@ void bitonicMerge(Quadruple *array, size_t startPosition, size_t arraySize, shor
 /**
  * Function that compares and swaps two elements based on the sorting direction.
  *
- * @param firstElement the first element.
- * @param secondElement the second element.
+ * @details The two elements are compared by their packed keys, with a single unsigned comparison.
+ *
+ * @param firstKey the key of the first element.
+ * @param secondKey the key of the second element.
+ * @param firstValue the value of the first element, NULL if it is not needed.
+ * @param secondValue the value of the second element, NULL if it is not needed.
  * @param direction the sorting direction.
  */
-void compareAndSwap(Quadruple *firstElement, Quadruple *secondElement, short direction) {
+void compareAndSwap(SortKey *firstKey, SortKey *secondKey, int *firstValue, int *secondValue, short direction) {
     /// The mux selector.
-    /// @details start + chunk < listSize --> -1 = 0xFF...FF
-    /// @details start + chunk > listSize --> 0  = 0x00...00
-    unsigned int muxSelector = (unsigned int)-(direction == (quadrupleComparison(firstElement, secondElement) > 0));
+    /// @details the elements must be swapped --> -1 = 0xFF...FF
+    /// @details the elements are in order    --> 0  = 0x00...00
+    SortKey muxSelector = -(SortKey)(direction == (*firstKey > *secondKey));
 
     /// The temporary variable used for the swap.
-    Quadruple temp;
-
-    temp.index0      = (firstElement->index0 & ~muxSelector) | (secondElement->index0 & muxSelector);
-    temp.fromLeft    = (firstElement->fromLeft & ~muxSelector) | (secondElement->fromLeft & muxSelector);
-    temp.indexInItsList = (firstElement->indexInItsList & ~muxSelector) | (secondElement->indexInItsList & muxSelector);
-    temp.index1      = (firstElement->index1 & ~muxSelector) | (secondElement->index1 & muxSelector);
-
-    secondElement->index0      = (secondElement->index0 & ~muxSelector) | (firstElement->index0 & muxSelector);
-    secondElement->fromLeft    = (secondElement->fromLeft & ~muxSelector) | (firstElement->fromLeft & muxSelector);
-    secondElement->indexInItsList = (secondElement->indexInItsList & ~muxSelector) | (firstElement->indexInItsList & muxSelector);
-    secondElement->index1      = (secondElement->index1 & ~muxSelector) | (firstElement->index1 & muxSelector);
-
-    firstElement->index0      = temp.index0;
-    firstElement->fromLeft    = temp.fromLeft;
-    firstElement->indexInItsList = temp.indexInItsList;
-    firstElement->index1      = temp.index1;
+    SortKey temp = (*firstKey & ~muxSelector) | (*secondKey & muxSelector);
+    *secondKey   = (*secondKey & ~muxSelector) | (*firstKey & muxSelector);
+    *firstKey    = temp;
+
+    if (firstValue) {
+        /// The mux selector for the value.
+        unsigned int valueMuxSelector = (unsigned int) muxSelector;
+        /// The temporary variable used for the swap of the value.
+        unsigned int valueTemp = ((unsigned int) *firstValue & ~valueMuxSelector) | ((unsigned int) *secondValue & valueMuxSelector);
+
+        *secondValue = (int) (((unsigned int) *secondValue & ~valueMuxSelector) | ((unsigned int) *firstValue & valueMuxSelector));
+        *firstValue  = (int) valueTemp;
+    }
 }
 
 /**
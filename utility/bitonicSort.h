@@ -4,20 +4,36 @@
 
 #include <omp.h>
 #include <stddef.h>
+#include <string.h>
 
 #include "tuple.h"
+#include "quadrupleArray.h"
+#include "bitonicKernel.h"
 
 
 #define ASCENDING 1
 #define DESCENDING 0
 
+#define PARALLEL 1
+#define SERIAL 0
 
-void bitonicSort(Quadruple *array, size_t startPosition, size_t arraySize, short direction, short parallel);
+/// The number of elements below which a network is executed serially even in parallel mode.
+#define BITONIC_PARALLEL_CUTOFF 4096
+/// The number of independent blocks per thread from which the stages of a merge are no longer separated by barriers.
+#define BITONIC_TEAM_BLOCKS 4
 
-void bitonicMerge(Quadruple *array, size_t startPosition, size_t arraySize, short direaction, short parallel);
+
+void bitonicSort(QuadrupleArray *array, size_t startPosition, size_t arraySize, short direction, short parallel);
+
+void bitonicSortTeam(QuadrupleArray *array, size_t startPosition, size_t arraySize, short direction);
+void bitonicSortNode(size_t arraySize, short direction, int depth, size_t node, size_t *nodeStart, size_t *nodeSize, short *nodeDirection);
+
+void bitonicMerge(QuadrupleArray *array, size_t startPosition, size_t arraySize, short direaction, short parallel);
+void bitonicMergeTeam(QuadrupleArray *array, size_t startPosition, size_t arraySize, short direction);
+void bitonicMergeSortedLists(QuadrupleArray *result, const QuadrupleArray *firstList, const QuadrupleArray *secondList, short parallel);
 
 int greatestPowerOf2LessThan(const int n);
-void compareAndSwap(Quadruple *firstElement, Quadruple *secondElement, short direction);
+void compareAndSwap(SortKey *firstKey, SortKey *secondKey, int *firstValue, int *secondValue, short direction);
 
 
 #endif //BITONICSORT_H
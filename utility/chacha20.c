@@ -0,0 +1,154 @@
+#include "chacha20.h"
+
+
+/**
+ * Function that reads a 32-bit little-endian integer.
+ *
+ * @param bytes the four bytes.
+ * @return the integer.
+ */
+static uint32_t load32LittleEndian(const unsigned char *bytes) {
+    return (uint32_t) bytes[0] | (uint32_t) bytes[1] << 8 | (uint32_t) bytes[2] << 16 | (uint32_t) bytes[3] << 24;
+}
+
+/**
+ * Function that writes a 32-bit integer in little-endian order.
+ *
+ * @param bytes the four bytes.
+ * @param word the integer.
+ */
+static void store32LittleEndian(unsigned char *bytes, uint32_t word) {
+    bytes[0] = (unsigned char) word;
+    bytes[1] = (unsigned char) (word >> 8);
+    bytes[2] = (unsigned char) (word >> 16);
+    bytes[3] = (unsigned char) (word >> 24);
+}
+
+/**
+ * Function that rotates a 32-bit integer to the left.
+ *
+ * @param word the integer.
+ * @param shift the rotation, between 1 and 31.
+ * @return the rotated integer.
+ */
+static inline uint32_t rotateLeft32(uint32_t word, int shift) {
+    return (word << shift) | (word >> (32 - shift));
+}
+
+/**
+ * Function that applies the quarter round of ChaCha20 to four words of the state.
+ *
+ * @param state the state.
+ * @param a the index of the first word.
+ * @param b the index of the second word.
+ * @param c the index of the third word.
+ * @param d the index of the fourth word.
+ */
+static inline void quarterRound(uint32_t *state, int a, int b, int c, int d) {
+    state[a] += state[b]; state[d] = rotateLeft32(state[d] ^ state[a], 16);
+    state[c] += state[d]; state[b] = rotateLeft32(state[b] ^ state[c], 12);
+    state[a] += state[b]; state[d] = rotateLeft32(state[d] ^ state[a], 8);
+    state[c] += state[d]; state[b] = rotateLeft32(state[b] ^ state[c], 7);
+}
+
+
+/**
+ * Function that initializes the keystream of ChaCha20.
+ *
+ * @param chacha the keystream to initialize.
+ * @param key the CHACHA20_KEY_SIZE bytes of the key, the seed of the generator.
+ * @param nonce the CHACHA20_NONCE_SIZE bytes of the nonce, it separates the streams of the same key.
+ * @param counter the first block counter.
+ */
+void chacha20_init(ChaCha20 *chacha, const unsigned char *key, const unsigned char *nonce, uint32_t counter) {
+    // "expand 32-byte k"
+    chacha->input[0] = 0x61707865u;
+    chacha->input[1] = 0x3320646eu;
+    chacha->input[2] = 0x79622d32u;
+    chacha->input[3] = 0x6b206574u;
+
+    for (int i = 0; i < 8; ++i) {
+        chacha->input[4 + i] = load32LittleEndian(key + 4 * i);
+    }
+
+    chacha->input[12] = counter;
+
+    for (int i = 0; i < 3; ++i) {
+        chacha->input[13 + i] = load32LittleEndian(nonce + 4 * i);
+    }
+
+    chacha->blockUsed = CHACHA20_BLOCK_SIZE;
+}
+
+/**
+ * Function that computes a keystream block of ChaCha20.
+ *
+ * @details 20 rounds, as 10 column rounds and 10 diagonal rounds, then the input is added to the state.
+ *
+ * @param input the 16 words of the input block.
+ * @param result the buffer of CHACHA20_BLOCK_SIZE bytes of the block.
+ */
+void chacha20_block(const uint32_t *input, unsigned char *result) {
+    /// The working state.
+    uint32_t state[16];
+
+    memcpy(state, input, sizeof state);
+
+    for (int round = 0; round < 10; ++round) {
+        quarterRound(state, 0, 4, 8, 12);
+        quarterRound(state, 1, 5, 9, 13);
+        quarterRound(state, 2, 6, 10, 14);
+        quarterRound(state, 3, 7, 11, 15);
+        quarterRound(state, 0, 5, 10, 15);
+        quarterRound(state, 1, 6, 11, 12);
+        quarterRound(state, 2, 7, 8, 13);
+        quarterRound(state, 3, 4, 9, 14);
+    }
+
+    for (int i = 0; i < 16; ++i) {
+        store32LittleEndian(result + 4 * i, state[i] + input[i]);
+    }
+}
+
+/**
+ * Function that writes the next bytes of the keystream.
+ *
+ * @details The whole blocks are written directly in the result, only the bytes of a partial block are kept for the next call.
+ *
+ * @param chacha the keystream, a ChaCha20, untyped so that the function is the generate of a ByteSource.
+ * @param result the buffer of size bytes.
+ * @param size the number of bytes.
+ */
+void chacha20_generate(void *chacha, unsigned char *result, size_t size) {
+    /// The keystream.
+    ChaCha20 *stream = chacha;
+
+    // the rest of the last block
+    while (size && stream->blockUsed < CHACHA20_BLOCK_SIZE) {
+        *result++ = stream->block[stream->blockUsed++];
+        --size;
+    }
+
+    for (; size >= CHACHA20_BLOCK_SIZE; size -= CHACHA20_BLOCK_SIZE, result += CHACHA20_BLOCK_SIZE) {
+        chacha20_block(stream->input, result);
+        ++stream->input[12];
+    }
+
+    if (size) {
+        chacha20_block(stream->input, stream->block);
+        ++stream->input[12];
+
+        memcpy(result, stream->block, size);
+        stream->blockUsed = size;
+    }
+}
+
+/**
+ * Function that wraps a keystream of ChaCha20 in a source of random bytes.
+ *
+ * @param chacha the keystream, it must outlive the source.
+ * @return the source.
+ */
+ByteSource chacha20_source(ChaCha20 *chacha) {
+    return (ByteSource) {chacha20_generate, chacha};
+}
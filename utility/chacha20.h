@@ -0,0 +1,43 @@
+#ifndef DJB_CHACHA20_H
+#define DJB_CHACHA20_H
+
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+
+/// The size of the key of ChaCha20.
+#define CHACHA20_KEY_SIZE 32
+/// The size of the nonce of ChaCha20.
+#define CHACHA20_NONCE_SIZE 12
+/// The size of a block of the keystream.
+#define CHACHA20_BLOCK_SIZE 64
+
+
+/// The new type representing a source of random bytes.
+typedef struct {
+    /// Function that writes the next size bytes of the source in result.
+    void (*generate)(void *state, unsigned char *result, size_t size);
+    /// The state of the source, passed to generate.
+    void *state;
+} ByteSource;
+
+/// The new type representing the keystream of ChaCha20 (RFC 8439), used as a deterministic generator.
+typedef struct {
+    /// The input block: constants, key, block counter and nonce.
+    uint32_t input[16];
+    /// The last keystream block.
+    unsigned char block[CHACHA20_BLOCK_SIZE];
+    /// The number of bytes of the last block already returned.
+    size_t blockUsed;
+} ChaCha20;
+
+
+void chacha20_init(ChaCha20 *chacha, const unsigned char *key, const unsigned char *nonce, uint32_t counter);
+void chacha20_block(const uint32_t *input, unsigned char *result);
+void chacha20_generate(void *chacha, unsigned char *result, size_t size);
+ByteSource chacha20_source(ChaCha20 *chacha);
+
+
+#endif //DJB_CHACHA20_H
@@ -0,0 +1,362 @@
+#include "mergeNetwork.h"
+
+
+/// The adapted bitonic merge.
+static const MergeNetworkStrategy bitonicStrategy = {MERGE_NETWORK_BITONIC, "bitonic", 1, bitonicMergeRuns, bitonicMergePositionRuns};
+/// The Batcher odd-even merge.
+static const MergeNetworkStrategy oddEvenStrategy = {MERGE_NETWORK_ODD_EVEN, "odd-even", 0, oddEvenMergeRuns, oddEvenMergePositionRuns};
+/// The Parberry pairwise sorting network.
+static const MergeNetworkStrategy pairwiseStrategy = {MERGE_NETWORK_PAIRWISE, "pairwise", 0, pairwiseMergeRuns, pairwiseMergePositionRuns};
+
+/// The active merging network.
+const MergeNetworkStrategy *mergeNetwork = &bitonicStrategy;
+
+
+/**
+ * Function that finds the smallest power of two that is greater than or equal to a given number.
+ *
+ * @param n the input number.
+ * @return the smallest power of two greater than or equal to the input number, 1 if it is 0.
+ */
+static size_t smallestPowerOf2AtLeast(size_t n) {
+    /// The power of two.
+    size_t result = 1;
+
+    while (result < n) {
+        result *= 2;
+    }
+
+    return result;
+}
+
+/**
+ * Function that counts the comparators of a stage whose first element is before a given position.
+ *
+ * @param stage the stage.
+ * @param position the position.
+ * @return the number of comparators of the stage whose first element is less than the position.
+ */
+static size_t networkStageCount(NetworkStage stage, size_t position) {
+    if (position <= stage.start) {
+        return 0;
+    }
+
+    /// The position relative to the first run.
+    size_t relativePosition = position - stage.start;
+    /// The part of the last run before the position.
+    size_t partialRun = relativePosition % stage.period;
+
+    return relativePosition / stage.period * stage.runLength + (partialRun < stage.runLength ? partialRun : stage.runLength);
+}
+
+/**
+ * Function that executes the stages of a network, in a single parallel region if it is worth it.
+ *
+ * @param stages the function that executes the stages.
+ * @param elements the elements moved by the network.
+ * @param firstRunSize the size of the first run.
+ * @param secondRunSize the size of the second run.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+static void networkRunStages(void (*stages)(NetworkElements, size_t, size_t, short), NetworkElements elements, size_t firstRunSize, size_t secondRunSize, short parallel) {
+    if (parallel && firstRunSize + secondRunSize >= MERGE_NETWORK_PARALLEL_CUTOFF) {
+#pragma omp parallel
+        {
+            stages(elements, firstRunSize, secondRunSize, 1);
+        }
+    }
+    else {
+        stages(elements, firstRunSize, secondRunSize, 0);
+    }
+}
+
+
+/**
+ * Function that selects the merging network.
+ *
+ * @param network the requested network.
+ * @return the network actually selected.
+ */
+MergeNetwork mergeNetworkSelect(MergeNetwork network) {
+    switch (network) {
+        case MERGE_NETWORK_ODD_EVEN:
+            mergeNetwork = &oddEvenStrategy;
+            break;
+        case MERGE_NETWORK_PAIRWISE:
+            mergeNetwork = &pairwiseStrategy;
+            break;
+        default:
+            mergeNetwork = &bitonicStrategy;
+    }
+
+    return mergeNetwork->network;
+}
+
+/**
+ * Function that returns the name of a merging network.
+ *
+ * @param network the network.
+ * @return the name of the network.
+ */
+const char *mergeNetworkName(MergeNetwork network) {
+    switch (network) {
+        case MERGE_NETWORK_ODD_EVEN:
+            return oddEvenStrategy.name;
+        case MERGE_NETWORK_PAIRWISE:
+            return pairwiseStrategy.name;
+        default:
+            return bitonicStrategy.name;
+    }
+}
+
+/**
+ * The merge algorithm of two lists already sorted in ascending order, with the active merging network.
+ *
+ * @warning Both input lists must be sorted in ascending order and must not overlap the result.
+ * @warning If the result has values, both input lists must have values.
+ *
+ * @details The first list is copied in the order expected by the network, followed by the second one.
+ * @details The sequence of comparators only depends on the list sizes, so the merge is constant-time.
+ *
+ * @param result the array that will contain the merged list, of size firstList->arraySize + secondList->arraySize.
+ * @param firstList the first sorted list.
+ * @param secondList the second sorted list.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void mergeNetworkSortedLists(QuadrupleArray *result, const QuadrupleArray *firstList, const QuadrupleArray *secondList, short parallel) {
+    /// The size of the first list.
+    size_t firstListSize = firstList->arraySize;
+    /// The size of the second list.
+    size_t secondListSize = secondList->arraySize;
+
+    if (mergeNetwork->reversedFirstRun) {
+        bitonicMergeSortedLists(result, firstList, secondList, parallel);
+        return;
+    }
+
+    memcpy(result->key, firstList->key, firstListSize * sizeof *result->key);
+    memcpy(result->key + firstListSize, secondList->key, secondListSize * sizeof *result->key);
+
+    if (result->value) {
+        memcpy(result->value, firstList->value, firstListSize * sizeof *result->value);
+        memcpy(result->value + firstListSize, secondList->value, secondListSize * sizeof *result->value);
+    }
+
+    mergeNetwork->mergeRuns(result, firstListSize, secondListSize, parallel);
+}
+
+
+/**
+ * Function that executes a stage of comparators in ascending direction.
+ *
+ * @warning In team mode it must be called by all the threads of the team, with the same arguments.
+ *
+ * @details The stage is defined on a virtual frame: the element at virtual position v is array[v - frameShift].
+ * @details The comparators that reach outside the array are dropped: this is the same as padding the frame with -inf before the array and +inf after it, since a standard network never moves them.
+ * @details The consecutive comparators are executed by the compareAndSwapStage kernel, by the positionMinMaxStage kernel for position keys, or by payloadMinMaxStage for payloads.
+ * @details In team mode the comparators are split in equal slices, one per thread, followed by a barrier.
+ *
+ * @param elements the elements of the array.
+ * @param arraySize the array size.
+ * @param frameShift the virtual position of the first element of the array.
+ * @param stage the stage.
+ * @param team 1 if the stage is executed by all the threads of the current team, 0 if by the calling thread only.
+ */
+void networkStage(NetworkElements elements, size_t arraySize, size_t frameShift, NetworkStage stage, short team) {
+    /// The keys of the quadruples, NULL for position keys.
+    SortKey *key = elements.quadruples ? elements.quadruples->key : NULL;
+    /// The values of the quadruples, NULL if they are not needed.
+    int *value = elements.quadruples ? elements.quadruples->value : NULL;
+    /// The position keys, NULL for quadruples.
+    PositionKey *positionKey = elements.positionKey;
+    /// The payloads, NULL if the keys move the values of the quadruples.
+    unsigned char *payload = elements.payload;
+    /// The size of each payload.
+    size_t payloadSize = elements.payloadSize;
+
+    /// The first comparator inside the array.
+    size_t firstComparator = networkStageCount(stage, frameShift);
+    /// The last comparator inside the array, excluded.
+    size_t lastComparator = frameShift + arraySize > stage.distance ? networkStageCount(stage, frameShift + arraySize - stage.distance) : 0;
+
+    if (lastComparator > firstComparator) {
+        /// The number of comparators inside the array.
+        size_t comparatorNumber = lastComparator - firstComparator;
+        /// Thread ID.
+        size_t threadID = team ? (size_t) omp_get_thread_num() : 0;
+        /// Number of thread.
+        size_t threadNumber = team ? (size_t) omp_get_num_threads() : 1;
+
+        /// The first comparator of the thread.
+        size_t comparator = firstComparator + comparatorNumber * threadID / threadNumber;
+
+        lastComparator = firstComparator + comparatorNumber * (threadID + 1) / threadNumber;
+
+        while (comparator < lastComparator) {
+            /// The position of the comparator inside its run.
+            size_t offset = comparator % stage.runLength;
+            /// The first element compared.
+            size_t i = stage.start + comparator / stage.runLength * stage.period + offset - frameShift;
+            /// The consecutive comparators of the run.
+            size_t run = stage.runLength - offset < lastComparator - comparator ? stage.runLength - offset : lastComparator - comparator;
+
+            if (positionKey) {
+                positionMinMaxStage(&positionKey[i], &positionKey[i + stage.distance], run);
+            }
+            else if (payload) {
+                payloadMinMaxStage(&key[i], &key[i + stage.distance], payload + i * payloadSize, payload + (i + stage.distance) * payloadSize, run, payloadSize);
+            }
+            else {
+                compareAndSwapStage(&key[i], &key[i + stage.distance], value ? &value[i] : NULL, value ? &value[i + stage.distance] : NULL, run, ASCENDING);
+            }
+            STATS_COMPARATORS(run);
+
+            comparator += run;
+        }
+    }
+
+    if (team) {
+#pragma omp barrier
+    }
+}
+
+/**
+ * Function that merges two sorted runs with the adapted bitonic merge.
+ *
+ * @param array the array that contains the first run, in descending order, followed by the second one.
+ * @param firstRunSize the size of the first run.
+ * @param secondRunSize the size of the second run.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void bitonicMergeRuns(QuadrupleArray *array, size_t firstRunSize, size_t secondRunSize, short parallel) {
+    bitonicMerge(array, 0, firstRunSize + secondRunSize, ASCENDING, parallel);
+}
+
+/**
+ * Function that merges two sorted runs of position keys with the adapted bitonic merge.
+ *
+ * @param key the array that contains the first run, in descending order, followed by the second one.
+ * @param firstRunSize the size of the first run.
+ * @param secondRunSize the size of the second run.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void bitonicMergePositionRuns(PositionKey *key, size_t firstRunSize, size_t secondRunSize, short parallel) {
+    positionBitonicMerge(key, firstRunSize + secondRunSize, parallel);
+}
+
+/**
+ * Function that merges two sorted runs with the Batcher odd-even merge.
+ *
+ * @param array the array that contains the first run followed by the second one, both in ascending order.
+ * @param firstRunSize the size of the first run.
+ * @param secondRunSize the size of the second run.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void oddEvenMergeRuns(QuadrupleArray *array, size_t firstRunSize, size_t secondRunSize, short parallel) {
+    networkRunStages(oddEvenMergeStages, (NetworkElements) {array, NULL, NULL, 0}, firstRunSize, secondRunSize, parallel);
+}
+
+/**
+ * Function that merges two sorted runs of position keys with the Batcher odd-even merge.
+ *
+ * @param key the array that contains the first run followed by the second one, both in ascending order.
+ * @param firstRunSize the size of the first run.
+ * @param secondRunSize the size of the second run.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void oddEvenMergePositionRuns(PositionKey *key, size_t firstRunSize, size_t secondRunSize, short parallel) {
+    networkRunStages(oddEvenMergeStages, (NetworkElements) {NULL, key, NULL, 0}, firstRunSize, secondRunSize, parallel);
+}
+
+/**
+ * Function that executes the stages of the Batcher odd-even merge.
+ *
+ * @details The two runs are placed in a virtual frame of two halves of P elements, P the smallest power of two not less than both runs: the first run ends at the middle of the frame, where the second one starts.
+ * @details The first stage compares the two halves, each following stage at distance k compares the elements k ... 2k - 1 with the next k, every 2k elements.
+ *
+ * @param elements the elements of the array that contains the first run followed by the second one, both in ascending order.
+ * @param firstRunSize the size of the first run.
+ * @param secondRunSize the size of the second run.
+ * @param team 1 if the stages are executed by all the threads of the current team, 0 if by the calling thread only.
+ */
+void oddEvenMergeStages(NetworkElements elements, size_t firstRunSize, size_t secondRunSize, short team) {
+    /// The size of each half of the frame.
+    size_t halfFrameSize = smallestPowerOf2AtLeast(firstRunSize > secondRunSize ? firstRunSize : secondRunSize);
+    /// The virtual position of the first element of the array.
+    size_t frameShift = halfFrameSize - firstRunSize;
+    /// The size of the merged array.
+    size_t arraySize = firstRunSize + secondRunSize;
+
+    networkStage(elements, arraySize, frameShift, (NetworkStage) {0, halfFrameSize, 2 * halfFrameSize, halfFrameSize}, team);
+
+    for (size_t distance = halfFrameSize / 2; distance > 0; distance /= 2) {
+        networkStage(elements, arraySize, frameShift, (NetworkStage) {distance, distance, 2 * distance, distance}, team);
+    }
+}
+
+/**
+ * Function that merges two sorted runs with the Parberry pairwise sorting network.
+ *
+ * @param array the array that contains the first run followed by the second one, both in ascending order.
+ * @param firstRunSize the size of the first run.
+ * @param secondRunSize the size of the second run.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void pairwiseMergeRuns(QuadrupleArray *array, size_t firstRunSize, size_t secondRunSize, short parallel) {
+    networkRunStages(pairwiseMergeStages, (NetworkElements) {array, NULL, NULL, 0}, firstRunSize, secondRunSize, parallel);
+}
+
+/**
+ * Function that merges two sorted runs of position keys with the Parberry pairwise sorting network.
+ *
+ * @param key the array that contains the first run followed by the second one.
+ * @param firstRunSize the size of the first run.
+ * @param secondRunSize the size of the second run.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void pairwiseMergePositionRuns(PositionKey *key, size_t firstRunSize, size_t secondRunSize, short parallel) {
+    networkRunStages(pairwiseMergeStages, (NetworkElements) {NULL, key, NULL, 0}, firstRunSize, secondRunSize, parallel);
+}
+
+/**
+ * Function that executes the stages of the Parberry pairwise sorting network.
+ *
+ * @details The network sorts any sequence, so the order of the two runs is not exploited: it has O(n log^2 n) comparators, but all its stages are made of runs of consecutive comparators.
+ * @details The array is placed at the start of a virtual frame of N elements, N the smallest power of two not less than the array size.
+ * @details The first phase compares, for each a = 1, 2, ..., N / 2, the elements 0 ... a - 1 with the next a, every 2a elements.
+ * @details The second phase, for each a = N / 4, ..., 1 and each d = 2^j - 1, ..., 1, compares the elements a ... 2a - 1 with the ones d * a after, every 2a elements.
+ *
+ * @param elements the elements of the array that contains the first run followed by the second one.
+ * @param firstRunSize the size of the first run.
+ * @param secondRunSize the size of the second run.
+ * @param team 1 if the stages are executed by all the threads of the current team, 0 if by the calling thread only.
+ */
+void pairwiseMergeStages(NetworkElements elements, size_t firstRunSize, size_t secondRunSize, short team) {
+    /// The size of the merged array.
+    size_t arraySize = firstRunSize + secondRunSize;
+    /// The size of the frame.
+    size_t frameSize = smallestPowerOf2AtLeast(arraySize);
+
+    for (size_t runLength = 1; runLength < frameSize; runLength *= 2) {
+        networkStage(elements, arraySize, 0, (NetworkStage) {0, runLength, 2 * runLength, runLength}, team);
+    }
+
+    /// The largest multiplier of the distance of the phase.
+    size_t multiplier = 1;
+
+    for (size_t runLength = frameSize / 4; runLength > 0; runLength /= 2) {
+        for (size_t distance = multiplier; distance > 0; distance /= 2) {
+            networkStage(elements, arraySize, 0, (NetworkStage) {runLength, runLength, 2 * runLength, distance * runLength}, team);
+        }
+
+        multiplier = 2 * multiplier + 1;
+    }
+}
+
+/**
+ * Function that selects the default merging network when the program is loaded.
+ */
+__attribute__((constructor))
+static void mergeNetworkInit(void) {
+    mergeNetworkSelect(MERGE_NETWORK_DEFAULT);
+}
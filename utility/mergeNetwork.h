@@ -0,0 +1,95 @@
+#ifndef DJB_MERGENETWORK_H
+#define DJB_MERGENETWORK_H
+
+
+#include <omp.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "tuple.h"
+#include "quadrupleArray.h"
+#include "bitonicKernel.h"
+#include "bitonicSort.h"
+#include "positionNetwork.h"
+#include "payloadNetwork.h"
+
+
+/// The number of elements below which a network is executed serially even in parallel mode.
+#define MERGE_NETWORK_PARALLEL_CUTOFF 4096
+
+
+/// The comparator networks that can merge two sorted runs.
+typedef enum {
+    /// Adapted bitonic merge, the first run is stored in descending order.
+    MERGE_NETWORK_BITONIC,
+    /// Batcher odd-even merge.
+    MERGE_NETWORK_ODD_EVEN,
+    /// Parberry pairwise sorting network, it sorts the two runs without exploiting their order.
+    MERGE_NETWORK_PAIRWISE
+} MergeNetwork;
+
+/// The network selected when the program is loaded, it can be overridden at compile time.
+#ifndef MERGE_NETWORK_DEFAULT
+#define MERGE_NETWORK_DEFAULT MERGE_NETWORK_BITONIC
+#endif
+
+
+/// The new type representing a merging network.
+typedef struct {
+    /// The network.
+    MergeNetwork network;
+    /// The name of the network.
+    const char *name;
+    /// 1 if the network expects the first run in descending order, so that the two runs form a bitonic sequence, 0 if in ascending order.
+    short reversedFirstRun;
+    /// Function that merges in ascending order the two runs stored one after the other in the array.
+    void (*mergeRuns)(QuadrupleArray *array, size_t firstRunSize, size_t secondRunSize, short parallel);
+    /// Function that merges in ascending order the two runs of position keys stored one after the other in the array.
+    void (*mergePositionRuns)(PositionKey *key, size_t firstRunSize, size_t secondRunSize, short parallel);
+} MergeNetworkStrategy;
+
+/// The new type representing the elements moved by the stages of a network, either quadruples, keys with payloads or position keys.
+typedef struct {
+    /// The quadruples, or the keys of the payloads, NULL if the network moves position keys.
+    QuadrupleArray *quadruples;
+    /// The position keys, NULL if the network moves quadruples.
+    PositionKey *positionKey;
+    /// The payloads moved with the keys of the quadruples instead of their values, NULL if there are none.
+    unsigned char *payload;
+    /// The size of each payload.
+    size_t payloadSize;
+} NetworkElements;
+
+/// The new type representing a stage of comparators (i, i + distance), for each i = start + q * period + r with r < runLength.
+typedef struct {
+    /// The first element of the first run of comparators.
+    size_t start;
+    /// The number of consecutive comparators of each run.
+    size_t runLength;
+    /// The distance between the first elements of two consecutive runs.
+    size_t period;
+    /// The distance between the two elements of a comparator.
+    size_t distance;
+} NetworkStage;
+
+
+/// The active merging network.
+extern const MergeNetworkStrategy *mergeNetwork;
+
+MergeNetwork mergeNetworkSelect(MergeNetwork network);
+const char *mergeNetworkName(MergeNetwork network);
+
+void mergeNetworkSortedLists(QuadrupleArray *result, const QuadrupleArray *firstList, const QuadrupleArray *secondList, short parallel);
+
+void networkStage(NetworkElements elements, size_t arraySize, size_t frameShift, NetworkStage stage, short team);
+void bitonicMergeRuns(QuadrupleArray *array, size_t firstRunSize, size_t secondRunSize, short parallel);
+void bitonicMergePositionRuns(PositionKey *key, size_t firstRunSize, size_t secondRunSize, short parallel);
+void oddEvenMergeRuns(QuadrupleArray *array, size_t firstRunSize, size_t secondRunSize, short parallel);
+void oddEvenMergePositionRuns(PositionKey *key, size_t firstRunSize, size_t secondRunSize, short parallel);
+void oddEvenMergeStages(NetworkElements elements, size_t firstRunSize, size_t secondRunSize, short team);
+void pairwiseMergeRuns(QuadrupleArray *array, size_t firstRunSize, size_t secondRunSize, short parallel);
+void pairwiseMergePositionRuns(PositionKey *key, size_t firstRunSize, size_t secondRunSize, short parallel);
+void pairwiseMergeStages(NetworkElements elements, size_t firstRunSize, size_t secondRunSize, short team);
+
+
+#endif //DJB_MERGENETWORK_H
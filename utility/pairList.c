@@ -36,7 +36,7 @@ void pairlist_reserve(PairList *list, size_t minimumCapacity) {
     capacity |= capacity >> 16;
     // size_t sizze
 #if SIZE_MAX > UINT32_MAX
-    cap |= cap >> 32;  // se size_t > 32 bit
+    capacity |= capacity >> 32;  // se size_t > 32 bit
 #endif
     // capacity = cap + 1;
     capacity++;
@@ -3,6 +3,7 @@
 
 
 #include <stddef.h>
+#include <stdint.h>
 #include <assert.h>
 #include <string.h>
 
@@ -0,0 +1,264 @@
+#include "payloadNetwork.h"
+#include "mergeNetwork.h"
+
+
+/**
+ * Macro that defines the min-max stage and the serial adapted bitonic merge of the keys whose payloads are integers of a given type.
+ *
+ * @details The key comparison gives the mux selector of the comparator, the same mask swaps the keys and, truncated to the payload width, the payloads.
+ * @details The merge calls its own stage, so the comparators are inlined down to the smallest subarrays.
+ *
+ * @param suffix the suffix of the names of the two functions.
+ * @param type the unsigned integer type of the payloads.
+ */
+#define PAYLOAD_NETWORK(suffix, type)                                                                                                          \
+static inline void payloadMinMaxStage##suffix(SortKey *firstKey, SortKey *secondKey, unsigned char *firstPayload, unsigned char *secondPayload, size_t count) { \
+    type *first = (type *) firstPayload;                                                                                                        \
+    type *second = (type *) secondPayload;                                                                                                      \
+                                                                                                                                                \
+    for (size_t i = 0; i < count; ++i) {                                                                                                        \
+        SortKey muxSelector = -(SortKey) (firstKey[i] > secondKey[i]);                                                                          \
+        SortKey keyDifference = (firstKey[i] ^ secondKey[i]) & muxSelector;                                                                     \
+        type payloadDifference = (type) ((first[i] ^ second[i]) & (type) muxSelector);                                                          \
+                                                                                                                                                \
+        firstKey[i] ^= keyDifference;                                                                                                           \
+        secondKey[i] ^= keyDifference;                                                                                                          \
+        first[i] ^= payloadDifference;                                                                                                          \
+        second[i] ^= payloadDifference;                                                                                                         \
+    }                                                                                                                                           \
+}                                                                                                                                               \
+                                                                                                                                                \
+static void payloadBitonicMerge##suffix(SortKey *key, unsigned char *payload, size_t arraySize) {                                               \
+    if (arraySize > 1) {                                                                                                                        \
+        size_t subarraySize = greatestPowerOf2LessThan(arraySize);                                                                              \
+                                                                                                                                                \
+        payloadMinMaxStage##suffix(key, key + subarraySize, payload, payload + subarraySize * sizeof(type), arraySize - subarraySize);          \
+        STATS_COMPARATORS(arraySize - subarraySize);                                                                                            \
+                                                                                                                                                \
+        payloadBitonicMerge##suffix(key, payload, subarraySize);                                                                                \
+        payloadBitonicMerge##suffix(key + subarraySize, payload + subarraySize * sizeof(type), arraySize - subarraySize);                       \
+    }                                                                                                                                           \
+}
+
+PAYLOAD_NETWORK(8, uint8_t)
+PAYLOAD_NETWORK(16, uint16_t)
+PAYLOAD_NETWORK(32, uint32_t)
+PAYLOAD_NETWORK(64, uint64_t)
+
+
+/**
+ * Function that puts the minimum of two arrays of keys in the first one and the maximum in the second one, element by element, with payloads of any size.
+ *
+ * @details The payloads are records: they are swapped 8 bytes at a time, then byte by byte for the remainder.
+ *
+ * @param firstKey the first array of keys.
+ * @param secondKey the second array of keys.
+ * @param firstPayload the payloads of the first array.
+ * @param secondPayload the payloads of the second array.
+ * @param count the number of comparators.
+ * @param payloadSize the size of each payload.
+ */
+static void payloadMinMaxStageRecord(SortKey *firstKey, SortKey *secondKey, unsigned char *firstPayload, unsigned char *secondPayload, size_t count, size_t payloadSize) {
+    for (size_t i = 0; i < count; ++i) {
+        /// The mux selector.
+        /// @details the elements must be swapped --> -1 = 0xFF...FF
+        /// @details the elements are in order    --> 0  = 0x00...00
+        SortKey muxSelector = -(SortKey) (firstKey[i] > secondKey[i]);
+        /// The bits to flip in both keys.
+        SortKey keyDifference = (firstKey[i] ^ secondKey[i]) & muxSelector;
+        /// The payload of the first element.
+        unsigned char *first = firstPayload + i * payloadSize;
+        /// The payload of the second element.
+        unsigned char *second = secondPayload + i * payloadSize;
+        /// The current byte of the payloads.
+        size_t byte = 0;
+
+        firstKey[i] ^= keyDifference;
+        secondKey[i] ^= keyDifference;
+
+        for (; byte + sizeof(uint64_t) <= payloadSize; byte += sizeof(uint64_t)) {
+            /// The 8 bytes of the first payload.
+            uint64_t firstWord;
+            /// The 8 bytes of the second payload.
+            uint64_t secondWord;
+            memcpy(&firstWord, first + byte, sizeof firstWord);
+            memcpy(&secondWord, second + byte, sizeof secondWord);
+
+            /// The bits to flip in both payloads.
+            uint64_t wordDifference = (firstWord ^ secondWord) & muxSelector;
+            firstWord ^= wordDifference;
+            secondWord ^= wordDifference;
+
+            memcpy(first + byte, &firstWord, sizeof firstWord);
+            memcpy(second + byte, &secondWord, sizeof secondWord);
+        }
+
+        for (; byte < payloadSize; ++byte) {
+            /// The bits to flip in both bytes.
+            unsigned char byteDifference = (unsigned char) ((first[byte] ^ second[byte]) & (unsigned char) muxSelector);
+
+            first[byte] ^= byteDifference;
+            second[byte] ^= byteDifference;
+        }
+    }
+}
+
+/**
+ * Function that puts the minimum of two arrays of keys in the first one and the maximum in the second one, element by element, moving their payloads with them.
+ *
+ * @details Only the keys are compared, the payloads follow the mux selector of their comparator at their own width: 1, 2, 4 and 8 bytes are swapped as integers, other sizes as records.
+ * @details The operations do not depend on the keys nor on the payloads.
+ *
+ * @param firstKey the first array of keys.
+ * @param secondKey the second array of keys.
+ * @param firstPayload the payloads of the first array, at least 8-byte aligned for the integer sizes.
+ * @param secondPayload the payloads of the second array.
+ * @param count the number of comparators.
+ * @param payloadSize the size of each payload.
+ */
+void payloadMinMaxStage(SortKey *firstKey, SortKey *secondKey, unsigned char *firstPayload, unsigned char *secondPayload, size_t count, size_t payloadSize) {
+    switch (payloadSize) {
+        case sizeof(uint8_t):
+            payloadMinMaxStage8(firstKey, secondKey, firstPayload, secondPayload, count);
+            break;
+        case sizeof(uint16_t):
+            payloadMinMaxStage16(firstKey, secondKey, firstPayload, secondPayload, count);
+            break;
+        case sizeof(uint32_t):
+            payloadMinMaxStage32(firstKey, secondKey, firstPayload, secondPayload, count);
+            break;
+        case sizeof(uint64_t):
+            payloadMinMaxStage64(firstKey, secondKey, firstPayload, secondPayload, count);
+            break;
+        default:
+            payloadMinMaxStageRecord(firstKey, secondKey, firstPayload, secondPayload, count, payloadSize);
+    }
+}
+
+/**
+ * The adapted bitonic merge of an array of keys with payloads, in ascending order.
+ *
+ * @details The same network as bitonicMerge, the payloads are moved by payloadMinMaxStage; serially, the integer payloads are merged by the network of their type.
+ * @details In parallel mode the whole network is executed inside a single parallel region, see payloadBitonicMergeTeam.
+ *
+ * @param key the bitonic array of keys.
+ * @param payload the payloads of the keys.
+ * @param arraySize the array size.
+ * @param payloadSize the size of each payload.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void payloadBitonicMerge(SortKey *key, unsigned char *payload, size_t arraySize, size_t payloadSize, short parallel) {
+    if (parallel && arraySize >= BITONIC_PARALLEL_CUTOFF) {
+#pragma omp parallel
+        {
+            payloadBitonicMergeTeam(key, payload, arraySize, payloadSize);
+        }
+
+        return;
+    }
+
+    switch (payloadSize) {
+        case sizeof(uint8_t):
+            payloadBitonicMerge8(key, payload, arraySize);
+            return;
+        case sizeof(uint16_t):
+            payloadBitonicMerge16(key, payload, arraySize);
+            return;
+        case sizeof(uint32_t):
+            payloadBitonicMerge32(key, payload, arraySize);
+            return;
+        case sizeof(uint64_t):
+            payloadBitonicMerge64(key, payload, arraySize);
+            return;
+    }
+
+    if (arraySize > 1) {
+        /// The subarray size.
+        size_t subarraySize = greatestPowerOf2LessThan(arraySize);
+
+        payloadMinMaxStage(key, key + subarraySize, payload, payload + subarraySize * payloadSize, arraySize - subarraySize, payloadSize);
+        STATS_COMPARATORS(arraySize - subarraySize);
+
+        payloadBitonicMerge(key, payload, subarraySize, payloadSize, SERIAL);
+        payloadBitonicMerge(key + subarraySize, payload + subarraySize * payloadSize, arraySize - subarraySize, payloadSize, SERIAL);
+    }
+}
+
+/**
+ * The adapted bitonic merge of an array of keys with payloads, executed by all the threads of the current team.
+ *
+ * @warning It must be called by all the threads of the team, with the same arguments.
+ *
+ * @details The network is flattened as in bitonicMergeTeam: the stage at distance d compares i with i + d, for each i whose bit d is 0, and is executed by networkStage, one slice per thread followed by a barrier.
+ * @details As soon as the blocks of 2d elements are at least BITONIC_TEAM_BLOCKS per thread, the blocks are shared among the threads and merged serially, without other barriers.
+ * @details All the threads see the merged array on return.
+ *
+ * @param key the bitonic array of keys.
+ * @param payload the payloads of the keys.
+ * @param arraySize the array size.
+ * @param payloadSize the size of each payload.
+ */
+void payloadBitonicMergeTeam(SortKey *key, unsigned char *payload, size_t arraySize, size_t payloadSize) {
+    /// Number of thread.
+    size_t threadNumber = (size_t) omp_get_num_threads();
+
+    if (arraySize < 2) {
+        return;
+    }
+
+    /// The keys, as the quadruples of the network.
+    QuadrupleArray array = {key, NULL, arraySize};
+    /// The elements moved by the stages.
+    NetworkElements elements = {&array, NULL, payload, payloadSize};
+    /// The distance of the comparators of the stage.
+    size_t distance = greatestPowerOf2LessThan(arraySize);
+
+    while (distance > 1 && (arraySize + 2 * distance - 1) / (2 * distance) < BITONIC_TEAM_BLOCKS * threadNumber) {
+        networkStage(elements, arraySize, 0, (NetworkStage) {0, distance, 2 * distance, distance}, 1);
+
+        distance /= 2;
+    }
+
+    /// The size of the independent blocks.
+    size_t blockSize = 2 * distance;
+    /// The number of independent blocks.
+    size_t blockNumber = (arraySize + blockSize - 1) / blockSize;
+
+#pragma omp for schedule(static)
+    for (size_t block = 0; block < blockNumber; ++block) {
+        /// The first element of the block.
+        size_t blockStart = block * blockSize;
+
+        payloadBitonicMerge(key + blockStart, payload + blockStart * payloadSize, arraySize - blockStart < blockSize ? arraySize - blockStart : blockSize, payloadSize, SERIAL);
+    }
+}
+
+/**
+ * Function that swaps two payloads.
+ *
+ * @param first the first payload.
+ * @param second the second payload.
+ * @param payloadSize the size of each payload.
+ */
+void payloadSwap(unsigned char *first, unsigned char *second, size_t payloadSize) {
+    for (size_t byte = 0; byte < payloadSize; ++byte) {
+        /// The byte to swap.
+        unsigned char temp = first[byte];
+
+        first[byte] = second[byte];
+        second[byte] = temp;
+    }
+}
+
+/**
+ * Function that reverses an array of payloads in place.
+ *
+ * @param payload the payloads.
+ * @param count the number of payloads.
+ * @param payloadSize the size of each payload.
+ */
+void payloadReverse(unsigned char *payload, size_t count, size_t payloadSize) {
+    for (size_t i = 0; i < count / 2; ++i) {
+        payloadSwap(payload + i * payloadSize, payload + (count - 1 - i) * payloadSize, payloadSize);
+    }
+}
@@ -0,0 +1,21 @@
+#ifndef DJB_PAYLOADNETWORK_H
+#define DJB_PAYLOADNETWORK_H
+
+
+#include <omp.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "tuple.h"
+#include "bitonicSort.h"
+
+
+void payloadMinMaxStage(SortKey *firstKey, SortKey *secondKey, unsigned char *firstPayload, unsigned char *secondPayload, size_t count, size_t payloadSize);
+void payloadBitonicMerge(SortKey *key, unsigned char *payload, size_t arraySize, size_t payloadSize, short parallel);
+void payloadBitonicMergeTeam(SortKey *key, unsigned char *payload, size_t arraySize, size_t payloadSize);
+void payloadSwap(unsigned char *first, unsigned char *second, size_t payloadSize);
+void payloadReverse(unsigned char *payload, size_t count, size_t payloadSize);
+
+
+#endif //DJB_PAYLOADNETWORK_H
@@ -0,0 +1,386 @@
+#include "positionNetwork.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define POSITION_NETWORK_X86 1
+#include <immintrin.h>
+#endif
+
+
+static void positionMinMaxStageScalar(PositionKey *first, PositionKey *second, size_t count);
+static void positionMergeRegisterBlockScalar(PositionKey *key);
+
+
+/// The active min-max stage kernel.
+void (*positionMinMaxStage)(PositionKey *first, PositionKey *second, size_t count) = positionMinMaxStageScalar;
+/// The active register block merge kernel.
+void (*positionMergeRegisterBlock)(PositionKey *key) = positionMergeRegisterBlockScalar;
+
+
+/**
+ * Function that puts the minimum of two keys in the first one and the maximum in the second one.
+ *
+ * @details The sign of second - first is computed without branches and without overflow, and turned into the mask of the swap, as in djbsort.
+ *
+ * @param first the first key.
+ * @param second the second key.
+ */
+void positionMinMax(PositionKey *first, PositionKey *second) {
+    /// The bits that differ between the two keys.
+    uint32_t difference = (uint32_t) *first ^ (uint32_t) *second;
+    /// The subtraction second - first, its sign bit fixed when the two keys have different signs.
+    uint32_t sign = (uint32_t) *second - (uint32_t) *first;
+
+    sign ^= difference & (sign ^ (uint32_t) *second);
+
+    /// The mux selector, all the differing bits if the keys have to be swapped, 0 otherwise.
+    uint32_t muxSelector = (0u - (sign >> 31)) & difference;
+
+    *first = (PositionKey) ((uint32_t) *first ^ muxSelector);
+    *second = (PositionKey) ((uint32_t) *second ^ muxSelector);
+}
+
+/**
+ * Function that puts the minimum of two arrays of keys in the first one and the maximum in the second one, element by element.
+ *
+ * @details Scalar version.
+ *
+ * @param first the first array of keys.
+ * @param second the second array of keys.
+ * @param count the number of comparators.
+ */
+static void positionMinMaxStageScalar(PositionKey *first, PositionKey *second, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        positionMinMax(&first[i], &second[i]);
+    }
+}
+
+/**
+ * Function that merges in ascending order a bitonic block of POSITION_REGISTER_BLOCK keys.
+ *
+ * @details Scalar version.
+ *
+ * @param key the keys of the bitonic block.
+ */
+static void positionMergeRegisterBlockScalar(PositionKey *key) {
+    for (size_t distance = POSITION_REGISTER_BLOCK / 2; distance > 0; distance /= 2) {
+        for (size_t i = 0; i < POSITION_REGISTER_BLOCK; ++i) {
+            if (!(i & distance)) {
+                positionMinMax(&key[i], &key[i + distance]);
+            }
+        }
+    }
+}
+
+
+#ifdef POSITION_NETWORK_X86
+
+/**
+ * Function that puts the minimum of two arrays of keys in the first one and the maximum in the second one, element by element.
+ *
+ * @details AVX2 version, eight comparators per instruction.
+ *
+ * @param first the first array of keys.
+ * @param second the second array of keys.
+ * @param count the number of comparators.
+ */
+__attribute__((target("avx2")))
+static void positionMinMaxStageAvx2(PositionKey *first, PositionKey *second, size_t count) {
+    /// The position in the arrays.
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        /// The eight keys of the first array.
+        __m256i firstKeys = _mm256_loadu_si256((const __m256i *) &first[i]);
+        /// The eight keys of the second array.
+        __m256i secondKeys = _mm256_loadu_si256((const __m256i *) &second[i]);
+
+        _mm256_storeu_si256((__m256i *) &first[i], _mm256_min_epi32(firstKeys, secondKeys));
+        _mm256_storeu_si256((__m256i *) &second[i], _mm256_max_epi32(firstKeys, secondKeys));
+    }
+
+    positionMinMaxStageScalar(first + i, second + i, count - i);
+}
+
+/**
+ * Function that executes a stage inside an AVX2 register.
+ *
+ * @param key the eight keys.
+ * @param exchangedKey the keys permuted so that each lane faces its partner.
+ * @param upperLanes the mask of the lanes that are the upper element of their comparator, they keep the maximum.
+ * @return the keys after the stage.
+ */
+__attribute__((target("avx2")))
+static inline __m256i registerStageAvx2(__m256i key, __m256i exchangedKey, __m256i upperLanes) {
+    return _mm256_blendv_epi8(_mm256_min_epi32(key, exchangedKey), _mm256_max_epi32(key, exchangedKey), upperLanes);
+}
+
+/**
+ * Function that merges in ascending order a bitonic block of POSITION_REGISTER_BLOCK keys.
+ *
+ * @details AVX2 version, the block is kept in two registers for the four stages.
+ *
+ * @param key the keys of the bitonic block.
+ */
+__attribute__((target("avx2")))
+static void positionMergeRegisterBlockAvx2(PositionKey *key) {
+    /// The keys 0 to 7.
+    __m256i lowKey = _mm256_loadu_si256((const __m256i *) &key[0]);
+    /// The keys 8 to 15.
+    __m256i highKey = _mm256_loadu_si256((const __m256i *) &key[8]);
+
+    // stage at distance 8: the two registers against each other
+    /// The temporary variable used for the exchange.
+    __m256i temp = _mm256_min_epi32(lowKey, highKey);
+    highKey = _mm256_max_epi32(lowKey, highKey);
+    lowKey = temp;
+
+    // stage at distance 4: the two halves of each register
+    /// The upper lanes of the comparators.
+    __m256i upperLanes = _mm256_setr_epi32(0, 0, 0, 0, -1, -1, -1, -1);
+    lowKey = registerStageAvx2(lowKey, _mm256_permute2x128_si256(lowKey, lowKey, 0x01), upperLanes);
+    highKey = registerStageAvx2(highKey, _mm256_permute2x128_si256(highKey, highKey, 0x01), upperLanes);
+
+    // stage at distance 2: lanes 0, 1 against 2, 3 of each half
+    upperLanes = _mm256_setr_epi32(0, 0, -1, -1, 0, 0, -1, -1);
+    lowKey = registerStageAvx2(lowKey, _mm256_shuffle_epi32(lowKey, _MM_SHUFFLE(1, 0, 3, 2)), upperLanes);
+    highKey = registerStageAvx2(highKey, _mm256_shuffle_epi32(highKey, _MM_SHUFFLE(1, 0, 3, 2)), upperLanes);
+
+    // stage at distance 1: even lanes against odd lanes
+    upperLanes = _mm256_setr_epi32(0, -1, 0, -1, 0, -1, 0, -1);
+    lowKey = registerStageAvx2(lowKey, _mm256_shuffle_epi32(lowKey, _MM_SHUFFLE(2, 3, 0, 1)), upperLanes);
+    highKey = registerStageAvx2(highKey, _mm256_shuffle_epi32(highKey, _MM_SHUFFLE(2, 3, 0, 1)), upperLanes);
+
+    _mm256_storeu_si256((__m256i *) &key[0], lowKey);
+    _mm256_storeu_si256((__m256i *) &key[8], highKey);
+}
+
+
+/**
+ * Function that puts the minimum of two arrays of keys in the first one and the maximum in the second one, element by element.
+ *
+ * @details AVX-512 version, sixteen comparators per instruction, the tail is handled by masked loads and stores.
+ *
+ * @param first the first array of keys.
+ * @param second the second array of keys.
+ * @param count the number of comparators.
+ */
+__attribute__((target("avx512f")))
+static void positionMinMaxStageAvx512(PositionKey *first, PositionKey *second, size_t count) {
+    for (size_t i = 0; i < count; i += 16) {
+        /// The lanes in use, all of them except for the last iteration.
+        __mmask16 loadMask = (__mmask16) (count - i >= 16 ? 0xFFFF : (1u << (count - i)) - 1);
+        /// The sixteen keys of the first array.
+        __m512i firstKeys = _mm512_maskz_loadu_epi32(loadMask, &first[i]);
+        /// The sixteen keys of the second array.
+        __m512i secondKeys = _mm512_maskz_loadu_epi32(loadMask, &second[i]);
+
+        _mm512_mask_storeu_epi32(&first[i], loadMask, _mm512_min_epi32(firstKeys, secondKeys));
+        _mm512_mask_storeu_epi32(&second[i], loadMask, _mm512_max_epi32(firstKeys, secondKeys));
+    }
+}
+
+/**
+ * Function that executes a stage inside an AVX-512 register.
+ *
+ * @param key the sixteen keys.
+ * @param exchangedKey the keys permuted so that each lane faces its partner.
+ * @param upperLanes the mask of the lanes that are the upper element of their comparator, they keep the maximum.
+ * @return the keys after the stage.
+ */
+__attribute__((target("avx512f")))
+static inline __m512i registerStageAvx512(__m512i key, __m512i exchangedKey, __mmask16 upperLanes) {
+    return _mm512_mask_blend_epi32(upperLanes, _mm512_min_epi32(key, exchangedKey), _mm512_max_epi32(key, exchangedKey));
+}
+
+/**
+ * Function that merges in ascending order a bitonic block of POSITION_REGISTER_BLOCK keys.
+ *
+ * @details AVX-512 version, the block is kept in a single register for the four stages.
+ *
+ * @param key the keys of the bitonic block.
+ */
+__attribute__((target("avx512f")))
+static void positionMergeRegisterBlockAvx512(PositionKey *key) {
+    /// The sixteen keys.
+    __m512i blockKey = _mm512_loadu_si512(key);
+
+    // stage at distance 8: lanes 0 to 7 against 8 to 15
+    blockKey = registerStageAvx512(blockKey, _mm512_shuffle_i64x2(blockKey, blockKey, _MM_SHUFFLE(1, 0, 3, 2)), 0xFF00);
+    // stage at distance 4: the two halves of each 256-bit part
+    blockKey = registerStageAvx512(blockKey, _mm512_shuffle_i64x2(blockKey, blockKey, _MM_SHUFFLE(2, 3, 0, 1)), 0xF0F0);
+    // stage at distance 2: lanes 0, 1 against 2, 3 of each 128-bit part
+    blockKey = registerStageAvx512(blockKey, _mm512_shuffle_epi32(blockKey, _MM_PERM_BADC), 0xCCCC);
+    // stage at distance 1: even lanes against odd lanes
+    blockKey = registerStageAvx512(blockKey, _mm512_shuffle_epi32(blockKey, _MM_PERM_CDAB), 0xAAAA);
+
+    _mm512_storeu_si512(key, blockKey);
+}
+
+#endif
+
+
+/**
+ * The adapted bitonic merge of an array of position keys, in ascending order.
+ *
+ * @details The same network as bitonicMerge, with min and max instead of compare and swap: the keys have no values and are half the size of the quadruple keys, so each vector comparator handles twice as many of them.
+ * @details In parallel mode the whole network is executed inside a single parallel region, see positionBitonicMergeTeam.
+ *
+ * @param key the bitonic array of keys.
+ * @param arraySize the array size.
+ * @param parallel the type of algorithm execution, either parallel mode, 1, or serial mode, 0.
+ */
+void positionBitonicMerge(PositionKey *key, size_t arraySize, short parallel) {
+    if (parallel && arraySize >= BITONIC_PARALLEL_CUTOFF) {
+#pragma omp parallel
+        {
+            positionBitonicMergeTeam(key, arraySize);
+        }
+    }
+    else if (arraySize == POSITION_REGISTER_BLOCK) {
+        positionMergeRegisterBlock(key);
+        STATS_COMPARATORS(POSITION_REGISTER_COMPARATORS);
+    }
+    else if (arraySize > 1) {
+        /// The subarray size.
+        size_t subarraySize = greatestPowerOf2LessThan(arraySize);
+
+        positionMinMaxStage(key, key + subarraySize, arraySize - subarraySize);
+        STATS_COMPARATORS(arraySize - subarraySize);
+
+        positionBitonicMerge(key, subarraySize, SERIAL);
+        positionBitonicMerge(key + subarraySize, arraySize - subarraySize, SERIAL);
+    }
+}
+
+/**
+ * The adapted bitonic merge of an array of position keys, executed by all the threads of the current team.
+ *
+ * @warning It must be called by all the threads of the team, with the same arguments.
+ *
+ * @details The stages are flattened and split among the threads as in bitonicMergeTeam, until the independent blocks are enough to be merged serially, one per thread.
+ * @details All the threads see the merged array on return.
+ *
+ * @param key the bitonic array of keys.
+ * @param arraySize the array size.
+ */
+void positionBitonicMergeTeam(PositionKey *key, size_t arraySize) {
+    /// Thread ID.
+    size_t threadID = (size_t) omp_get_thread_num();
+    /// Number of thread.
+    size_t threadNumber = (size_t) omp_get_num_threads();
+
+    if (arraySize < 2) {
+        return;
+    }
+
+    /// The distance of the comparators of the stage.
+    size_t distance = greatestPowerOf2LessThan(arraySize);
+
+    while (2 * distance > POSITION_REGISTER_BLOCK && (arraySize + 2 * distance - 1) / (2 * distance) < BITONIC_TEAM_BLOCKS * threadNumber) {
+        /// The number of comparators of the stage: distance for each full block, the ones that fit in the last partial block.
+        size_t comparatorNumber = arraySize / (2 * distance) * distance + (arraySize % (2 * distance) > distance ? arraySize % (2 * distance) - distance : 0);
+        /// The first comparator of the thread.
+        size_t comparator = comparatorNumber * threadID / threadNumber;
+        /// The last comparator of the thread, excluded.
+        size_t lastComparator = comparatorNumber * (threadID + 1) / threadNumber;
+
+        while (comparator < lastComparator) {
+            /// The position of the comparator inside its block.
+            size_t offset = comparator % distance;
+            /// The first element compared.
+            size_t i = 2 * (comparator - offset) + offset;
+            /// The consecutive comparators of the block.
+            size_t run = distance - offset < lastComparator - comparator ? distance - offset : lastComparator - comparator;
+
+            positionMinMaxStage(&key[i], &key[i + distance], run);
+            STATS_COMPARATORS(run);
+
+            comparator += run;
+        }
+
+#pragma omp barrier
+
+        distance /= 2;
+    }
+
+    /// The size of the independent blocks.
+    size_t blockSize = 2 * distance;
+    /// The number of independent blocks.
+    size_t blockNumber = (arraySize + blockSize - 1) / blockSize;
+
+#pragma omp for schedule(static)
+    for (size_t block = 0; block < blockNumber; ++block) {
+        /// The first element of the block.
+        size_t blockStart = block * blockSize;
+
+        positionBitonicMerge(key + blockStart, arraySize - blockStart < blockSize ? arraySize - blockStart : blockSize, SERIAL);
+    }
+}
+
+
+/**
+ * The adapted bitonic merge of laneNumber independent arrays of position keys of the same size, in ascending order.
+ *
+ * @details The arrays are interleaved, the element i of the lane l is key[i * laneNumber + l]: the comparators of positionBitonicMerge depend only on the size,
+ * so each of them compares two contiguous groups of laneNumber keys, and a whole stage is a single positionMinMaxStage over (arraySize - subarraySize) * laneNumber keys.
+ * @details With laneNumber a multiple of the vector width the kernels are never left with a partial vector, even for the smallest arrays.
+ *
+ * @param key the interleaved bitonic arrays of keys.
+ * @param arraySize the size of each array.
+ * @param laneNumber the number of arrays.
+ */
+void positionBitonicMergeInterleaved(PositionKey *key, size_t arraySize, size_t laneNumber) {
+    if (arraySize > 1) {
+        /// The subarray size.
+        size_t subarraySize = greatestPowerOf2LessThan(arraySize);
+
+        positionMinMaxStage(key, key + subarraySize * laneNumber, (arraySize - subarraySize) * laneNumber);
+        STATS_COMPARATORS((arraySize - subarraySize) * laneNumber);
+
+        positionBitonicMergeInterleaved(key, subarraySize, laneNumber);
+        positionBitonicMergeInterleaved(key + subarraySize * laneNumber, arraySize - subarraySize, laneNumber);
+    }
+}
+
+
+/**
+ * Function that selects the kernels of the position network.
+ *
+ * @details If the requested instruction set is not supported by the CPU, the best supported one that is not wider is used.
+ *
+ * @param kernel the requested instruction set.
+ * @return the instruction set actually selected.
+ */
+BitonicKernel positionNetworkSelect(BitonicKernel kernel) {
+    positionMinMaxStage = positionMinMaxStageScalar;
+    positionMergeRegisterBlock = positionMergeRegisterBlockScalar;
+
+#ifdef POSITION_NETWORK_X86
+    __builtin_cpu_init();
+
+    if (kernel >= BITONIC_KERNEL_AVX512 && __builtin_cpu_supports("avx512f")) {
+        positionMinMaxStage = positionMinMaxStageAvx512;
+        positionMergeRegisterBlock = positionMergeRegisterBlockAvx512;
+
+        return BITONIC_KERNEL_AVX512;
+    }
+    else if (kernel >= BITONIC_KERNEL_AVX2 && __builtin_cpu_supports("avx2")) {
+        positionMinMaxStage = positionMinMaxStageAvx2;
+        positionMergeRegisterBlock = positionMergeRegisterBlockAvx2;
+
+        return BITONIC_KERNEL_AVX2;
+    }
+#else
+    (void) kernel;
+#endif
+
+    return BITONIC_KERNEL_SCALAR;
+}
+
+/**
+ * Function that selects the widest kernels supported by the CPU when the program is loaded.
+ */
+__attribute__((constructor))
+static void positionNetworkInit(void) {
+    positionNetworkSelect(BITONIC_KERNEL_AVX512);
+}
@@ -0,0 +1,34 @@
+#ifndef DJB_POSITIONNETWORK_H
+#define DJB_POSITIONNETWORK_H
+
+
+#include <omp.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "tuple.h"
+#include "bitonicKernel.h"
+#include "bitonicSort.h"
+
+
+/// The number of position keys that are merged entirely inside the vector registers.
+#define POSITION_REGISTER_BLOCK 16
+/// The number of comparators of the merge of a register block, log2(POSITION_REGISTER_BLOCK) stages of POSITION_REGISTER_BLOCK / 2.
+#define POSITION_REGISTER_COMPARATORS (POSITION_REGISTER_BLOCK / 2 * 4)
+
+
+/// Kernel that puts min(first[i], second[i]) in first[i] and max(first[i], second[i]) in second[i], for each i less than count.
+extern void (*positionMinMaxStage)(PositionKey *first, PositionKey *second, size_t count);
+/// Kernel that merges in ascending order a bitonic block of POSITION_REGISTER_BLOCK keys.
+extern void (*positionMergeRegisterBlock)(PositionKey *key);
+
+void positionMinMax(PositionKey *first, PositionKey *second);
+
+void positionBitonicMerge(PositionKey *key, size_t arraySize, short parallel);
+void positionBitonicMergeTeam(PositionKey *key, size_t arraySize);
+void positionBitonicMergeInterleaved(PositionKey *key, size_t arraySize, size_t laneNumber);
+
+BitonicKernel positionNetworkSelect(BitonicKernel kernel);
+
+
+#endif //DJB_POSITIONNETWORK_H
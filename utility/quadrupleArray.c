@@ -0,0 +1,46 @@
+#include "quadrupleArray.h"
+
+
+/**
+ * Function that initializes the quadrupleArray.
+ *
+ * @param array the quadrupleArray to initialize.
+ */
+void quadruplearray_init(QuadrupleArray *array) {
+    array->key = NULL;
+    array->value = NULL;
+    array->arraySize = 0;
+}
+
+/**
+ * Function that allocates the arrays of the quadrupleArray.
+ *
+ * @note The values are allocated only if requested, the kernels of the network skip them when they are NULL.
+ *
+ * @param array the quadrupleArray.
+ * @param arraySize the number of quadruples.
+ * @param withValue whether the values index1 must be allocated, 1, or not, 0.
+ */
+void quadruplearray_alloc(QuadrupleArray *array, size_t arraySize, short withValue) {
+    array->key = malloc((arraySize ? arraySize : 1) * sizeof *array->key);
+    assert(array->key && "Malloc error!!!");
+
+    array->value = NULL;
+    if (withValue) {
+        array->value = malloc((arraySize ? arraySize : 1) * sizeof *array->value);
+        assert(array->value && "Malloc error!!!");
+    }
+
+    array->arraySize = arraySize;
+}
+
+/**
+ * Function that frees the memory allocated for the quadrupleArray and resets the structure to its initial state.
+ *
+ * @param array the quadrupleArray.
+ */
+void quadruplearray_free(QuadrupleArray *array) {
+    free(array->key);
+    free(array->value);
+    quadruplearray_init(array);
+}
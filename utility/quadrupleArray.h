@@ -0,0 +1,29 @@
+#ifndef DJB_QUADRUPLEARRAY_H
+#define DJB_QUADRUPLEARRAY_H
+
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "tuple.h"
+
+
+/// The new type representing an array of quadruple < index0, fromLeft, indexInItsList, index1> stored as separate arrays.
+/// @details index0, fromLeft and indexInItsList are packed in the sort key, fromLeft is the tag bit of the key.
+typedef struct {
+    /// The packed sort keys of the quadruples.
+    SortKey *key;
+    /// The values index1 of the quadruples, NULL if the values are not needed.
+    int *value;
+    /// The number of quadruples.
+    size_t arraySize;
+} QuadrupleArray;
+
+
+void quadruplearray_init(QuadrupleArray *array);
+void quadruplearray_alloc(QuadrupleArray *array, size_t arraySize, short withValue);
+void quadruplearray_free(QuadrupleArray *array);
+
+
+#endif //DJB_QUADRUPLEARRAY_H
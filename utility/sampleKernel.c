@@ -0,0 +1,149 @@
+#include "sampleKernel.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SAMPLE_KERNEL_X86 1
+#include <immintrin.h>
+#endif
+
+
+static void multiplyShiftRangeScalar(int *result, const unsigned char *random, size_t count, uint32_t firstRange);
+
+
+/// The active range reduction kernel.
+void (*multiplyShiftRange)(int *result, const unsigned char *random, size_t count, uint32_t firstRange) = multiplyShiftRangeScalar;
+
+
+/**
+ * Function that reduces random integers to growing ranges.
+ *
+ * @details Scalar version: the 64-bit random r and the range R give floor(r * R / 2^64), computed from two 32 x 32-bit products.
+ * @details There is no rejection, so the time does not depend on the random bytes: each result is off the uniform distribution by less than R / 2^64.
+ *
+ * @param result the buffer of count integers.
+ * @param random the 8 * count random bytes.
+ * @param count the number of integers.
+ * @param firstRange the range of the first integer, the range of the integer i is firstRange + i.
+ */
+static void multiplyShiftRangeScalar(int *result, const unsigned char *random, size_t count, uint32_t firstRange) {
+    for (size_t i = 0; i < count; ++i) {
+        /// The bytes of the random integer.
+        const unsigned char *bytes = random + SAMPLE_RANDOM_BYTES * i;
+        /// The low half of the random integer.
+        uint32_t low = (uint32_t) bytes[0] | (uint32_t) bytes[1] << 8 | (uint32_t) bytes[2] << 16 | (uint32_t) bytes[3] << 24;
+        /// The high half of the random integer.
+        uint32_t high = (uint32_t) bytes[4] | (uint32_t) bytes[5] << 8 | (uint32_t) bytes[6] << 16 | (uint32_t) bytes[7] << 24;
+        /// The range of the integer.
+        uint64_t range = firstRange + (uint32_t) i;
+
+        result[i] = (int) (((uint64_t) high * range + ((uint64_t) low * range >> 32)) >> 32);
+    }
+}
+
+
+#ifdef SAMPLE_KERNEL_X86
+
+/**
+ * Function that reduces random integers to growing ranges.
+ *
+ * @details AVX2 version, four integers per iteration: the 32 x 32-bit products are computed by vpmuludq on the halves of the 64-bit lanes.
+ *
+ * @param result the buffer of count integers.
+ * @param random the 8 * count random bytes.
+ * @param count the number of integers.
+ * @param firstRange the range of the first integer, the range of the integer i is firstRange + i.
+ */
+__attribute__((target("avx2")))
+static void multiplyShiftRangeAvx2(int *result, const unsigned char *random, size_t count, uint32_t firstRange) {
+    /// The ranges of the four integers.
+    __m256i range = _mm256_add_epi64(_mm256_set1_epi64x(firstRange), _mm256_setr_epi64x(0, 1, 2, 3));
+    /// The number of elements processed by the vector loop.
+    size_t vectorCount = count & ~(size_t) 3;
+
+    for (size_t i = 0; i < vectorCount; i += 4) {
+        /// The four random integers.
+        __m256i value = _mm256_loadu_si256((const __m256i *) (random + SAMPLE_RANDOM_BYTES * i));
+        /// The products of the low halves, shifted.
+        __m256i lowProduct = _mm256_srli_epi64(_mm256_mul_epu32(value, range), 32);
+        /// The products of the high halves.
+        __m256i highProduct = _mm256_mul_epu32(_mm256_srli_epi64(value, 32), range);
+        /// The reduced integers, in the high halves of the lanes.
+        __m256i reduced = _mm256_add_epi64(highProduct, lowProduct);
+
+        _mm_storeu_si128((__m128i *) &result[i], _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(reduced, _mm256_setr_epi32(1, 3, 5, 7, 0, 0, 0, 0))));
+        range = _mm256_add_epi64(range, _mm256_set1_epi64x(4));
+    }
+
+    multiplyShiftRangeScalar(result + vectorCount, random + SAMPLE_RANDOM_BYTES * vectorCount, count - vectorCount, firstRange + (uint32_t) vectorCount);
+}
+
+/**
+ * Function that reduces random integers to growing ranges.
+ *
+ * @details AVX-512 version, eight integers per iteration, the tail is handled by masked loads and stores.
+ *
+ * @param result the buffer of count integers.
+ * @param random the 8 * count random bytes.
+ * @param count the number of integers.
+ * @param firstRange the range of the first integer, the range of the integer i is firstRange + i.
+ */
+__attribute__((target("avx512f")))
+static void multiplyShiftRangeAvx512(int *result, const unsigned char *random, size_t count, uint32_t firstRange) {
+    /// The ranges of the eight integers.
+    __m512i range = _mm512_add_epi64(_mm512_set1_epi64(firstRange), _mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7));
+
+    for (size_t i = 0; i < count; i += 8) {
+        /// The lanes in use, all of them except for the last iteration.
+        __mmask8 loadMask = (__mmask8) (count - i >= 8 ? 0xFF : (1u << (count - i)) - 1);
+        /// The eight random integers.
+        __m512i value = _mm512_maskz_loadu_epi64(loadMask, random + SAMPLE_RANDOM_BYTES * i);
+        /// The products of the low halves, shifted.
+        __m512i lowProduct = _mm512_srli_epi64(_mm512_mul_epu32(value, range), 32);
+        /// The products of the high halves.
+        __m512i highProduct = _mm512_mul_epu32(_mm512_srli_epi64(value, 32), range);
+
+        _mm512_mask_cvtepi64_storeu_epi32(&result[i], loadMask, _mm512_srli_epi64(_mm512_add_epi64(highProduct, lowProduct), 32));
+        range = _mm512_add_epi64(range, _mm512_set1_epi64(8));
+    }
+}
+
+#endif
+
+
+/**
+ * Function that selects the kernels of the sampling.
+ *
+ * @details If the requested instruction set is not supported by the CPU, the best supported one that is not wider is used.
+ *
+ * @param kernel the requested instruction set.
+ * @return the instruction set actually selected.
+ */
+BitonicKernel sampleKernelSelect(BitonicKernel kernel) {
+    multiplyShiftRange = multiplyShiftRangeScalar;
+
+#ifdef SAMPLE_KERNEL_X86
+    __builtin_cpu_init();
+
+    if (kernel >= BITONIC_KERNEL_AVX512 && __builtin_cpu_supports("avx512f")) {
+        multiplyShiftRange = multiplyShiftRangeAvx512;
+
+        return BITONIC_KERNEL_AVX512;
+    }
+    else if (kernel >= BITONIC_KERNEL_AVX2 && __builtin_cpu_supports("avx2")) {
+        multiplyShiftRange = multiplyShiftRangeAvx2;
+
+        return BITONIC_KERNEL_AVX2;
+    }
+#else
+    (void) kernel;
+#endif
+
+    return BITONIC_KERNEL_SCALAR;
+}
+
+/**
+ * Function that selects the widest kernels supported by the CPU when the program is loaded.
+ */
+__attribute__((constructor))
+static void sampleKernelInit(void) {
+    sampleKernelSelect(BITONIC_KERNEL_AVX512);
+}
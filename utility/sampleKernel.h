@@ -0,0 +1,21 @@
+#ifndef DJB_SAMPLEKERNEL_H
+#define DJB_SAMPLEKERNEL_H
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bitonicKernel.h"
+
+
+/// The number of random bytes consumed by each sampled integer.
+#define SAMPLE_RANDOM_BYTES 8
+
+
+/// Kernel that writes in result[i] the 64-bit little-endian random[8i ... 8i + 7] reduced to [0, firstRange + i) by multiplication and shift.
+extern void (*multiplyShiftRange)(int *result, const unsigned char *random, size_t count, uint32_t firstRange);
+
+BitonicKernel sampleKernelSelect(BitonicKernel kernel);
+
+
+#endif //DJB_SAMPLEKERNEL_H
@@ -0,0 +1,767 @@
+#include "scanKernel.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SCAN_KERNEL_X86 1
+#include <immintrin.h>
+#endif
+
+
+static int exclusiveScanScalar(int *result, const int *list, size_t count, int offset);
+static int exclusiveScanFromLeftInverseScalar(int *result, const SortKey *key, size_t count, int offset);
+static int emitMergedPositionsScalar(int *result, const SortKey *key, size_t count, int offset);
+static int emitMergedPairsScalar(Pair *result, const SortKey *key, const int *value, size_t count, int offset);
+static int emitMergedPositionKeysScalar(int *result, const PositionKey *key, size_t count, int offset);
+static uint64_t packMergedBitsScalar(const PositionKey *key, size_t count);
+
+
+/// The active exclusive scan kernel.
+int (*exclusiveScan)(int *result, const int *list, size_t count, int offset) = exclusiveScanScalar;
+/// The active exclusive scan kernel of the inverse of the fromLeft.
+int (*exclusiveScanFromLeftInverse)(int *result, const SortKey *key, size_t count, int offset) = exclusiveScanFromLeftInverseScalar;
+/// The active kernel that emits the merged positions.
+int (*emitMergedPositions)(int *result, const SortKey *key, size_t count, int offset) = emitMergedPositionsScalar;
+/// The active kernel that emits the merged pairs.
+int (*emitMergedPairs)(Pair *result, const SortKey *key, const int *value, size_t count, int offset) = emitMergedPairsScalar;
+/// The active kernel that emits the merged positions of position keys.
+int (*emitMergedPositionKeys)(int *result, const PositionKey *key, size_t count, int offset) = emitMergedPositionKeysScalar;
+/// The active kernel that packs the merged bits.
+uint64_t (*packMergedBits)(const PositionKey *key, size_t count) = packMergedBitsScalar;
+
+
+/**
+ * Function that computes the exclusive prefix sums of an array.
+ *
+ * @details Scalar version.
+ *
+ * @param result the buffer of count elements, it may be the list itself.
+ * @param list the array.
+ * @param count the array size.
+ * @param offset the value added to all the prefix sums.
+ * @return the offset plus the sum of all the elements.
+ */
+static int exclusiveScanScalar(int *result, const int *list, size_t count, int offset) {
+    for (size_t i = 0; i < count; ++i) {
+        /// The element, read before its prefix sum overwrites it.
+        int element = list[i];
+
+        result[i] = offset;
+        offset += element;
+    }
+
+    return offset;
+}
+
+/**
+ * Function that computes the exclusive prefix sums of the inverse of the fromLeft of an array of keys.
+ *
+ * @details Scalar version.
+ *
+ * @param result the buffer of count elements.
+ * @param key the array of keys.
+ * @param count the array size.
+ * @param offset the value added to all the prefix sums.
+ * @return the offset plus the number of keys that do not come from the left list.
+ */
+static int exclusiveScanFromLeftInverseScalar(int *result, const SortKey *key, size_t count, int offset) {
+    for (size_t i = 0; i < count; ++i) {
+        result[i] = offset;
+        offset += 1 - sortKeyFromLeft(key[i]);
+    }
+
+    return offset;
+}
+
+/**
+ * Function that computes the final positions of the merged elements.
+ *
+ * @details Scalar version.
+ *
+ * @param result the buffer of count positions.
+ * @param key the merged keys.
+ * @param count the number of keys.
+ * @param offset the number of keys before the first one that do not come from the left list.
+ * @return the offset plus the number of keys that do not come from the left list.
+ */
+static int emitMergedPositionsScalar(int *result, const SortKey *key, size_t count, int offset) {
+    for (size_t i = 0; i < count; ++i) {
+        result[i] = sortKeyIndex0(key[i]) + offset;
+        offset += 1 - sortKeyFromLeft(key[i]);
+    }
+
+    return offset;
+}
+
+/**
+ * Function that computes the merged pairs, the values with their final positions.
+ *
+ * @details Scalar version.
+ *
+ * @param result the buffer of count pairs.
+ * @param key the merged keys.
+ * @param value the merged values.
+ * @param count the number of keys.
+ * @param offset the number of keys before the first one that do not come from the left list.
+ * @return the offset plus the number of keys that do not come from the left list.
+ */
+static int emitMergedPairsScalar(Pair *result, const SortKey *key, const int *value, size_t count, int offset) {
+    for (size_t i = 0; i < count; ++i) {
+        result[i].index0 = sortKeyIndex0(key[i]) + offset;
+        result[i].index1 = value[i];
+        offset += 1 - sortKeyFromLeft(key[i]);
+    }
+
+    return offset;
+}
+
+/**
+ * Function that computes the final positions of the merged position keys.
+ *
+ * @details Scalar version.
+ *
+ * @param result the buffer of count positions.
+ * @param key the merged position keys.
+ * @param count the number of keys.
+ * @param offset the number of keys before the first one that do not come from the left list.
+ * @return the offset plus the number of keys that do not come from the left list.
+ */
+static int emitMergedPositionKeysScalar(int *result, const PositionKey *key, size_t count, int offset) {
+    for (size_t i = 0; i < count; ++i) {
+        result[i] = positionKeyIndex0(key[i]) + offset;
+        offset += 1 - positionKeyFromLeft(key[i]);
+    }
+
+    return offset;
+}
+
+
+/**
+ * Function that packs the bits of the merged position keys in a limb.
+ *
+ * @details Scalar version.
+ *
+ * @param key the merged position keys.
+ * @param count the number of keys, at most 64.
+ * @return the limb, whose bit i is 1 if key[i] does not come from the left list.
+ */
+static uint64_t packMergedBitsScalar(const PositionKey *key, size_t count) {
+    /// The packed bits.
+    uint64_t limb = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        limb |= (uint64_t) (1 - positionKeyFromLeft(key[i])) << i;
+    }
+
+    return limb;
+}
+
+
+#ifdef SCAN_KERNEL_X86
+
+/**
+ * Function that computes the inclusive prefix sums of the eight integers of an AVX2 register.
+ *
+ * @details Each 128-bit lane is scanned with two shifts, then the total of the lower lane is added to the upper one.
+ *
+ * @param element the eight integers.
+ * @return the eight inclusive prefix sums.
+ */
+__attribute__((target("avx2")))
+static inline __m256i inclusiveScanAvx2(__m256i element) {
+    element = _mm256_add_epi32(element, _mm256_slli_si256(element, 4));
+    element = _mm256_add_epi32(element, _mm256_slli_si256(element, 8));
+
+    return _mm256_add_epi32(element, _mm256_shuffle_epi32(_mm256_permute2x128_si256(element, element, 0x08), 0xFF));
+}
+
+/**
+ * Function that computes the exclusive prefix sums of an array.
+ *
+ * @details AVX2 version: eight elements are scanned inside a register, the running offset is broadcast from its last lane.
+ *
+ * @param result the buffer of count elements, it may be the list itself.
+ * @param list the array.
+ * @param count the array size.
+ * @param offset the value added to all the prefix sums.
+ * @return the offset plus the sum of all the elements.
+ */
+__attribute__((target("avx2")))
+static int exclusiveScanAvx2(int *result, const int *list, size_t count, int offset) {
+    /// The running offset, in all the lanes.
+    __m256i offsetLanes = _mm256_set1_epi32(offset);
+    /// The number of elements processed by the vector loop.
+    size_t vectorCount = count & ~(size_t) 7;
+
+    for (size_t i = 0; i < vectorCount; i += 8) {
+        /// The eight elements.
+        __m256i element = _mm256_loadu_si256((const __m256i *) &list[i]);
+        /// The inclusive prefix sums, offset included.
+        __m256i inclusive = _mm256_add_epi32(offsetLanes, inclusiveScanAvx2(element));
+
+        _mm256_storeu_si256((__m256i *) &result[i], _mm256_sub_epi32(inclusive, element));
+        offsetLanes = _mm256_permutevar8x32_epi32(inclusive, _mm256_set1_epi32(7));
+    }
+
+    return exclusiveScanScalar(result + vectorCount, list + vectorCount, count - vectorCount, _mm256_cvtsi256_si32(offsetLanes));
+}
+
+/**
+ * Function that computes the exclusive prefix sums of the inverse of the fromLeft of an array of keys.
+ *
+ * @details AVX2 version: the fromLeft bits of eight keys are gathered in a register of integers, then scanned as in exclusiveScanAvx2.
+ *
+ * @param result the buffer of count elements.
+ * @param key the array of keys.
+ * @param count the array size.
+ * @param offset the value added to all the prefix sums.
+ * @return the offset plus the number of keys that do not come from the left list.
+ */
+__attribute__((target("avx2")))
+static int exclusiveScanFromLeftInverseAvx2(int *result, const SortKey *key, size_t count, int offset) {
+    /// The running offset, in all the lanes.
+    __m256i offsetLanes = _mm256_set1_epi32(offset);
+    /// The number of elements processed by the vector loop.
+    size_t vectorCount = count & ~(size_t) 7;
+    /// The permutation that moves the lower halves of the keys in the lower 128 bits.
+    __m256i lowerHalves = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+
+    for (size_t i = 0; i < vectorCount; i += 8) {
+        /// The lower halves of the first four keys.
+        __m256i first = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i *) &key[i]), lowerHalves);
+        /// The lower halves of the last four keys.
+        __m256i second = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i *) &key[i + 4]), lowerHalves);
+        /// The eight elements, 1 - fromLeft.
+        __m256i element = _mm256_sub_epi32(_mm256_set1_epi32(1), _mm256_srli_epi32(_mm256_permute2x128_si256(first, second, 0x20), 31));
+        /// The inclusive prefix sums, offset included.
+        __m256i inclusive = _mm256_add_epi32(offsetLanes, inclusiveScanAvx2(element));
+
+        _mm256_storeu_si256((__m256i *) &result[i], _mm256_sub_epi32(inclusive, element));
+        offsetLanes = _mm256_permutevar8x32_epi32(inclusive, _mm256_set1_epi32(7));
+    }
+
+    return exclusiveScanFromLeftInverseScalar(result + vectorCount, key + vectorCount, count - vectorCount, _mm256_cvtsi256_si32(offsetLanes));
+}
+
+/**
+ * Function that splits eight keys in their upper and lower halves.
+ *
+ * @param key the eight keys.
+ * @param upperHalf the upper halves of the keys, their index0 with the sign bit flipped.
+ * @param lowerHalf the lower halves of the keys, their fromLeft in the top bit.
+ */
+__attribute__((target("avx2")))
+static inline void splitKeysAvx2(const SortKey *key, __m256i *upperHalf, __m256i *lowerHalf) {
+    /// The permutation that moves the upper halves of the keys in the lower 128 bits and the lower halves in the upper ones.
+    __m256i halves = _mm256_setr_epi32(1, 3, 5, 7, 0, 2, 4, 6);
+    /// The halves of the first four keys.
+    __m256i first = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i *) key), halves);
+    /// The halves of the last four keys.
+    __m256i second = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i *) (key + 4)), halves);
+
+    *upperHalf = _mm256_permute2x128_si256(first, second, 0x20);
+    *lowerHalf = _mm256_permute2x128_si256(first, second, 0x31);
+}
+
+/**
+ * Function that computes the final positions of the merged elements.
+ *
+ * @details AVX2 version: the index0 and the fromLeft of eight keys are split in two registers, the fromLeft are scanned as in exclusiveScanAvx2.
+ *
+ * @param result the buffer of count positions.
+ * @param key the merged keys.
+ * @param count the number of keys.
+ * @param offset the number of keys before the first one that do not come from the left list.
+ * @return the offset plus the number of keys that do not come from the left list.
+ */
+__attribute__((target("avx2")))
+static int emitMergedPositionsAvx2(int *result, const SortKey *key, size_t count, int offset) {
+    /// The running offset, in all the lanes.
+    __m256i offsetLanes = _mm256_set1_epi32(offset);
+    /// The number of elements processed by the vector loop.
+    size_t vectorCount = count & ~(size_t) 7;
+
+    for (size_t i = 0; i < vectorCount; i += 8) {
+        /// The upper halves of the keys.
+        __m256i upperHalf;
+        /// The lower halves of the keys.
+        __m256i lowerHalf;
+        splitKeysAvx2(&key[i], &upperHalf, &lowerHalf);
+
+        /// The eight elements, 1 - fromLeft.
+        __m256i element = _mm256_sub_epi32(_mm256_set1_epi32(1), _mm256_srli_epi32(lowerHalf, 31));
+        /// The inclusive prefix sums, offset included.
+        __m256i inclusive = _mm256_add_epi32(offsetLanes, inclusiveScanAvx2(element));
+        /// The index0 of the keys.
+        __m256i index0 = _mm256_xor_si256(upperHalf, _mm256_set1_epi32((int) 0x80000000));
+
+        _mm256_storeu_si256((__m256i *) &result[i], _mm256_add_epi32(index0, _mm256_sub_epi32(inclusive, element)));
+        offsetLanes = _mm256_permutevar8x32_epi32(inclusive, _mm256_set1_epi32(7));
+    }
+
+    return emitMergedPositionsScalar(result + vectorCount, key + vectorCount, count - vectorCount, _mm256_cvtsi256_si32(offsetLanes));
+}
+
+/**
+ * Function that computes the merged pairs, the values with their final positions.
+ *
+ * @details AVX2 version: the positions are computed as in emitMergedPositionsAvx2, then interleaved with the values.
+ *
+ * @param result the buffer of count pairs.
+ * @param key the merged keys.
+ * @param value the merged values.
+ * @param count the number of keys.
+ * @param offset the number of keys before the first one that do not come from the left list.
+ * @return the offset plus the number of keys that do not come from the left list.
+ */
+__attribute__((target("avx2")))
+static int emitMergedPairsAvx2(Pair *result, const SortKey *key, const int *value, size_t count, int offset) {
+    /// The running offset, in all the lanes.
+    __m256i offsetLanes = _mm256_set1_epi32(offset);
+    /// The number of elements processed by the vector loop.
+    size_t vectorCount = count & ~(size_t) 7;
+
+    for (size_t i = 0; i < vectorCount; i += 8) {
+        /// The upper halves of the keys.
+        __m256i upperHalf;
+        /// The lower halves of the keys.
+        __m256i lowerHalf;
+        splitKeysAvx2(&key[i], &upperHalf, &lowerHalf);
+
+        /// The eight elements, 1 - fromLeft.
+        __m256i element = _mm256_sub_epi32(_mm256_set1_epi32(1), _mm256_srli_epi32(lowerHalf, 31));
+        /// The inclusive prefix sums, offset included.
+        __m256i inclusive = _mm256_add_epi32(offsetLanes, inclusiveScanAvx2(element));
+        /// The final positions.
+        __m256i position = _mm256_add_epi32(_mm256_xor_si256(upperHalf, _mm256_set1_epi32((int) 0x80000000)), _mm256_sub_epi32(inclusive, element));
+        /// The eight values.
+        __m256i pairValue = _mm256_loadu_si256((const __m256i *) &value[i]);
+        /// The pairs 0, 1, 4, 5.
+        __m256i lowerPairs = _mm256_unpacklo_epi32(pairValue, position);
+        /// The pairs 2, 3, 6, 7.
+        __m256i upperPairs = _mm256_unpackhi_epi32(pairValue, position);
+
+        _mm256_storeu_si256((__m256i *) &result[i], _mm256_permute2x128_si256(lowerPairs, upperPairs, 0x20));
+        _mm256_storeu_si256((__m256i *) &result[i + 4], _mm256_permute2x128_si256(lowerPairs, upperPairs, 0x31));
+        offsetLanes = _mm256_permutevar8x32_epi32(inclusive, _mm256_set1_epi32(7));
+    }
+
+    return emitMergedPairsScalar(result + vectorCount, key + vectorCount, value + vectorCount, count - vectorCount, _mm256_cvtsi256_si32(offsetLanes));
+}
+
+/**
+ * Function that computes the final positions of the merged position keys.
+ *
+ * @details AVX2 version: eight keys per register, the index0 and the fromLeft are extracted by a shift and a mask, the fromLeft are scanned as in exclusiveScanAvx2.
+ *
+ * @param result the buffer of count positions.
+ * @param key the merged position keys.
+ * @param count the number of keys.
+ * @param offset the number of keys before the first one that do not come from the left list.
+ * @return the offset plus the number of keys that do not come from the left list.
+ */
+__attribute__((target("avx2")))
+static int emitMergedPositionKeysAvx2(int *result, const PositionKey *key, size_t count, int offset) {
+    /// The running offset, in all the lanes.
+    __m256i offsetLanes = _mm256_set1_epi32(offset);
+    /// The number of elements processed by the vector loop.
+    size_t vectorCount = count & ~(size_t) 7;
+
+    for (size_t i = 0; i < vectorCount; i += 8) {
+        /// The eight keys.
+        __m256i keys = _mm256_loadu_si256((const __m256i *) &key[i]);
+        /// The eight elements, 1 - fromLeft.
+        __m256i element = _mm256_andnot_si256(keys, _mm256_set1_epi32(1));
+        /// The inclusive prefix sums, offset included.
+        __m256i inclusive = _mm256_add_epi32(offsetLanes, inclusiveScanAvx2(element));
+
+        _mm256_storeu_si256((__m256i *) &result[i], _mm256_add_epi32(_mm256_srai_epi32(keys, 1), _mm256_sub_epi32(inclusive, element)));
+        offsetLanes = _mm256_permutevar8x32_epi32(inclusive, _mm256_set1_epi32(7));
+    }
+
+    return emitMergedPositionKeysScalar(result + vectorCount, key + vectorCount, count - vectorCount, _mm256_cvtsi256_si32(offsetLanes));
+}
+
+/**
+ * Function that packs the bits of the merged position keys in a limb.
+ *
+ * @details AVX2 version: the fromLeft of eight keys are moved to the sign bits and gathered by a single movemask.
+ *
+ * @param key the merged position keys.
+ * @param count the number of keys, at most 64.
+ * @return the limb, whose bit i is 1 if key[i] does not come from the left list.
+ */
+__attribute__((target("avx2")))
+static uint64_t packMergedBitsAvx2(const PositionKey *key, size_t count) {
+    /// The packed bits.
+    uint64_t limb = 0;
+    /// The number of elements processed by the vector loop.
+    size_t vectorCount = count & ~(size_t) 7;
+
+    for (size_t i = 0; i < vectorCount; i += 8) {
+        /// The fromLeft of the eight keys, in the sign bits.
+        __m256i fromLeft = _mm256_slli_epi32(_mm256_loadu_si256((const __m256i *) &key[i]), 31);
+
+        limb |= (uint64_t) (~_mm256_movemask_ps(_mm256_castsi256_ps(fromLeft)) & 0xFF) << i;
+    }
+
+    return limb | (packMergedBitsScalar(key + vectorCount, count - vectorCount) << (vectorCount & 63));
+}
+
+
+/**
+ * Function that computes the inclusive prefix sums of the sixteen integers of an AVX-512 register.
+ *
+ * @param element the sixteen integers.
+ * @return the sixteen inclusive prefix sums.
+ */
+__attribute__((target("avx512f")))
+static inline __m512i inclusiveScanAvx512(__m512i element) {
+    /// The lanes shifted in from below.
+    __m512i zero = _mm512_setzero_si512();
+
+    element = _mm512_add_epi32(element, _mm512_alignr_epi32(element, zero, 15));
+    element = _mm512_add_epi32(element, _mm512_alignr_epi32(element, zero, 14));
+    element = _mm512_add_epi32(element, _mm512_alignr_epi32(element, zero, 12));
+
+    return _mm512_add_epi32(element, _mm512_alignr_epi32(element, zero, 8));
+}
+
+/**
+ * Function that computes the exclusive prefix sums of an array.
+ *
+ * @details AVX-512 version: sixteen elements are scanned inside a register, the running offset is broadcast from its last lane.
+ *
+ * @param result the buffer of count elements, it may be the list itself.
+ * @param list the array.
+ * @param count the array size.
+ * @param offset the value added to all the prefix sums.
+ * @return the offset plus the sum of all the elements.
+ */
+__attribute__((target("avx512f")))
+static int exclusiveScanAvx512(int *result, const int *list, size_t count, int offset) {
+    /// The running offset, in all the lanes.
+    __m512i offsetLanes = _mm512_set1_epi32(offset);
+    /// The number of elements processed by the vector loop.
+    size_t vectorCount = count & ~(size_t) 15;
+
+    for (size_t i = 0; i < vectorCount; i += 16) {
+        /// The sixteen elements.
+        __m512i element = _mm512_loadu_si512(&list[i]);
+        /// The inclusive prefix sums, offset included.
+        __m512i inclusive = _mm512_add_epi32(offsetLanes, inclusiveScanAvx512(element));
+
+        _mm512_storeu_si512(&result[i], _mm512_sub_epi32(inclusive, element));
+        offsetLanes = _mm512_permutexvar_epi32(_mm512_set1_epi32(15), inclusive);
+    }
+
+    return exclusiveScanScalar(result + vectorCount, list + vectorCount, count - vectorCount, _mm_cvtsi128_si32(_mm512_castsi512_si128(offsetLanes)));
+}
+
+/**
+ * Function that computes the exclusive prefix sums of the inverse of the fromLeft of an array of keys.
+ *
+ * @details AVX-512 version: the fromLeft bits of sixteen keys are gathered in a register of integers, then scanned as in exclusiveScanAvx512.
+ *
+ * @param result the buffer of count elements.
+ * @param key the array of keys.
+ * @param count the array size.
+ * @param offset the value added to all the prefix sums.
+ * @return the offset plus the number of keys that do not come from the left list.
+ */
+__attribute__((target("avx512f")))
+static int exclusiveScanFromLeftInverseAvx512(int *result, const SortKey *key, size_t count, int offset) {
+    /// The running offset, in all the lanes.
+    __m512i offsetLanes = _mm512_set1_epi32(offset);
+    /// The number of elements processed by the vector loop.
+    size_t vectorCount = count & ~(size_t) 15;
+
+    for (size_t i = 0; i < vectorCount; i += 16) {
+        /// The lower halves of the first eight keys.
+        __m256i first = _mm512_cvtepi64_epi32(_mm512_loadu_si512(&key[i]));
+        /// The lower halves of the last eight keys.
+        __m256i second = _mm512_cvtepi64_epi32(_mm512_loadu_si512(&key[i + 8]));
+        /// The sixteen elements, 1 - fromLeft.
+        __m512i element = _mm512_sub_epi32(_mm512_set1_epi32(1), _mm512_srli_epi32(_mm512_inserti64x4(_mm512_castsi256_si512(first), second, 1), 31));
+        /// The inclusive prefix sums, offset included.
+        __m512i inclusive = _mm512_add_epi32(offsetLanes, inclusiveScanAvx512(element));
+
+        _mm512_storeu_si512(&result[i], _mm512_sub_epi32(inclusive, element));
+        offsetLanes = _mm512_permutexvar_epi32(_mm512_set1_epi32(15), inclusive);
+    }
+
+    return exclusiveScanFromLeftInverseScalar(result + vectorCount, key + vectorCount, count - vectorCount, _mm_cvtsi128_si32(_mm512_castsi512_si128(offsetLanes)));
+}
+
+/**
+ * Function that splits sixteen keys in their upper and lower halves.
+ *
+ * @param key the sixteen keys.
+ * @param upperHalf the upper halves of the keys, their index0 with the sign bit flipped.
+ * @param lowerHalf the lower halves of the keys, their fromLeft in the top bit.
+ */
+__attribute__((target("avx512f")))
+static inline void splitKeysAvx512(const SortKey *key, __m512i *upperHalf, __m512i *lowerHalf) {
+    /// The first eight keys.
+    __m512i first = _mm512_loadu_si512(key);
+    /// The last eight keys.
+    __m512i second = _mm512_loadu_si512(key + 8);
+
+    *upperHalf = _mm512_inserti64x4(_mm512_castsi256_si512(_mm512_cvtepi64_epi32(_mm512_srli_epi64(first, 32))), _mm512_cvtepi64_epi32(_mm512_srli_epi64(second, 32)), 1);
+    *lowerHalf = _mm512_inserti64x4(_mm512_castsi256_si512(_mm512_cvtepi64_epi32(first)), _mm512_cvtepi64_epi32(second), 1);
+}
+
+/**
+ * Function that computes the final positions of the merged elements.
+ *
+ * @details AVX-512 version: the index0 and the fromLeft of sixteen keys are split in two registers, the fromLeft are scanned as in exclusiveScanAvx512.
+ *
+ * @param result the buffer of count positions.
+ * @param key the merged keys.
+ * @param count the number of keys.
+ * @param offset the number of keys before the first one that do not come from the left list.
+ * @return the offset plus the number of keys that do not come from the left list.
+ */
+__attribute__((target("avx512f")))
+static int emitMergedPositionsAvx512(int *result, const SortKey *key, size_t count, int offset) {
+    /// The running offset, in all the lanes.
+    __m512i offsetLanes = _mm512_set1_epi32(offset);
+    /// The number of elements processed by the vector loop.
+    size_t vectorCount = count & ~(size_t) 15;
+
+    for (size_t i = 0; i < vectorCount; i += 16) {
+        /// The upper halves of the keys.
+        __m512i upperHalf;
+        /// The lower halves of the keys.
+        __m512i lowerHalf;
+        splitKeysAvx512(&key[i], &upperHalf, &lowerHalf);
+
+        /// The sixteen elements, 1 - fromLeft.
+        __m512i element = _mm512_sub_epi32(_mm512_set1_epi32(1), _mm512_srli_epi32(lowerHalf, 31));
+        /// The inclusive prefix sums, offset included.
+        __m512i inclusive = _mm512_add_epi32(offsetLanes, inclusiveScanAvx512(element));
+        /// The index0 of the keys.
+        __m512i index0 = _mm512_xor_si512(upperHalf, _mm512_set1_epi32((int) 0x80000000));
+
+        _mm512_storeu_si512(&result[i], _mm512_add_epi32(index0, _mm512_sub_epi32(inclusive, element)));
+        offsetLanes = _mm512_permutexvar_epi32(_mm512_set1_epi32(15), inclusive);
+    }
+
+    return emitMergedPositionsScalar(result + vectorCount, key + vectorCount, count - vectorCount, _mm_cvtsi128_si32(_mm512_castsi512_si128(offsetLanes)));
+}
+
+/**
+ * Function that computes the merged pairs, the values with their final positions.
+ *
+ * @details AVX-512 version: the positions are computed as in emitMergedPositionsAvx512, then interleaved with the values.
+ *
+ * @param result the buffer of count pairs.
+ * @param key the merged keys.
+ * @param value the merged values.
+ * @param count the number of keys.
+ * @param offset the number of keys before the first one that do not come from the left list.
+ * @return the offset plus the number of keys that do not come from the left list.
+ */
+__attribute__((target("avx512f")))
+static int emitMergedPairsAvx512(Pair *result, const SortKey *key, const int *value, size_t count, int offset) {
+    /// The running offset, in all the lanes.
+    __m512i offsetLanes = _mm512_set1_epi32(offset);
+    /// The number of elements processed by the vector loop.
+    size_t vectorCount = count & ~(size_t) 15;
+
+    for (size_t i = 0; i < vectorCount; i += 16) {
+        /// The upper halves of the keys.
+        __m512i upperHalf;
+        /// The lower halves of the keys.
+        __m512i lowerHalf;
+        splitKeysAvx512(&key[i], &upperHalf, &lowerHalf);
+
+        /// The sixteen elements, 1 - fromLeft.
+        __m512i element = _mm512_sub_epi32(_mm512_set1_epi32(1), _mm512_srli_epi32(lowerHalf, 31));
+        /// The inclusive prefix sums, offset included.
+        __m512i inclusive = _mm512_add_epi32(offsetLanes, inclusiveScanAvx512(element));
+        /// The final positions.
+        __m512i position = _mm512_add_epi32(_mm512_xor_si512(upperHalf, _mm512_set1_epi32((int) 0x80000000)), _mm512_sub_epi32(inclusive, element));
+        /// The sixteen values.
+        __m512i pairValue = _mm512_loadu_si512(&value[i]);
+        /// The pairs 0, 1, 4, 5, 8, 9, 12, 13.
+        __m512i lowerPairs = _mm512_unpacklo_epi32(pairValue, position);
+        /// The pairs 2, 3, 6, 7, 10, 11, 14, 15.
+        __m512i upperPairs = _mm512_unpackhi_epi32(pairValue, position);
+
+        _mm512_storeu_si512(&result[i], _mm512_permutex2var_epi64(lowerPairs, _mm512_setr_epi64(0, 1, 8, 9, 2, 3, 10, 11), upperPairs));
+        _mm512_storeu_si512(&result[i + 8], _mm512_permutex2var_epi64(lowerPairs, _mm512_setr_epi64(4, 5, 12, 13, 6, 7, 14, 15), upperPairs));
+        offsetLanes = _mm512_permutexvar_epi32(_mm512_set1_epi32(15), inclusive);
+    }
+
+    return emitMergedPairsScalar(result + vectorCount, key + vectorCount, value + vectorCount, count - vectorCount, _mm_cvtsi128_si32(_mm512_castsi512_si128(offsetLanes)));
+}
+
+/**
+ * Function that computes the final positions of the merged position keys.
+ *
+ * @details AVX-512 version: sixteen keys per register, the index0 and the fromLeft are extracted by a shift and a mask, the fromLeft are scanned as in exclusiveScanAvx512.
+ *
+ * @param result the buffer of count positions.
+ * @param key the merged position keys.
+ * @param count the number of keys.
+ * @param offset the number of keys before the first one that do not come from the left list.
+ * @return the offset plus the number of keys that do not come from the left list.
+ */
+__attribute__((target("avx512f")))
+static int emitMergedPositionKeysAvx512(int *result, const PositionKey *key, size_t count, int offset) {
+    /// The running offset, in all the lanes.
+    __m512i offsetLanes = _mm512_set1_epi32(offset);
+    /// The number of elements processed by the vector loop.
+    size_t vectorCount = count & ~(size_t) 15;
+
+    for (size_t i = 0; i < vectorCount; i += 16) {
+        /// The sixteen keys.
+        __m512i keys = _mm512_loadu_si512(&key[i]);
+        /// The sixteen elements, 1 - fromLeft.
+        __m512i element = _mm512_andnot_si512(keys, _mm512_set1_epi32(1));
+        /// The inclusive prefix sums, offset included.
+        __m512i inclusive = _mm512_add_epi32(offsetLanes, inclusiveScanAvx512(element));
+
+        _mm512_storeu_si512(&result[i], _mm512_add_epi32(_mm512_srai_epi32(keys, 1), _mm512_sub_epi32(inclusive, element)));
+        offsetLanes = _mm512_permutexvar_epi32(_mm512_set1_epi32(15), inclusive);
+    }
+
+    return emitMergedPositionKeysScalar(result + vectorCount, key + vectorCount, count - vectorCount, _mm_cvtsi128_si32(_mm512_castsi512_si128(offsetLanes)));
+}
+
+/**
+ * Function that packs the bits of the merged position keys in a limb.
+ *
+ * @details AVX-512 version: the keys whose fromLeft is 0 are selected sixteen at a time by a single test, the tail by a masked load.
+ *
+ * @param key the merged position keys.
+ * @param count the number of keys, at most 64.
+ * @return the limb, whose bit i is 1 if key[i] does not come from the left list.
+ */
+__attribute__((target("avx512f")))
+static uint64_t packMergedBitsAvx512(const PositionKey *key, size_t count) {
+    /// The packed bits.
+    uint64_t limb = 0;
+
+    for (size_t i = 0; i < count; i += 16) {
+        /// The lanes in use, all of them except for the last iteration.
+        __mmask16 loadMask = (__mmask16) (count - i >= 16 ? 0xFFFF : (1u << (count - i)) - 1);
+        /// The sixteen keys.
+        __m512i keys = _mm512_maskz_loadu_epi32(loadMask, &key[i]);
+
+        limb |= (uint64_t) _mm512_mask_testn_epi32_mask(loadMask, keys, _mm512_set1_epi32(1)) << i;
+    }
+
+    return limb;
+}
+
+#endif
+
+
+/**
+ * Function that sums the elements of an array.
+ *
+ * @param list the array.
+ * @param count the array size.
+ * @return the sum of the elements.
+ */
+int sumIntegers(const int *list, size_t count) {
+    /// The sum of the elements.
+    int sum = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        sum += list[i];
+    }
+
+    return sum;
+}
+
+/**
+ * Function that counts the keys that do not come from the left list.
+ *
+ * @param key the array of keys.
+ * @param count the array size.
+ * @return the sum of 1 - fromLeft of the keys.
+ */
+int countFromLeftInverse(const SortKey *key, size_t count) {
+    /// The sum of the fromLeft of the keys.
+    int fromLeftSum = 0;
+
+    // the fromLeft bit is read as in sortKeyFromLeft, inline so that the loop is vectorized
+    for (size_t i = 0; i < count; ++i) {
+        fromLeftSum += (int) ((key[i] >> 31) & 1);
+    }
+
+    return (int) count - fromLeftSum;
+}
+
+/**
+ * Function that counts the position keys that do not come from the left list.
+ *
+ * @param key the array of position keys.
+ * @param count the array size.
+ * @return the sum of 1 - fromLeft of the keys.
+ */
+int countFromLeftInversePositionKeys(const PositionKey *key, size_t count) {
+    /// The sum of the fromLeft of the keys.
+    int fromLeftSum = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        fromLeftSum += positionKeyFromLeft(key[i]);
+    }
+
+    return (int) count - fromLeftSum;
+}
+
+/**
+ * Function that selects the kernels of the prefix sums.
+ *
+ * @details If the requested instruction set is not supported by the CPU, the best supported one that is not wider is used.
+ *
+ * @param kernel the requested instruction set.
+ * @return the instruction set actually selected.
+ */
+BitonicKernel scanKernelSelect(BitonicKernel kernel) {
+    exclusiveScan = exclusiveScanScalar;
+    exclusiveScanFromLeftInverse = exclusiveScanFromLeftInverseScalar;
+    emitMergedPositions = emitMergedPositionsScalar;
+    emitMergedPairs = emitMergedPairsScalar;
+    emitMergedPositionKeys = emitMergedPositionKeysScalar;
+    packMergedBits = packMergedBitsScalar;
+
+#ifdef SCAN_KERNEL_X86
+    __builtin_cpu_init();
+
+    if (kernel >= BITONIC_KERNEL_AVX512 && __builtin_cpu_supports("avx512f")) {
+        exclusiveScan = exclusiveScanAvx512;
+        exclusiveScanFromLeftInverse = exclusiveScanFromLeftInverseAvx512;
+        emitMergedPositions = emitMergedPositionsAvx512;
+        emitMergedPairs = emitMergedPairsAvx512;
+        emitMergedPositionKeys = emitMergedPositionKeysAvx512;
+        packMergedBits = packMergedBitsAvx512;
+
+        return BITONIC_KERNEL_AVX512;
+    }
+    else if (kernel >= BITONIC_KERNEL_AVX2 && __builtin_cpu_supports("avx2")) {
+        exclusiveScan = exclusiveScanAvx2;
+        exclusiveScanFromLeftInverse = exclusiveScanFromLeftInverseAvx2;
+        emitMergedPositions = emitMergedPositionsAvx2;
+        emitMergedPairs = emitMergedPairsAvx2;
+        emitMergedPositionKeys = emitMergedPositionKeysAvx2;
+        packMergedBits = packMergedBitsAvx2;
+
+        return BITONIC_KERNEL_AVX2;
+    }
+#else
+    (void) kernel;
+#endif
+
+    return BITONIC_KERNEL_SCALAR;
+}
+
+/**
+ * Function that selects the widest kernels supported by the CPU when the program is loaded.
+ */
+__attribute__((constructor))
+static void scanKernelInit(void) {
+    scanKernelSelect(BITONIC_KERNEL_AVX512);
+}
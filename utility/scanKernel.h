@@ -0,0 +1,32 @@
+#ifndef DJB_SCANKERNEL_H
+#define DJB_SCANKERNEL_H
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "tuple.h"
+#include "bitonicKernel.h"
+
+
+/// Kernel that writes in result[i] the offset plus the sum of the elements of the list before i, result may be the list itself.
+extern int (*exclusiveScan)(int *result, const int *list, size_t count, int offset);
+/// Kernel that writes in result[i] the offset plus the number of keys before i that do not come from the left list, i.e. the sum of 1 - fromLeft.
+extern int (*exclusiveScanFromLeftInverse)(int *result, const SortKey *key, size_t count, int offset);
+/// Kernel that writes in result[i] the index0 of key[i] plus the exclusive scan of 1 - fromLeft, i.e. the final position of a merged element.
+extern int (*emitMergedPositions)(int *result, const SortKey *key, size_t count, int offset);
+/// Kernel that writes in result[i] the pair <value[i], final position of key[i]>, as emitMergedPositions.
+extern int (*emitMergedPairs)(Pair *result, const SortKey *key, const int *value, size_t count, int offset);
+/// Kernel that writes in result[i] the index0 of the position key[i] plus the exclusive scan of 1 - fromLeft, as emitMergedPositions.
+extern int (*emitMergedPositionKeys)(int *result, const PositionKey *key, size_t count, int offset);
+/// Kernel that packs the bits 1 - fromLeft of at most 64 position keys in a limb, the bit i being the one of key[i].
+extern uint64_t (*packMergedBits)(const PositionKey *key, size_t count);
+
+int sumIntegers(const int *list, size_t count);
+int countFromLeftInverse(const SortKey *key, size_t count);
+int countFromLeftInversePositionKeys(const PositionKey *key, size_t count);
+
+BitonicKernel scanKernelSelect(BitonicKernel kernel);
+
+
+#endif //DJB_SCANKERNEL_H
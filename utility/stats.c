@@ -0,0 +1,247 @@
+#include "stats.h"
+
+
+#ifdef DJB_STATS
+_Thread_local StatsThread statsThread;
+#endif
+
+
+/**
+ * Function that tells whether the library is compiled with the statistics, i.e. with DJB_STATS defined.
+ *
+ * @return 1 if the hooks accumulate the statistics, 0 if they are compiled out.
+ */
+short stats_enabled(void) {
+#ifdef DJB_STATS
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Function that reads the statistics of the calling thread.
+ *
+ * @details Without DJB_STATS the statistics are all 0.
+ *
+ * @param stats the buffer of the statistics.
+ */
+void stats_get(Stats *stats) {
+#ifdef DJB_STATS
+    *stats = statsThread.stats;
+#else
+    memset(stats, 0, sizeof *stats);
+#endif
+}
+
+/**
+ * Function that resets the statistics of the calling thread.
+ *
+ * @warning It must not be called inside a phase.
+ */
+void stats_reset(void) {
+#ifdef DJB_STATS
+    memset(&statsThread, 0, sizeof statsThread);
+#endif
+}
+
+/**
+ * Function that sums the statistics of all the threads.
+ *
+ * @details The threads of the parallel regions are the ones of the pool of the OpenMP runtime, which keeps them alive between the regions:
+ * a parallel region of omp_get_max_threads() threads reads each one of them.
+ * @details The peaks are summed too, so they are an upper bound of the peaks of the whole process.
+ * @warning The sum misses the threads of nested parallel regions and of regions larger than omp_get_max_threads().
+ *
+ * @param stats the buffer of the sum.
+ */
+void stats_collect(Stats *stats) {
+    memset(stats, 0, sizeof *stats);
+
+#ifdef DJB_STATS
+#pragma omp parallel
+    {
+#pragma omp critical(stats)
+        stats_add(stats, &statsThread.stats);
+    }
+#endif
+}
+
+/**
+ * Function that resets the statistics of all the threads, see stats_collect.
+ *
+ * @warning It must not be called inside a phase.
+ */
+void stats_reset_all(void) {
+#ifdef DJB_STATS
+#pragma omp parallel
+    stats_reset();
+#endif
+}
+
+/**
+ * Function that adds some statistics to a sum.
+ *
+ * @param total the sum.
+ * @param stats the statistics to add.
+ */
+void stats_add(Stats *total, const Stats *stats) {
+    for (int phase = 0; phase < STATS_PHASE_NUMBER; ++phase) {
+        total->phaseTime[phase] += stats->phaseTime[phase];
+        total->phaseCount[phase] += stats->phaseCount[phase];
+    }
+
+    total->comparatorNumber += stats->comparatorNumber;
+    total->allocationNumber += stats->allocationNumber;
+    total->allocatedBytes += stats->allocatedBytes;
+    total->liveBytes += stats->liveBytes;
+    total->peakLiveBytes += stats->peakLiveBytes;
+    total->peakArenaBytes += stats->peakArenaBytes;
+}
+
+/**
+ * Function that returns the name of a phase.
+ *
+ * @param phase the phase.
+ * @return the name of the phase.
+ */
+const char *stats_phase_name(StatsPhase phase) {
+    switch (phase) {
+        case STATS_PHASE_KEYS:
+            return "keys";
+        case STATS_PHASE_NETWORK:
+            return "network";
+        case STATS_PHASE_PREFIX_SUM:
+            return "prefixSum";
+        case STATS_PHASE_COPY_OUT:
+            return "copyOut";
+        case STATS_PHASE_ALLOCATION:
+            return "allocation";
+        default:
+            return "unknown";
+    }
+}
+
+/**
+ * Function that writes the statistics, one per row.
+ *
+ * @param output the stream.
+ * @param stats the statistics.
+ */
+void stats_print(FILE *output, const Stats *stats) {
+    for (int phase = 0; phase < STATS_PHASE_NUMBER; ++phase) {
+        fprintf(output, "%-12s %12.6f ms %12llu calls\n", stats_phase_name((StatsPhase) phase), stats->phaseTime[phase] * 1e3, (unsigned long long) stats->phaseCount[phase]);
+    }
+
+    fprintf(output, "comparators  %12llu\n", (unsigned long long) stats->comparatorNumber);
+    fprintf(output, "allocations  %12llu, %llu bytes\n", (unsigned long long) stats->allocationNumber, (unsigned long long) stats->allocatedBytes);
+    fprintf(output, "live bytes   %12llu, peak %llu\n", (unsigned long long) stats->liveBytes, (unsigned long long) stats->peakLiveBytes);
+    fprintf(output, "arena peak   %12llu bytes\n", (unsigned long long) stats->peakArenaBytes);
+}
+
+/**
+ * Function that enters a phase, through the STATS_PHASE_BEGIN hook.
+ *
+ * @details The time of the phase in progress is accounted up to now, then the new phase is accounted from now: the time of each phase excludes the phases nested inside it.
+ *
+ * @param phase the phase.
+ */
+void stats_phase_begin(StatsPhase phase) {
+#ifdef DJB_STATS
+    /// The current wall time.
+    double now = omp_get_wtime();
+
+    if (statsThread.phaseDepth) {
+        /// The innermost phase in progress.
+        size_t top = (statsThread.phaseDepth < STATS_PHASE_DEPTH ? statsThread.phaseDepth : STATS_PHASE_DEPTH) - 1;
+
+        statsThread.stats.phaseTime[statsThread.phaseStack[top]] += now - statsThread.phaseStart;
+    }
+
+    if (statsThread.phaseDepth < STATS_PHASE_DEPTH) {
+        statsThread.phaseStack[statsThread.phaseDepth] = phase;
+    }
+
+    ++statsThread.phaseDepth;
+    ++statsThread.stats.phaseCount[phase];
+    statsThread.phaseStart = now;
+#else
+    (void) phase;
+#endif
+}
+
+/**
+ * Function that leaves a phase, through the STATS_PHASE_END hook.
+ *
+ * @details The time of the phase is accounted up to now, then the phase that contains it is accounted again from now.
+ *
+ * @param phase the phase, the innermost one in progress.
+ */
+void stats_phase_end(StatsPhase phase) {
+#ifdef DJB_STATS
+    /// The current wall time.
+    double now = omp_get_wtime();
+
+    assert(statsThread.phaseDepth && "Phase not begun!!!");
+
+    /// The innermost phase in progress.
+    size_t top = (statsThread.phaseDepth < STATS_PHASE_DEPTH ? statsThread.phaseDepth : STATS_PHASE_DEPTH) - 1;
+
+    assert((statsThread.phaseDepth > STATS_PHASE_DEPTH || statsThread.phaseStack[top] == phase) && "Phase not matching!!!");
+
+    statsThread.stats.phaseTime[statsThread.phaseStack[top]] += now - statsThread.phaseStart;
+    --statsThread.phaseDepth;
+    statsThread.phaseStart = now;
+#else
+    (void) phase;
+#endif
+}
+
+/**
+ * Function that accounts an allocation of scratch memory, through the STATS_ALLOCATE hook.
+ *
+ * @param size the bytes allocated.
+ */
+void stats_allocate(size_t size) {
+#ifdef DJB_STATS
+    ++statsThread.stats.allocationNumber;
+    statsThread.stats.allocatedBytes += size;
+    statsThread.stats.liveBytes += size;
+
+    if (statsThread.stats.liveBytes > statsThread.stats.peakLiveBytes) {
+        statsThread.stats.peakLiveBytes = statsThread.stats.liveBytes;
+    }
+#else
+    (void) size;
+#endif
+}
+
+/**
+ * Function that accounts the release of scratch memory, through the STATS_DEALLOCATE hook.
+ *
+ * @details Memory allocated by another thread is released from the live bytes of the calling thread, so the live bytes of a single thread can wrap around: only their sum over the threads is meaningful then.
+ *
+ * @param size the bytes released.
+ */
+void stats_deallocate(size_t size) {
+#ifdef DJB_STATS
+    statsThread.stats.liveBytes -= size;
+#else
+    (void) size;
+#endif
+}
+
+/**
+ * Function that accounts the bytes in use in an arena, through the STATS_ARENA_USED hook.
+ *
+ * @param used the bytes in use in the arena.
+ */
+void stats_arena_used(size_t used) {
+#ifdef DJB_STATS
+    if (used > statsThread.stats.peakArenaBytes) {
+        statsThread.stats.peakArenaBytes = used;
+    }
+#else
+    (void) used;
+#endif
+}
@@ -0,0 +1,113 @@
+#ifndef DJB_STATS_H
+#define DJB_STATS_H
+
+
+#include <omp.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+
+/// The maximum number of nested phases tracked by each thread, the deeper ones are accounted to the innermost tracked phase.
+#define STATS_PHASE_DEPTH 32
+
+
+/// The phases of the algorithms, each one accumulates its own wall time.
+typedef enum {
+    /// Construction of the sort keys, the pairs and the quadruples fed to the networks.
+    STATS_PHASE_KEYS,
+    /// Merging and sorting networks.
+    STATS_PHASE_NETWORK,
+    /// Prefix sums.
+    STATS_PHASE_PREFIX_SUM,
+    /// Copy of the merged keys to the outputs.
+    STATS_PHASE_COPY_OUT,
+    /// Allocation and release of the scratch memory.
+    STATS_PHASE_ALLOCATION,
+    /// The number of phases.
+    STATS_PHASE_NUMBER
+} StatsPhase;
+
+/// The new type representing the statistics of the algorithms executed by a thread.
+typedef struct {
+    /// The wall time of each phase, in seconds, excluding the phases nested inside it.
+    double phaseTime[STATS_PHASE_NUMBER];
+    /// The number of times each phase is entered, the nested entries of the same phase included.
+    uint64_t phaseCount[STATS_PHASE_NUMBER];
+    /// The number of comparators executed by the networks.
+    uint64_t comparatorNumber;
+    /// The number of allocations of scratch memory.
+    uint64_t allocationNumber;
+    /// The bytes of scratch memory allocated.
+    uint64_t allocatedBytes;
+    /// The bytes of scratch memory allocated and not yet released.
+    uint64_t liveBytes;
+    /// The peak of liveBytes.
+    uint64_t peakLiveBytes;
+    /// The peak of the bytes in use in an arena.
+    uint64_t peakArenaBytes;
+} Stats;
+
+/// The new type representing the statistics of a thread, with the phases in progress.
+typedef struct {
+    /// The statistics of the thread.
+    Stats stats;
+    /// The phases in progress, the innermost last.
+    StatsPhase phaseStack[STATS_PHASE_DEPTH];
+    /// The number of phases in progress.
+    size_t phaseDepth;
+    /// The wall time from which the innermost phase in progress is accounted.
+    double phaseStart;
+} StatsThread;
+
+
+#ifdef DJB_STATS
+
+/// The statistics of the calling thread.
+extern _Thread_local StatsThread statsThread;
+
+/// Hook that enters a phase.
+#define STATS_PHASE_BEGIN(phase) stats_phase_begin(phase)
+/// Hook that leaves a phase.
+#define STATS_PHASE_END(phase) stats_phase_end(phase)
+/// Hook that accounts count comparators.
+#define STATS_COMPARATORS(count) ((void) (statsThread.stats.comparatorNumber += (uint64_t) (count)))
+/// Hook that accounts an allocation of size bytes of scratch memory.
+#define STATS_ALLOCATE(size) stats_allocate(size)
+/// Hook that accounts the release of size bytes of scratch memory.
+#define STATS_DEALLOCATE(size) stats_deallocate(size)
+/// Hook that accounts the bytes in use in an arena.
+#define STATS_ARENA_USED(used) stats_arena_used(used)
+
+#else
+
+// the hooks are compiled out, sizeof keeps their arguments used without evaluating them
+#define STATS_PHASE_BEGIN(phase) ((void) sizeof (phase))
+#define STATS_PHASE_END(phase) ((void) sizeof (phase))
+#define STATS_COMPARATORS(count) ((void) sizeof (count))
+#define STATS_ALLOCATE(size) ((void) sizeof (size))
+#define STATS_DEALLOCATE(size) ((void) sizeof (size))
+#define STATS_ARENA_USED(used) ((void) sizeof (used))
+
+#endif
+
+
+short stats_enabled(void);
+void stats_get(Stats *stats);
+void stats_reset(void);
+void stats_collect(Stats *stats);
+void stats_reset_all(void);
+void stats_add(Stats *total, const Stats *stats);
+const char *stats_phase_name(StatsPhase phase);
+void stats_print(FILE *output, const Stats *stats);
+
+void stats_phase_begin(StatsPhase phase);
+void stats_phase_end(StatsPhase phase);
+void stats_allocate(size_t size);
+void stats_deallocate(size_t size);
+void stats_arena_used(size_t used);
+
+
+#endif //DJB_STATS_H
@@ -2,29 +2,88 @@
 
 
 /**
-* Function that compares two quadruple.
+ * Function that packs the sort values of a quadruple in a single key.
  *
- * @note The comparison compares the following quadruple's value:
+ * @warning indexInItsList must be non-negative and less than 2^31.
+ *
+ * @details The sign bit of index0 is flipped, so that the unsigned order of the biased values is the signed order of index0.
+ * @details The comparison of two keys is a single unsigned comparison, and compares the following quadruple's value:
  * 1. index0;
  * 2. fromLeft;
  * 3. indexInItsList.
  *
- * @param firstQuadruple the first quadruple to compare.
- * @param secondQuadruple the second quadruple to compare.
- * @return firstQuadruple negative value if the first quadruple is less than the first. 0 if the two quadruples are equal. A positive value if the first quadruple is greater.
+ * @param index0 the first value of the quadruple.
+ * @param fromLeft the origin of the quadruple, either the left list, 1, or the right list, 0.
+ * @param indexInItsList the index in the list of source pairs.
+ * @return the packed key.
+ */
+SortKey packSortKey(int index0, int fromLeft, int indexInItsList) {
+    return ((SortKey) ((uint32_t) index0 ^ 0x80000000u) << 32) | ((SortKey) (fromLeft & 1) << 31) | (SortKey) ((uint32_t) indexInItsList & 0x7FFFFFFFu);
+}
+
+/**
+ * Function that extracts the first value of a quadruple from its key.
+ *
+ * @param key the packed key.
+ * @return the first value of the quadruple.
+ */
+int sortKeyIndex0(SortKey key) {
+    return (int) ((uint32_t) (key >> 32) ^ 0x80000000u);
+}
+
+/**
+ * Function that extracts the origin of a quadruple from its key.
+ *
+ * @param key the packed key.
+ * @return the origin of the quadruple, either the left list, 1, or the right list, 0.
+ */
+int sortKeyFromLeft(SortKey key) {
+    return (int) ((key >> 31) & 1);
+}
+
+/**
+ * Function that extracts the index in the list of source pairs of a quadruple from its key.
+ *
+ * @param key the packed key.
+ * @return the index in the list of source pairs.
+ */
+int sortKeyIndexInItsList(SortKey key) {
+    return (int) (key & 0x7FFFFFFFu);
+}
+
+/**
+ * Function that packs the sort values of a position in a single key.
+ *
+ * @warning index0 must be greater than or equal to -2^30 and less than 2^30.
+ *
+ * @details The comparison of two keys is a single signed comparison, and compares the following position's value:
+ * 1. index0;
+ * 2. fromLeft.
+ *
+ * @param index0 the position.
+ * @param fromLeft the origin of the position, either the left list, 1, or the right list, 0.
+ * @return the packed key.
+ */
+PositionKey packPositionKey(int index0, int fromLeft) {
+    return (PositionKey) (((uint32_t) index0 << 1) | (uint32_t) (fromLeft & 1));
+}
+
+/**
+ * Function that extracts the position from its key.
+ *
+ * @param key the packed key.
+ * @return the position.
+ */
+int positionKeyIndex0(PositionKey key) {
+    return key >> 1;
+}
+
+/**
+ * Function that extracts the origin of a position from its key.
+ *
+ * @param key the packed key.
+ * @return the origin of the position, either the left list, 1, or the right list, 0.
  */
-int quadrupleComparison(void *firstQuadruple, const void *secondQuadruple) {
-    /// First quadruple value.
-    const Quadruple *first = firstQuadruple;
-    /// Second quadruple value.
-    const Quadruple *second = secondQuadruple;
-
-    // constant-time
-    return
-        // if first->index0 != second->index0 --> return (first->index0 > second->index0) - (first->index0 < second->index0)
-        (1 - (first->index0 == second->index0)) * ((first->index0 > second->index0) - (first->index0 < second->index0)) +
-        // else if first->fromLeft != second->fromLeft --> return (first->fromLeft > second->fromLeft) - (first->fromLeft < second->fromLeft);
-        ((first->index0 == second->index0) * (1 - (first->fromLeft == second->fromLeft))) * ((first->fromLeft > second->fromLeft) - (first->fromLeft < second->fromLeft)) +
-        // else --> (first->indexInItsList > second->indexInItsList) - (first->indexInItsList < second->indexInItsList);
-        ((first->index0 == second->index0) * (first->fromLeft == second->fromLeft)) * ((first->indexInItsList > second->indexInItsList) - (first->indexInItsList < second->indexInItsList));
-}
\ No newline at end of file
+int positionKeyFromLeft(PositionKey key) {
+    return key & 1;
+}
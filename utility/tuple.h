@@ -2,6 +2,9 @@
 #define DJB_TUPLE_H
 
 
+#include <stdint.h>
+
+
 /// The new type representing a pair <index0, index1>.
 typedef struct {
     /// The first value of the pair.
@@ -10,20 +13,25 @@ typedef struct {
     int index0;
 } Pair;
 
-/// The new type representing a quadruple < index0, fromLeft, indexInItsList, index1>.
-typedef struct {
-    /// The first value of the quadruple.
-    int index0;
-    /// The values of the quadruple are either the left pair, 1, or the right pair, 0.
-    int fromLeft;
-    /// The index in the list of source pairs.
-    int indexInItsList;
-    /// The second value of the quadruple.
-    int index1;
-} Quadruple;
+/// The new type representing the sort key <index0, fromLeft, indexInItsList> of a quadruple < index0, fromLeft, indexInItsList, index1> packed in a single unsigned integer.
+/// @details index0 is stored in the 32 high bits, fromLeft in the bit 31, indexInItsList in the 31 low bits.
+/// @details The unsigned order of two keys is the lexicographic order of their triples.
+typedef uint64_t SortKey;
+
+/// The new type representing the sort key <index0, fromLeft> of a position packed in a single signed integer.
+/// @details index0 is stored in the 31 high bits, fromLeft in the bit 0.
+/// @details The signed order of two keys is the lexicographic order of their couples, the merges of positions do not need indexInItsList to break the ties.
+typedef int32_t PositionKey;
+
 
+SortKey packSortKey(int index0, int fromLeft, int indexInItsList);
+int sortKeyIndex0(SortKey key);
+int sortKeyFromLeft(SortKey key);
+int sortKeyIndexInItsList(SortKey key);
 
-int quadrupleComparison(void *firstQuadruple, const void *secondQuadruple);
+PositionKey packPositionKey(int index0, int fromLeft);
+int positionKeyIndex0(PositionKey key);
+int positionKeyFromLeft(PositionKey key);
 
 
 #endif //DJB_TUPLE_H